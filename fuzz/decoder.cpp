@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <span>
+#include <sstream>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/assembler.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/recompiler.hpp"
+
+// Feeds arbitrary ROM bytes to everything that decodes them ahead of
+// execution: static analysis, both output formats, the recompiler, and the
+// disassembler and assembler, which must agree with each other.
+
+namespace {
+
+constexpr std::size_t kMaxRomSize =
+    emu::memory::kSize - emu::memory::kProgramSpaceOffset;
+
+void checkRoundTrip(const std::uint16_t bytecode) {
+    const auto kText = emu::analysis::disassemble(bytecode);
+    const auto kBytes = emu::assembler::assemble(kText).bytes;
+    const auto kReassembled = static_cast<std::uint16_t>(
+        (static_cast<unsigned int>(kBytes.at(0)) << 8U) | kBytes.at(1));
+
+    if (emu::analysis::disassemble(kReassembled) != kText) {
+        std::cerr << "Round trip of '" << kText << "' gave '"
+                  << emu::analysis::disassemble(kReassembled) << "'\n";
+        std::abort();
+    }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      const std::size_t size) {
+    const std::span kRom(data, std::min(size, kMaxRomSize));
+
+    const auto kAnalysis = emu::analysis::analyse(kRom);
+
+    std::ostringstream output;
+    emu::analysis::writeListing(output, kAnalysis);
+    emu::analysis::writeDot(output, kAnalysis);
+    emu::recompiler::emit(output, kRom, "fuzz");
+
+    for (std::size_t i = 0; i + 1 < kRom.size(); i += 2) {
+        checkRoundTrip(static_cast<std::uint16_t>(
+            (static_cast<unsigned int>(kRom[i]) << 8U) | kRom[i + 1]));
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <span>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/block_cache.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/predecoder.hpp"
+
+// Input layout: engine byte, kPhases 16-bit key masks, then the ROM. Each
+// phase runs kInstructionsPerPhase instructions with its keys held down.
+
+namespace {
+
+constexpr std::size_t kPhases = 8;
+constexpr std::size_t kInstructionsPerPhase = 512;
+constexpr std::size_t kHeaderSize = 1 + (2 * kPhases);
+constexpr std::size_t kMaxRomSize =
+    emu::memory::kSize - emu::memory::kProgramSpaceOffset;
+
+enum class Engine : std::uint8_t {
+    kReference,
+    kPredecoder,
+    kBlockCache,
+};
+constexpr std::uint8_t kEngineCount = 3;
+
+// CHIP_8_FUZZ_MAX_NS_PER_INSTRUCTION, 0 when throughput is not bounded
+std::uint64_t g_max_ns_per_instruction = 0;
+
+class Machine {
+    emu::ChipState state_;
+    Engine engine_;
+    std::unique_ptr<emu::predecoder::Program> program_;
+    std::unique_ptr<emu::block_cache::BlockCache> blocks_;
+
+    std::size_t stepReference() {
+        const auto kOp = emu::predecoder::decodeSingle(
+            emu::predecoder::bytecodeAt(state_.memory,
+                                        state_.program_counter));
+        return emu::predecoder::execute(state_, kOp);
+    }
+
+   public:
+    Machine(const Engine engine, const std::span<const std::uint8_t> rom)
+        : engine_(engine) {
+        std::ranges::copy(rom, std::next(state_.memory.begin(),
+                                         emu::memory::kProgramSpaceOffset));
+
+        const auto kAnalysis = emu::analysis::analyse(rom);
+        if (engine_ == Engine::kPredecoder) {
+            program_ = std::make_unique<emu::predecoder::Program>();
+            program_->predecode(state_.memory, kAnalysis);
+        } else if (engine_ == Engine::kBlockCache) {
+            blocks_ = std::make_unique<emu::block_cache::BlockCache>();
+            blocks_->pretranslate(state_.memory, kAnalysis);
+        }
+    }
+
+    void press(const std::uint16_t mask) { state_.keys = mask; }
+
+    std::size_t step() {
+        std::size_t retired = 0;
+        switch (engine_) {
+            case Engine::kReference:
+                retired = stepReference();
+                break;
+            case Engine::kPredecoder:
+                retired = program_->step(state_);
+                break;
+            case Engine::kBlockCache:
+                retired = blocks_->step(state_);
+                break;
+        }
+
+        emu::timers::tick(state_, retired);
+        return retired;
+    }
+
+    [[nodiscard]] bool faulted() const noexcept {
+        return state_.fault.status != emu::fault::Status::kNone;
+    }
+};
+
+void run(const std::span<const std::uint8_t> data, std::size_t& executed) {
+    const auto kEngine = static_cast<Engine>(data[0] % kEngineCount);
+    const auto kRom = data.subspan(
+        kHeaderSize, std::min(data.size() - kHeaderSize, kMaxRomSize));
+
+    Machine machine(kEngine, kRom);
+    for (std::size_t phase = 0; phase < kPhases; phase++) {
+        machine.press(static_cast<unsigned int>(data[1 + (2 * phase)]) |
+                      (static_cast<unsigned int>(data[2 + (2 * phase)])
+                       << 8U));
+
+        // Blocks may overshoot, the budget is what matters
+        const auto kTarget = (phase + 1) * kInstructionsPerPhase;
+        while (executed < kTarget) {
+            executed += machine.step();
+            // Invalid opcodes and stack misuse stop the machine
+            if (machine.faulted()) {
+                return;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerInitialize(int* /* argc */, char*** /* argv */) {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* budget = std::getenv("CHIP_8_FUZZ_MAX_NS_PER_INSTRUCTION");
+    if (budget != nullptr) {
+        g_max_ns_per_instruction = std::strtoull(budget, nullptr, 10);
+    }
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data,
+                                      const std::size_t size) {
+    if (size < kHeaderSize) {
+        return -1;
+    }
+
+    const auto kStart = std::chrono::steady_clock::now();
+    std::size_t executed = 0;
+    // Faults are reported in the state, any exception escaping is a bug
+    run({data, size}, executed);
+
+    if (g_max_ns_per_instruction != 0 && executed != 0) {
+        const auto kElapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - kStart);
+        const auto kPerInstruction =
+            static_cast<std::uint64_t>(kElapsed.count()) / executed;
+        if (kPerInstruction > g_max_ns_per_instruction) {
+            std::cerr << "Slow path: " << kPerInstruction
+                      << " ns per instruction\n";
+            std::abort();
+        }
+    }
+    return 0;
+}
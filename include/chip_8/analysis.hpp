@@ -0,0 +1,112 @@
+#ifndef CHIP_8_ANALYSIS_HPP
+#define CHIP_8_ANALYSIS_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chip_8/memory.hpp"
+
+namespace emu::analysis {
+
+/**
+ * @brief What a ROM byte was found to hold
+ */
+enum class Byte : std::uint8_t {
+    kUnknown,
+    // Part of a reachable instruction
+    kCode,
+    // Read by Dxyn after a constant Annn
+    kSprite,
+    // Read or written by Fx33, Fx55 or Fx65 after a constant Annn
+    kData,
+};
+
+/**
+ * @brief Straight-line run of instructions. Starts at the ROM entry, a
+ * jump, call or skip target, or a return site, and ends at the next
+ * control-flow instruction or block entry.
+ */
+struct Block {
+    std::uint16_t entry;
+    // One past the last byte of the block
+    std::uint16_t end;
+    // Blocks execution continues in, including the return site of a call
+    std::vector<std::uint16_t> successors;
+    // Subroutine entered by a trailing 2nnn
+    std::optional<std::uint16_t> call;
+    // Ends with Bnnn, whose targets are only known at runtime
+    bool dynamic;
+    // Target of a 2nnn
+    bool subroutine;
+    // Target of a back edge, i.e. the head of a loop
+    bool loop_header;
+};
+
+/**
+ * @brief Static view of a ROM loaded at kProgramSpaceOffset
+ */
+struct Analysis {
+    memory::Type memory{};
+    std::uint16_t begin{memory::kProgramSpaceOffset};
+    std::uint16_t end{memory::kProgramSpaceOffset};
+    std::array<Byte, memory::kSize> bytes{};
+    // Sorted by entry address
+    std::vector<Block> blocks;
+    // Edges from a block to one of its ancestors on a path from the entry
+    std::vector<std::pair<std::uint16_t, std::uint16_t>> back_edges;
+
+    /**
+     * @brief Get the block starting at entry
+     *
+     * @param entry
+     * @return block, nullptr if no block starts there
+     */
+    [[nodiscard]] const Block* find(std::uint16_t entry) const;
+};
+
+/**
+ * @brief Walk a ROM from its first instruction, following jumps, calls,
+ * returns and skips. Bnnn targets and code outside the ROM are not
+ * followed.
+ *
+ * @param rom
+ * @return Analysis
+ * @throw RomSizeError if the ROM does not fit in memory
+ */
+Analysis analyse(std::span<const std::uint8_t> rom);
+
+/**
+ * @brief Render an instruction in assembly syntax (e.g. "DRW V0, V1, 5")
+ *
+ * @param bytecode
+ * @return std::string
+ */
+std::string disassemble(std::uint16_t bytecode);
+
+/**
+ * @brief Write the control-flow graph in Graphviz DOT format, one node per
+ * block. Calls are dashed, back edges bold.
+ *
+ * @param output
+ * @param analysis
+ */
+void writeDot(std::ostream& output, const Analysis& analysis);
+
+/**
+ * @brief Write an annotated listing: labelled blocks, subroutines and
+ * loops, with unreachable bytes shown as data
+ *
+ * @param output
+ * @param analysis
+ */
+void writeListing(std::ostream& output, const Analysis& analysis);
+
+}  // namespace emu::analysis
+
+#endif /* CHIP_8_ANALYSIS_HPP */
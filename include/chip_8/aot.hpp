@@ -0,0 +1,192 @@
+#ifndef CHIP_8_AOT_HPP
+#define CHIP_8_AOT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+
+#include "chip_8/block_cache.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::aot {
+
+class Runner;
+
+/**
+ * @brief Recompiled basic block. Runs the block's instructions, leaves the
+ * program counter at the next one to execute.
+ *
+ * @return number of instructions retired
+ */
+using Block = std::size_t (*)(ChipState& state, Runner& runner);
+
+// Bytes covered by one bit of the modified-code bitmap
+constexpr std::size_t kPageSize = 64;
+
+/**
+ * @brief Recompiled block and the bytes it was compiled from
+ */
+struct Entry {
+    std::uint16_t entry;
+    // One past the last byte the block was compiled from
+    std::uint16_t end;
+    Block block;
+};
+
+/**
+ * @brief ROM recompiled by chip-8-aot
+ */
+struct Program {
+    // ROM bytes the blocks were compiled from, loaded at kProgramSpaceOffset
+    std::span<const std::uint8_t> image;
+    std::span<const Entry> entries;
+};
+
+/**
+ * @brief Dispatches the program counter to recompiled blocks. Addresses
+ * without a block, such as Bnnn targets, and blocks whose bytes have been
+ * overwritten are left to the interpreter.
+ */
+class Runner {
+    std::array<const Entry*, memory::kSize> blocks_{};
+    // Bit n is set while page n holds recompiled code
+    std::uint64_t code_pages_{};
+    // Bit n is set once page n has been written to, blocks in such pages
+    // are compared with the image before running
+    std::uint64_t modified_pages_{};
+    // ROM bytes the blocks were compiled from
+    std::span<const std::uint8_t> image_;
+    bool attached_{};
+    // Interpreter blocks that must see the stores of recompiled blocks
+    block_cache::BlockCache* fallback_{};
+
+    static_assert(memory::kSize / kPageSize == 64,
+                  "The modified-code bitmap is a single 64-bit word");
+
+    static constexpr std::uint64_t pages(const std::uint32_t begin,
+                                         const std::uint32_t end) noexcept {
+        const auto kFirst = begin / kPageSize;
+        const auto kLast = (end - 1U) / kPageSize;
+        const auto kHigh = kLast == 63 ? ~std::uint64_t{0}
+                                       : (std::uint64_t{1} << (kLast + 1U)) - 1U;
+        return kHigh & ~((std::uint64_t{1} << kFirst) - 1U);
+    }
+
+    /**
+     * @brief Whether memory still holds the bytes a block was compiled
+     * from. Stores into data sharing a page with code leave it intact.
+     *
+     * @param entry
+     * @param memory
+     * @return bool
+     */
+    [[nodiscard]] bool intact(const Entry& entry,
+                              const memory::Type& memory) const noexcept {
+        const auto kOffset = static_cast<std::ptrdiff_t>(
+            entry.entry - memory::kProgramSpaceOffset);
+        return std::equal(std::next(memory.begin(), entry.entry),
+                          std::next(memory.begin(), entry.end),
+                          std::next(image_.begin(), kOffset));
+    }
+
+   public:
+    /**
+     * @brief Use a recompiled program, provided memory holds its ROM
+     *
+     * @param program
+     * @param memory
+     * @return false if memory does not hold the ROM the program was compiled
+     * from, the runner is then left detached
+     */
+    bool attach(const Program& program, const memory::Type& memory) {
+        detach();
+
+        const auto kImage = std::next(memory.begin(),
+                                      memory::kProgramSpaceOffset);
+        if (program.image.size() >
+                memory::kSize - memory::kProgramSpaceOffset ||
+            !std::equal(program.image.begin(), program.image.end(), kImage)) {
+            return false;
+        }
+
+        for (const auto& entry : program.entries) {
+            blocks_[entry.entry & kAddressMask] = &entry;
+            code_pages_ |= pages(entry.entry, entry.end);
+        }
+        image_ = program.image;
+        attached_ = true;
+        return true;
+    }
+
+    void detach() noexcept {
+        blocks_.fill(nullptr);
+        code_pages_ = 0;
+        modified_pages_ = 0;
+        image_ = {};
+        attached_ = false;
+    }
+
+    [[nodiscard]] bool attached() const noexcept { return attached_; }
+
+    /**
+     * @brief Set the block cache running the code recompiled blocks leave
+     * to the interpreter, so their stores drop its stale blocks too
+     *
+     * @param cache
+     */
+    void setFallback(block_cache::BlockCache* cache) noexcept {
+        fallback_ = cache;
+    }
+
+    /**
+     * @brief Record a store to memory, blocks compiled from bytes that no
+     * longer match the ROM are left to the interpreter
+     *
+     * @param address
+     * @param size
+     * @return true if the store touched a page holding recompiled code
+     */
+    bool stored(const std::uint16_t address, const std::uint16_t size) {
+        // Stores running past the end of memory wrap around to its start
+        constexpr auto kMemorySize = static_cast<std::uint32_t>(memory::kSize);
+        const std::uint32_t kBegin = address & kAddressMask;
+        const std::uint32_t kEnd = kBegin + size;
+
+        auto written = pages(kBegin, std::min(kEnd, kMemorySize));
+        if (kEnd > kMemorySize) {
+            written |= pages(0, kEnd - kMemorySize);
+        }
+
+        modified_pages_ |= written;
+        if (fallback_ != nullptr) {
+            fallback_->invalidate(address, size);
+        }
+        return (written & code_pages_) != 0;
+    }
+
+    /**
+     * @brief Run the recompiled block at the program counter
+     *
+     * @param state
+     * @return number of instructions retired, 0 if the interpreter has to
+     * run the next instruction
+     */
+    std::size_t step(ChipState& state) {
+        const auto* entry = blocks_[state.program_counter & kAddressMask];
+        if (entry == nullptr ||
+            ((modified_pages_ & pages(entry->entry, entry->end)) != 0 &&
+             !intact(*entry, state.memory))) {
+            return 0;
+        }
+        return entry->block(state, *this);
+    }
+};
+
+}  // namespace emu::aot
+
+#endif /* CHIP_8_AOT_HPP */
@@ -0,0 +1,72 @@
+#ifndef CHIP_8_ASSEMBLER_HPP
+#define CHIP_8_ASSEMBLER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace emu::assembler {
+
+/**
+ * @brief Assembled program
+ */
+struct Program {
+    std::vector<std::uint8_t> bytes;
+    // Address of every label
+    std::map<std::string, std::uint16_t, std::less<>> labels;
+};
+
+/**
+ * @brief Assemble a program to be loaded at kProgramSpaceOffset.
+ *
+ * One statement per line, `;` starts a comment. Statements are an optional
+ * `label:` followed by an instruction in the syntax of
+ * analysis::disassemble (e.g. `DRW V0, V1, 5`, `LD [I], V3`), `db` with
+ * comma-separated bytes or `dw` with comma-separated words. Numbers are
+ * decimal, `0x` hexadecimal or `0b` binary; addresses may be labels.
+ * Mnemonics and registers are case-insensitive.
+ *
+ * @param source
+ * @return Program
+ * @throw AssemblyError on the first invalid statement
+ */
+Program assemble(std::string_view source);
+
+/**
+ * @brief Representative benchmark programs. Each one repeats its kernel a
+ * number of rounds, draws the low digit of V1-V7 as its result, then spins
+ * on `halt: JP halt`.
+ */
+enum class Workload : std::uint8_t {
+    // Sprite draws across the whole screen, cleared every round
+    kDraw,
+    // Arithmetic and logic on registers, no memory access
+    kAlu,
+    // Nested subroutine calls and returns
+    kCall,
+    // Busy-waits on the delay timer, the usual way ROMs pace themselves
+    kTimerWait,
+};
+
+/**
+ * @brief Generate the source of a benchmark program. The output only
+ * depends on the arguments.
+ *
+ * @param workload
+ * @param rounds kernel repetitions, at least 1
+ * @return assembly source
+ */
+std::string generate(Workload workload, std::uint8_t rounds);
+
+/**
+ * @brief Label the generated programs spin on once done
+ *
+ */
+constexpr std::string_view kHaltLabel = "halt";
+
+}  // namespace emu::assembler
+
+#endif /* CHIP_8_ASSEMBLER_HPP */
@@ -0,0 +1,195 @@
+#ifndef CHIP_8_BLOCK_CACHE_HPP
+#define CHIP_8_BLOCK_CACHE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/predecoder.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::block_cache {
+
+// Bytes covered by one bit of the code bitmap
+constexpr std::size_t kPageSize = 64;
+constexpr std::size_t kPageCount = memory::kSize / kPageSize;
+// Longest straight-line sequence translated into a single block
+constexpr std::size_t kMaxBlockOps = 32;
+
+static_assert(kPageCount == 64, "The code bitmap is a single 64-bit word");
+
+/**
+ * @brief Straight-line sequence of decoded ops. Ends after the first op
+ * that may change the control flow. Ops that read or set the timers or the
+ * random generator make a block of their own, so they see them ticked for
+ * every instruction before.
+ */
+struct Block {
+    // Address of the first instruction
+    std::uint16_t entry;
+    // One past the last byte the block was decoded from, memory::kSize + 1
+    // when its last instruction wraps around to the first byte of memory
+    std::uint16_t end;
+    std::vector<predecoder::Op> ops;
+};
+
+/**
+ * @brief Translate the block starting at entry
+ *
+ * @param memory
+ * @param entry
+ * @return Block
+ */
+Block translate(const memory::Type& memory, std::uint16_t entry);
+
+/**
+ * @brief Cache of translated blocks keyed by entry address. A bitmap of
+ * the pages holding translated code lets memory writes that do not touch
+ * code skip invalidation entirely; writes that do touch code only drop the
+ * blocks decoded from the written bytes.
+ */
+class BlockCache {
+    std::array<std::unique_ptr<Block>, memory::kSize> blocks_;
+    // Bit n is set while page n holds at least one translated byte
+    std::uint64_t code_pages_{};
+    // Entries of the blocks overlapping each page
+    std::array<std::vector<std::uint16_t>, kPageCount> page_entries_;
+
+    // Block being executed, kept alive if it invalidates itself
+    const Block* running_{};
+    std::unique_ptr<Block> retired_;
+
+    Block& insert(Block block);
+    void drop(std::uint16_t entry);
+
+    static constexpr std::uint64_t pageBit(const std::size_t page) noexcept {
+        return std::uint64_t{1} << page;
+    }
+
+   public:
+    /**
+     * @brief Get the block starting at entry, translating it if needed
+     *
+     * @param memory
+     * @param entry
+     * @return const Block&
+     */
+    const Block& lookup(const memory::Type& memory,
+                        const std::uint16_t entry) {
+        const auto& block = blocks_[entry & kAddressMask];
+        if (block) {
+            return *block;
+        }
+        return insert(translate(memory, entry & kAddressMask));
+    }
+
+    /**
+     * @brief Translate every block found by static analysis upfront, so
+     * they are not discovered one at a time while running
+     *
+     * @param memory
+     * @param analysis
+     */
+    void pretranslate(const memory::Type& memory,
+                      const analysis::Analysis& analysis);
+
+    /**
+     * @brief Get a translated block without translating it
+     *
+     * @param entry
+     * @return block, nullptr if not translated
+     */
+    [[nodiscard]] const Block* find(const std::uint16_t entry) const noexcept {
+        return blocks_[entry & kAddressMask].get();
+    }
+
+    /**
+     * @brief Pages holding translated code, one bit per kPageSize bytes
+     *
+     * @return std::uint64_t
+     */
+    [[nodiscard]] std::uint64_t codePages() const noexcept {
+        return code_pages_;
+    }
+
+    /**
+     * @brief Drop every block
+     *
+     */
+    void invalidate();
+
+    /**
+     * @brief Drop the blocks decoded from bytes in [address, address + size)
+     *
+     * @param address
+     * @param size
+     */
+    void invalidate(const std::uint16_t address, const std::uint16_t size) {
+        // Writes span at most 16 bytes, so at most two pages
+        const auto kFirst = (address & kAddressMask) / kPageSize;
+        const auto kLast =
+            ((address + size - 1U) & kAddressMask) / kPageSize;
+        if ((code_pages_ & (pageBit(kFirst) | pageBit(kLast))) == 0) {
+            return;
+        }
+        invalidateCode(address, size);
+    }
+
+    /**
+     * @brief Slow path of invalidate(), for writes hitting code pages
+     *
+     * @param address
+     * @param size
+     */
+    void invalidateCode(std::uint16_t address, std::uint16_t size);
+
+    /**
+     * @brief Execute the block at the program counter. Stops early if the
+     * block overwrites its own code. The caller ticks timers once per
+     * retired instruction after the block.
+     *
+     * @param state
+     * @param stored called with the range of every memory store
+     * @return number of instructions retired
+     */
+    template <typename Observer>
+    std::size_t step(ChipState& state, Observer&& stored) {
+        const auto& block = lookup(state.memory, state.program_counter);
+        running_ = &block;
+
+        std::size_t retired = 0;
+        for (const auto& op : block.ops) {
+            if (!op.writes_memory) {
+                retired += predecoder::execute(state, op);
+                continue;
+            }
+
+            const auto [kAddress, kSize] = predecoder::writtenRange(op, state);
+            retired += predecoder::execute(state, op);
+            invalidate(kAddress, kSize);
+            stored(kAddress, kSize);
+            if (retired_) {
+                // The block changed its own code, resume from fresh blocks
+                break;
+            }
+        }
+
+        running_ = nullptr;
+        retired_.reset();
+        return retired;
+    }
+
+    std::size_t step(ChipState& state) {
+        return step(state, [](std::uint16_t /* not used */,
+                              std::uint16_t /* not used */) {});
+    }
+};
+
+}  // namespace emu::block_cache
+
+#endif /* CHIP_8_BLOCK_CACHE_HPP */
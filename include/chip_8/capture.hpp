@@ -0,0 +1,191 @@
+#ifndef CHIP_8_CAPTURE_HPP
+#define CHIP_8_CAPTURE_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "chip_8/display.hpp"
+#include "chip_8/spsc_queue.hpp"
+
+namespace emu::capture {  // Lossless recordings of the display
+
+/**
+ * @brief One presented frame
+ */
+struct Frame {
+    // Microseconds since the capture started
+    std::uint64_t timestamp;
+    std::array<std::uint64_t, display::kHeight> rows;
+    // Frames lost right before this one, 0 while the capture is lossless
+    std::uint64_t dropped;
+};
+
+/**
+ * @brief Serialize frames to a capture stream. Each frame stores its time
+ * since the previous one and only the bytes that differ from the previous
+ * frame: a mask of changed rows, then for each changed row a mask of changed
+ * bytes and their XOR. An unchanged frame costs four bytes, a moving sprite
+ * adds a few per row it touches. Frames the recorder dropped are marked by
+ * a gap record holding their count, so a capture never loses frames
+ * silently.
+ */
+class Writer {
+    std::ostream& output_;
+    Frame previous_{};
+    std::vector<std::uint8_t> buffer_;
+
+    void encode(const Frame& frame);
+    void encodeGap(std::uint64_t dropped);
+    void flush();
+
+   public:
+    explicit Writer(std::ostream& output);
+
+    /**
+     * @brief Write frames, each preceded by a gap record if frames were
+     * dropped before it
+     *
+     * @param frames
+     */
+    void write(std::span<const Frame> frames);
+
+    /**
+     * @brief Write a gap record for frames dropped after the last one
+     *
+     * @param dropped
+     */
+    void gap(std::uint64_t dropped);
+};
+
+/**
+ * @brief Deserialize frames from a capture stream written by Writer
+ */
+class Reader {
+    std::istream& input_;
+    Frame previous_{};
+    std::uint64_t dropped_{};
+
+   public:
+    /**
+     * @brief Read and validate the capture header
+     *
+     * @throw CaptureFormatError if the stream is not a capture
+     */
+    explicit Reader(std::istream& input);
+
+    /**
+     * @brief Read the next frame, its dropped field counts the frames lost
+     * right before it
+     *
+     * @param frame
+     * @return false at end of capture
+     * @throw CaptureFormatError if the capture is truncated
+     */
+    bool next(Frame& frame);
+
+    /**
+     * @brief Frames the recorder dropped among those read so far, and at
+     * the end of the capture once next() returned false
+     *
+     * @return std::uint64_t
+     */
+    [[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_; }
+};
+
+/**
+ * @brief Queues presented frames and encodes them to a file from a
+ * background thread. Pushing copies 272 bytes into a lock-free queue and
+ * never waits: if the writer falls a queue behind, frames are dropped,
+ * counted in dropped() and marked in the file.
+ */
+class Recorder {
+    // About 17 seconds of frames at 60 Hz
+    static constexpr std::size_t kQueueCapacity = 1U << 10U;
+
+    std::ofstream file_;
+    Writer writer_;
+    SpscQueue<Frame, kQueueCapacity> queue_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+
+    std::chrono::steady_clock::time_point start_;
+    std::uint64_t dropped_{};
+    // Dropped since the last frame queued, read by the writer once stopped
+    std::uint64_t unmarked_{};
+    // Set by the writer thread once the file could not be written
+    std::atomic<bool> failed_{false};
+
+    void drain();
+
+   public:
+    /**
+     * @brief Start a capture
+     *
+     * @param path destination file, truncated
+     * @throw std::ios_base::failure if the file cannot be opened
+     */
+    explicit Recorder(const std::filesystem::path& path);
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+    Recorder(Recorder&&) = delete;
+    Recorder& operator=(Recorder&&) = delete;
+
+    /**
+     * @brief Write the frames still queued and stop the writer thread. Does
+     * nothing once stopped.
+     *
+     */
+    void finish();
+
+    /**
+     * @brief Queue a frame, timestamped now
+     *
+     * @param display
+     */
+    void push(const display::Display& display) noexcept {
+        const auto kElapsed = std::chrono::steady_clock::now() - start_;
+        const Frame kFrame{
+            static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(kElapsed)
+                    .count()),
+            display.rows, unmarked_};
+        if (queue_.push(kFrame)) {
+            unmarked_ = 0;
+        } else {
+            dropped_ += 1;
+            unmarked_ += 1;
+        }
+    }
+
+    /**
+     * @brief Number of frames lost because the writer thread fell behind
+     *
+     * @return std::uint64_t
+     */
+    [[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_; }
+
+    /**
+     * @brief Whether writing the file failed, frames queued since are lost
+     *
+     * @return bool
+     */
+    [[nodiscard]] bool failed() const noexcept {
+        return failed_.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace emu::capture
+
+#endif /* CHIP_8_CAPTURE_HPP */
@@ -4,26 +4,60 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
-#include <thread>
-
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+
+#include "chip_8/aot.hpp"
+#include "chip_8/block_cache.hpp"
+#include "chip_8/capture.hpp"
 #include "chip_8/chip_state.hpp"
 #include "chip_8/display.hpp"
-#include "chip_8/error.hpp"
-#include "chip_8/instruction_set.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/frontend.hpp"
+#include "chip_8/instrumentation.hpp"
+#include "chip_8/lockstep.hpp"
+#include "chip_8/pacing.hpp"
+#include "chip_8/predecoder.hpp"
+#include "chip_8/profiler.hpp"
+#include "chip_8/random.hpp"
+#include "chip_8/rom.hpp"
+#include "chip_8/shared_memory.hpp"
+#include "chip_8/trace.hpp"
 #include "chip_8/utility.hpp"
 
-#include "SDL3/SDL_keyboard.h"
 #include "SDL3/SDL_log.h"
-#include "SDL3/SDL_render.h"
-#include "SDL3/SDL_video.h"
 
 namespace emu {
 
 class Chip8 {
     ChipState state_;
-    // Move this a frontend class
-    SDL_Window* window_{};
-    SDL_Renderer* renderer_{};
+    // Compiled out unless CHIP_8_ENABLE_INSTRUMENTATION is set
+    [[no_unique_address]] instrumentation::Recorder<instrumentation::kEnabled>
+        instrumentation_;
+    // Fast path, used whenever no hook observes instructions
+    block_cache::BlockCache blocks_;
+    // Recompiled ROM, tried before the block cache when attached
+    aot::Runner aot_;
+    // Picks the fast-path steps replayed on the reference interpreter
+    lockstep::Sampler self_check_;
+    // Set once a fast path disagreed with the reference interpreter
+    bool diverged_{};
+    // Speed control of paced frontends
+    pacing::Governor governor_;
+    // Audio gate last passed to the frontend
+    bool beeping_{};
+    // Only allocated while profiling
+    std::unique_ptr<profiler::Profiler> profiler_;
+    // Only allocated while tracing
+    std::unique_ptr<trace::Recorder> tracer_;
+    // Only allocated while capturing video
+    std::unique_ptr<capture::Recorder> capture_;
+    // Only allocated while exporting frames to other processes
+    std::unique_ptr<shared_memory::Publisher> publisher_;
 
     /**
      * @brief Fetch an instruction from memory and update program counter
@@ -31,251 +65,431 @@ class Chip8 {
      * @return instruction in bytecode format
      */
     std::uint16_t fetch() noexcept {
+        // The program counter may run past the end of memory, wrap around
         const auto kInstruction =
-            (static_cast<unsigned int>(state_.memory[state_.program_counter])
-             << kByteWidth) |
-            static_cast<unsigned int>(
-                state_.memory[state_.program_counter + 1]);
+            predecoder::bytecodeAt(state_.memory, state_.program_counter);
 
         state_.program_counter += 2;
 
-        return static_cast<std::uint16_t>(kInstruction);
+        return kInstruction;
     }
 
     /**
-     * @brief Map bytecode to its instruction under 0xxx group
+     * @brief Whether any hook needs to observe individual instructions. The
+     * hooks then run on the reference interpreter, so what they measure is
+     * its cost rather than the fast paths', see instrumentation::kEngine.
      *
-     * @param bytecode
-     * @return instruction_set::Instruction
      */
-    static instruction_set::Instruction handleGroup0(
-        const std::uint16_t bytecode) {
-        switch (bytecode & 0x0FFFU) {
-            case 0x00E0:
-                return instruction_set::op00E0;
-            case 0x00EE:
-                return instruction_set::op00EE;
-            default:
-                return instruction_set::op0nnn;
-        }
+    [[nodiscard]] bool observed() const noexcept {
+        return instrumentation::kEnabled || profiler_ != nullptr ||
+               tracer_ != nullptr;
     }
 
     /**
-     * @brief Map bytecode to its instruction under 8xxx group
+     * @brief Execute one instruction through fetch and decode, feeding the
+     * instrumentation, profiling and tracing hooks
      *
-     * @param bytecode
-     * @return instruction_set::Instruction
      */
-    static instruction_set::Instruction handleGroup8(
-        const std::uint16_t bytecode) {
-        switch (bytecode & 0x000FU) {
-            case 0x0000:
-                return instruction_set::op8xy0;
-            case 0x0001:
-                return instruction_set::op8xy1;
-            case 0x0002:
-                return instruction_set::op8xy2;
-            case 0x0003:
-                return instruction_set::op8xy3;
-            case 0x0004:
-                return instruction_set::op8xy4;
-            case 0x0005:
-                return instruction_set::op8xy5;
-            case 0x0006:
-                return instruction_set::op8xy6;
-            case 0x0007:
-                return instruction_set::op8xy7;
-            case 0x000E:
-                return instruction_set::op8xyE;
-            default:
-                throw InvalidInstructionError(bytecode);
+    void stepReference() {
+        const auto kAddress = state_.program_counter;
+        const auto kBytecode = fetch();
+
+        const auto kOp = predecoder::decodeSingle(kBytecode);
+
+        // Keep the translated blocks in sync with self-modifying code
+        const auto [kWritten, kSize] = predecoder::writtenRange(kOp, state_);
+
+        if (tracer_) {
+            tracer_->begin(state_);
+        }
+
+        const auto kToken = instrumentation_.beginInstruction(kBytecode);
+        kOp.handler(state_, kOp);
+        instrumentation_.endInstruction(kToken, state_);
+
+        if (profiler_) {
+            profiler_->record(kAddress, kBytecode);
+        }
+
+        if (tracer_) {
+            tracer_->end(kAddress, kBytecode, state_);
+        }
+
+        if (kOp.writes_memory) {
+            blocks_.invalidate(kWritten, kSize);
+            aot_.stored(kWritten, kSize);
         }
     }
 
     /**
-     * @brief Map bytecode to its instruction under Exxx group
+     * @brief Replay a fast-path step on the reference interpreter. On
+     * mismatch, log the divergence, continue from the reference state and
+     * stop using the fast paths.
      *
-     * @param bytecode
-     * @return instruction_set::Instruction
+     * @param before state before the step
+     * @param retired
      */
-    static instruction_set::Instruction handleGroupE(
-        const std::uint16_t bytecode) {
-        switch (bytecode & 0x00FFU) {
-            case 0x009E:
-                return instruction_set::opEx9E;
-            case 0x00A1:
-                return instruction_set::opExA1;
-            default:
-                throw InvalidInstructionError(bytecode);
+    void selfCheck(const ChipState& before, const std::size_t retired) {
+        const auto kDivergence = lockstep::verify(before, retired, state_);
+        if (!kDivergence) {
+            return;
         }
+
+        std::ostringstream report;
+        lockstep::writeReport(report, *kDivergence);
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                     "Self-check failed, switching to the reference "
+                     "interpreter\n%s",
+                     report.str().c_str());
+
+        state_ = kDivergence->expected;
+        diverged_ = true;
+    }
+
+    [[nodiscard]] bool running() const noexcept {
+        return state_.fault.status == fault::Status::kNone;
     }
 
     /**
-     * @brief Map bytecode to its instruction under Fxxx group
+     * @brief Execute one step on the fastest path available and tick the
+     * timers
      *
-     * @param bytecode
-     * @return instruction_set::Instruction
+     * @param output receives audio gate edges
+     * @return number of instructions retired
      */
-    static instruction_set::Instruction handleGroupF(
-        const std::uint16_t bytecode) {
-        switch (bytecode & 0x00FFU) {
-            case 0x0007:
-                return instruction_set::opFx07;
-            case 0x000A:
-                return instruction_set::opFx0A;
-            case 0x0015:
-                return instruction_set::opFx15;
-            case 0x0018:
-                return instruction_set::opFx18;
-            case 0x001E:
-                return instruction_set::opFx1E;
-            case 0x0029:
-                return instruction_set::opFx29;
-            case 0x0033:
-                return instruction_set::opFx33;
-            case 0x0055:
-                return instruction_set::opFx55;
-            case 0x0065:
-                return instruction_set::opFx65;
-            default:
-                throw InvalidInstructionError(bytecode);
+    template <frontend::Frontend Output>
+    std::size_t step(Output& output) {
+        // Hooks must see every instruction, blocks would hide them
+        std::size_t retired = 1;
+        // Copying the state is only worth it for sampled steps
+        std::optional<ChipState> before;
+        if (observed() || diverged_) {
+            stepReference();
+        } else {
+            if (self_check_.due()) {
+                before = state_;
+            }
+
+            retired = aot_.step(state_);
+            if (retired == 0) {
+                retired = blocks_.step(
+                    state_, [this](const std::uint16_t address,
+                                   const std::uint16_t size) {
+                        aot_.stored(address, size);
+                    });
+            }
+        }
+
+        timers::tick(state_, retired);
+        // Checked with the ticks, the reference ticks every instruction
+        if (before) {
+            selfCheck(*before, retired);
+        }
+
+        // Only edges reach the frontend
+        if ((state_.sound_timer != 0) != beeping_) {
+            beeping_ = !beeping_;
+            output.beep(beeping_);
         }
+
+        return retired;
     }
 
     /**
-     * @brief Map a bytecode to its corresponding instruction
+     * @brief Hand the display to the frontend and recorders if it changed
      *
-     * @param instruction
-     * @return instruction_set::Instruction
+     * @param output
+     * @return whether the display changed
      */
-    static instruction_set::Instruction decode(const std::uint16_t bytecode) {
-        switch (bytecode & 0xF000U) {
-            case 0x0000:
-                return handleGroup0(bytecode);
-            case 0x1000:
-                return instruction_set::op1nnn;
-            case 0x2000:
-                return instruction_set::op2nnn;
-            case 0x3000:
-                return instruction_set::op3xkk;
-            case 0x4000:
-                return instruction_set::op4xkk;
-            case 0x5000:
-                return instruction_set::op5xy0;
-            case 0x6000:
-                return instruction_set::op6xkk;
-            case 0x7000:
-                return instruction_set::op7xkk;
-            case 0x8000:
-                return handleGroup8(bytecode);
-            case 0x9000:
-                return instruction_set::op9xy0;
-            case 0xA000:
-                return instruction_set::opAnnn;
-            case 0xB000:
-                return instruction_set::opBnnn;
-            case 0xC000:
-                return instruction_set::opCxkk;
-            case 0xD000:
-                return instruction_set::opDxyn;
-            case 0xE000:
-                return handleGroupE(bytecode);
-            case 0xF000:
-                return handleGroupF(bytecode);
-            default:
-                throw InvalidInstructionError(bytecode);
+    template <frontend::Frontend Output>
+    bool presentIfDrawn(Output& output) {
+        if (!state_.display.draw) {
+            return false;
+        }
+
+        output.present(state_.display);
+        if constexpr (!frontend::kDeferred<Output>) {
+            instrumentation_.framePresented();
         }
+        if (capture_) {
+            capture_->push(state_.display);
+        }
+        state_.display.draw = false;
+        return true;
     }
 
-    void renderDisplay() {
-        // Clear screen to black
-        SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
-        SDL_RenderClear(renderer_);
-
-        // Set drawing color to white (CHIP-8 foreground)
-        SDL_SetRenderDrawColor(renderer_, 255, 255, 255, 255);
-
-        // Draw pixels
-        for (std::size_t y = 0; y < display::kHeight; y++) {
-            for (std::size_t x = 0; x < display::kWidth; x++) {
-                if (state_.display.buffer[x + (y * display::kWidth)] != 0U) {
-                    // REVIEW: How expensive are these casts?
-                    SDL_RenderPoint(renderer_, static_cast<float>(x),
-                                    static_cast<float>(y));
-                }
-            }
+    /**
+     * @brief Export the state to the shared-memory object, if any
+     *
+     */
+    void publish() noexcept {
+        if (publisher_) {
+            publisher_->publish(state_);
         }
+    }
 
-        // Update screen
-        SDL_RenderPresent(renderer_);
+   public:
+    /**
+     * @brief Access the hot-path instrumentation recorder
+     *
+     * @return recorder, an empty object when instrumentation is compiled out
+     */
+    auto& instrumentation() noexcept { return instrumentation_; }
 
-        // Reset draw flag
-        state_.display.draw = false;
+    /**
+     * @brief Start attributing executed instructions to addresses and call
+     * paths, discarding any previous profile
+     *
+     * @return profiler::Profiler&
+     */
+    profiler::Profiler& enableProfiler() {
+        profiler_ = std::make_unique<profiler::Profiler>();
+        return *profiler_;
     }
 
-   public:
+    void disableProfiler() noexcept { profiler_.reset(); }
+
     /**
-     * @brief Load test ROM into memory
+     * @brief Access the running profile
      *
-     * @return 0 at success, -1 at failure
+     * @return profiler, nullptr when profiling is disabled
      */
-    int load();
+    [[nodiscard]] const profiler::Profiler* profiler() const noexcept {
+        return profiler_.get();
+    }
 
-    bool init() {
-        if (!SDL_CreateWindowAndRenderer(
-                "Chip-8", display::kWidth * 10, display::kHeight * 10,
-                SDL_WINDOW_RESIZABLE, &window_, &renderer_)) {
-            return false;
+    /**
+     * @brief Stream a record of every executed instruction to a file,
+     * replacing any running trace
+     *
+     * @param path
+     * @param compressed delta-encode records
+     */
+    void startTrace(const std::filesystem::path& path, const bool compressed) {
+        stopTrace();
+        tracer_ = std::make_unique<trace::Recorder>(path, compressed);
+    }
+
+    /**
+     * @brief Flush and close the running trace, if any, and log whether it
+     * lost records or slowed the interpreter down
+     *
+     */
+    void stopTrace() {
+        if (!tracer_) {
+            return;
         }
-        if (!SDL_SetRenderScale(renderer_, 10.0F, 10.0F)) {
-            return false;
+
+        tracer_->finish();
+        if (tracer_->failed()) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                         "Trace failed: the file could not be written");
+        }
+        if (tracer_->stalls() != 0) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                        "Trace stalled the interpreter %llu times",
+                        static_cast<unsigned long long>(tracer_->stalls()));
+        }
+        if (tracer_->dropped() != 0) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                        "Trace dropped %llu records",
+                        static_cast<unsigned long long>(tracer_->dropped()));
+        }
+        tracer_.reset();
+    }
+
+    /**
+     * @brief Record every presented frame to a file from a background
+     * thread, replacing any running capture
+     *
+     * @param path
+     */
+    void startCapture(const std::filesystem::path& path) {
+        stopCapture();
+        capture_ = std::make_unique<capture::Recorder>(path);
+    }
+
+    /**
+     * @brief Flush and close the running capture, if any, and log whether
+     * it lost frames
+     *
+     */
+    void stopCapture() {
+        if (!capture_) {
+            return;
         }
 
-        return true;
+        capture_->finish();
+        if (capture_->failed()) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                         "Capture failed: the file could not be written");
+        }
+        if (capture_->dropped() != 0) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                        "Capture dropped %llu frames",
+                        static_cast<unsigned long long>(capture_->dropped()));
+        }
+        capture_.reset();
     }
 
-    void shutdown() {
-        SDL_DestroyRenderer(renderer_);
-        SDL_DestroyWindow(window_);
+    /**
+     * @brief Publish the registers and display after every frame, drawn or
+     * not, to a POSIX shared-memory object, see shared_memory::Subscriber
+     *
+     * @param name shm_open name, e.g. "/chip-8"
+     * @throw SharedMemoryError
+     */
+    void enableExport(const std::string& name) {
+        publisher_.reset();
+        publisher_ = std::make_unique<shared_memory::Publisher>(name);
+        publisher_->publish(state_);
     }
 
+    void disableExport() noexcept { publisher_.reset(); }
+
     /**
-     * @brief Represet a single interpreter cycle
+     * @brief Run a recompiled ROM instead of interpreting it. Call after
+     * load().
      *
+     * @param program
+     * @return false if the loaded ROM is not the one the program was compiled
+     * from
      */
-    void cycle() {
-        const auto kStart = std::chrono::system_clock::now();
+    bool attach(const aot::Program& program) {
+        aot_.setFallback(&blocks_);
+        return aot_.attach(program, state_.memory);
+    }
 
-        state_.keyboard = SDL_GetKeyboardState(NULL);
+    /**
+     * @brief Restart the random sequence of Cxkk
+     *
+     * @param value
+     * @param mode
+     */
+    void seed(const std::uint32_t value, const random::Mode mode) noexcept {
+        state_.rnd.seed(value, mode);
+    }
 
-        const auto kBytecode = fetch();
+    /**
+     * @brief Replay one fast-path step in interval on the reference
+     * interpreter, 0 to disable
+     *
+     * @param interval
+     */
+    void enableSelfCheck(const std::uint32_t interval) noexcept {
+        self_check_ = lockstep::Sampler(interval);
+    }
 
-        const auto kInstruction = decode(kBytecode);
+    /**
+     * @brief Load a ROM at kProgramSpaceOffset on a fresh machine
+     *
+     * @param rom
+     * @throw RomSizeError if the ROM does not fit in program space
+     */
+    void load(std::span<const std::uint8_t> rom);
 
-        kInstruction(state_, kBytecode);
+    /**
+     * @brief Load a ROM file, see rom::Mapping
+     *
+     * @param path
+     * @throw RomLoadError
+     * @throw RomSizeError
+     */
+    void load(const std::filesystem::path& path);
 
-        if (state_.delay_timer > 0) {
-            state_.delay_timer -= 1;
+    /**
+     * @brief Run with the random generator and speed a ROM asks for. Call
+     * after load().
+     *
+     * @param profile
+     */
+    void configure(const rom::Profile& profile) noexcept {
+        state_.rnd.seed(random::kDefaultSeed, profile.random);
+        if (profile.speed != 0) {
+            governor_.setRate(static_cast<double>(profile.speed));
         }
+    }
 
-        if (state_.sound_timer > 0) {
-            // Make a beep
-            state_.sound_timer -= 1;
-        }
+    /**
+     * @brief Access the speed control: multiplier, unlimited mode and the
+     * achieved rate
+     *
+     * @return pacing::Governor&
+     */
+    pacing::Governor& pacing() noexcept { return governor_; }
 
-        if (state_.display.draw) {
-            renderDisplay();
-        }
+    void shutdown() {
+        stopTrace();
+        stopCapture();
+        instrumentation_.flush();
+    }
 
-        const auto kFinish = std::chrono::system_clock::now();
+    /**
+     * @brief Instruction that stopped the machine, if any
+     *
+     * @return const fault::Fault&
+     */
+    [[nodiscard]] const fault::Fault& fault() const noexcept {
+        return state_.fault;
+    }
+
+    /**
+     * @brief Represet a single interpreter cycle, without pacing
+     *
+     * @param output frontend presenting frames and providing keys
+     * @return fault::Status::kNone unless an instruction faulted
+     */
+    template <frontend::Frontend Output>
+    fault::Status cycle(Output& output) {
+        state_.keys = output.poll();
+        step(output);
+        // Cycles are too short to export each one, only changes are
+        if (presentIfDrawn(output)) {
+            publish();
+        }
+        instrumentation_.maybeDump();
 
-        using namespace std::chrono_literals;
+        return state_.fault.status;
+    }
 
-        constexpr auto kTargetTime = 1.43ms;
-        const auto kTotalTime = kFinish - kStart;
-        if (kTotalTime < kTargetTime) {
-            std::this_thread::sleep_for(kTargetTime - kTotalTime);
+    /**
+     * @brief Run the instructions owed for the wall time since the previous
+     * frame and present the result once. Never sleeps: paced frontends sync
+     * to the display or wait between frames themselves. Unpaced frontends
+     * and unlimited mode run for pacing::kFrameInterval.
+     *
+     * @param output frontend presenting frames and providing keys
+     * @return fault::Status::kNone unless an instruction faulted
+     */
+    template <frontend::Frontend Output>
+    fault::Status frame(Output& output) {
+        state_.keys = output.poll();
+
+        const auto kStart = pacing::Clock::now();
+        std::size_t retired = 0;
+        if (Output::kPaced && !governor_.unlimited()) {
+            const auto kOwed = governor_.owed(kStart);
+            while (retired < kOwed && running()) {
+                retired += step(output);
+            }
+        } else {
+            const auto kEnd = kStart + pacing::kFrameInterval;
+            do {
+                for (std::size_t i = 0;
+                     i < pacing::kClockCheckInterval && running(); i++) {
+                    retired += step(output);
+                }
+            } while (running() && pacing::Clock::now() < kEnd);
         }
+        governor_.retire(retired, pacing::Clock::now());
+
+        // Frames drawn in between are never shown
+        presentIfDrawn(output);
+        // Registers and timers move even while the screen stands still
+        publish();
+        instrumentation_.maybeDump();
+
+        return state_.fault.status;
     }
 };
 
@@ -1,13 +1,17 @@
 #ifndef CHIP_8_CHIP_STATE_HPP
 #define CHIP_8_CHIP_STATE_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <random>
-#include <stack>
+#include <type_traits>
 
 #include "chip_8/display.hpp"
+#include "chip_8/fault.hpp"
 #include "chip_8/keyboard.hpp"
 #include "chip_8/memory.hpp"
+#include "chip_8/random.hpp"
 #include "chip_8/registers.hpp"
 
 namespace emu {
@@ -17,9 +21,85 @@ constexpr std::uint16_t kSpriteSize = 5;
 constexpr std::uint16_t kMemoryOffset = 0x000;
 }  // namespace font
 
-struct ChipState {
+namespace stack {  // Stack metadata
+// Deepest call nesting, as on the CHIP-48 and SUPER-CHIP
+constexpr std::size_t kDepth = 16;
+
+/**
+ * @brief Fixed-capacity return address stack, with the std::stack interface
+ * the instructions use
+ */
+class Stack {
+    std::array<std::uint16_t, kDepth> entries_{};
+    std::uint8_t size_{};
+
+   public:
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Most recent return address, the stack must not be empty
+     *
+     * @return std::uint16_t
+     */
+    [[nodiscard]] std::uint16_t top() const noexcept {
+        return entries_[size_ - 1U];
+    }
+
+    /**
+     * @brief Push a return address, the stack must not be full
+     *
+     * @param address
+     */
+    void push(const std::uint16_t address) noexcept {
+        entries_[size_] = address;
+        size_ += 1;
+    }
+
+    void pop() noexcept { size_ -= 1; }
+
+    // Slots above the top are stale and not compared
+    friend bool operator==(const Stack& lhs, const Stack& rhs) noexcept {
+        return lhs.size_ == rhs.size_ &&
+               std::equal(lhs.entries_.begin(),
+                          lhs.entries_.begin() + lhs.size_,
+                          rhs.entries_.begin());
+    }
+};
+
+using Type = Stack;
+}  // namespace stack
+
+/**
+ * @brief Whole machine state, trivially copyable so snapshots are a memcpy.
+ * Everything most instructions touch fits in the first cache line, followed
+ * by the packed display and then memory.
+ */
+struct alignas(64) ChipState {
+    // Registers
+    registers::Type V{};
+    // Return addresses and stack pointer
+    stack::Type stack;
+    // Program counter
+    std::uint16_t program_counter{memory::kProgramSpaceOffset};
+    // Index register
+    std::uint16_t index_register{};
+    // Delay Timer
+    std::uint8_t delay_timer{};
+    // Sound Timer
+    std::uint8_t sound_timer{};
+    // Keys held down, sampled by the frontend
+    keyboard::Type keys{};
+    // Set by the instruction that stopped the machine
+    fault::Type fault;
+
+    // Random byte generator behind Cxkk
+    random::Generator rnd;
+
+    // Display buffer
+    alignas(64) display::Type display;
     // Memory
-    memory::Type memory{
+    alignas(64) memory::Type memory{
         0xF0, 0x90, 0x90, 0x90, 0xF0,  // 0
         0x20, 0x60, 0x20, 0x20, 0x70,  // 1
         0xF0, 0x10, 0xF0, 0x80, 0xF0,  // 2
@@ -37,27 +117,38 @@ struct ChipState {
         0xF0, 0x80, 0xF0, 0x80, 0xF0,  // E
         0xF0, 0x80, 0xF0, 0x80, 0x80   // F
     };
-    // Display buffer
-    display::Type display;
-    // Registers
-    registers::Type V{};
-    // Random engine
-    std::minstd_rand rnd;
-    // Program counter
-    std::uint16_t program_counter{memory::kProgramSpaceOffset};
-    // Index register
-    std::uint16_t index_register{};
-    // Delay Timer
-    std::uint8_t delay_timer{};
-    // Sound Timer
-    std::uint8_t sound_timer{};
+};
 
-    // Keyboard state
-    keyboard::Type keyboard{};
+// Registers, stack, timers, keys and fault share the first cache line, the
+// generator takes the second, the display the next five
+static_assert(offsetof(ChipState, fault) + sizeof(fault::Type) <= 64,
+              "Hot fields spill out of the first cache line");
+static_assert(sizeof(ChipState) == (7 * 64) + memory::kSize,
+              "ChipState grew past its cache-line budget");
+static_assert(std::is_trivially_copyable_v<ChipState>,
+              "Snapshots copy ChipState bytewise");
 
-    // Stack TODO: Implement a static stack
-    std::stack<std::uint16_t> stack;
-};
+namespace timers {  // Timer pacing
+
+/**
+ * @brief Tick the delay and sound timers, and the random generator, once per
+ * retired instruction
+ *
+ * @param state
+ * @param retired
+ */
+inline void tick(ChipState& state, const std::size_t retired) noexcept {
+    const auto kTicks =
+        static_cast<std::uint8_t>(std::min<std::size_t>(retired, UINT8_MAX));
+    state.delay_timer = static_cast<std::uint8_t>(
+        state.delay_timer - std::min(state.delay_timer, kTicks));
+    // Make a beep while the sound timer runs
+    state.sound_timer = static_cast<std::uint8_t>(
+        state.sound_timer - std::min(state.sound_timer, kTicks));
+    state.rnd.tick(retired);
+}
+
+}  // namespace timers
 
 }  // namespace emu
 
@@ -11,13 +11,50 @@ constexpr std::size_t kWidth = 64;
 // Y axis
 constexpr std::size_t kHeight = 32;
 
+static_assert(kWidth == 64, "Display rows are packed into 64-bit words");
+
+/**
+ * @brief One bit per pixel, one word per row. The leftmost pixel is the most
+ * significant bit, so a sprite byte shifted right by x lands in place.
+ */
 struct Display {
-    std::array<std::uint8_t, kWidth * kHeight> buffer{};
+    std::array<std::uint64_t, kHeight> rows{};
     bool draw{};
 };
 
 using Type = Display;
 
+/**
+ * @brief Whether the pixel at (x, y) is lit
+ *
+ * @param display
+ * @param x
+ * @param y
+ * @return bool
+ */
+constexpr bool pixel(const Display& display,
+                     const std::size_t x,
+                     const std::size_t y) noexcept {
+    return ((display.rows[y] >> (kWidth - 1U - x)) & 1U) != 0;
+}
+
+/**
+ * @brief Light or clear the pixel at (x, y)
+ *
+ * @param display
+ * @param x
+ * @param y
+ * @param lit
+ */
+constexpr void setPixel(Display& display,
+                        const std::size_t x,
+                        const std::size_t y,
+                        const bool lit) noexcept {
+    const auto kBit = std::uint64_t{1} << (kWidth - 1U - x);
+    display.rows[y] =
+        lit ? (display.rows[y] | kBit) : (display.rows[y] & ~kBit);
+}
+
 }  // namespace emu::display
 
 #endif /* CHIP_8_DISPLAY_HPP */
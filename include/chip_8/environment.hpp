@@ -0,0 +1,232 @@
+#ifndef CHIP_8_ENVIRONMENT_HPP
+#define CHIP_8_ENVIRONMENT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/display.hpp"
+#include "chip_8/golden.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/predecoder.hpp"
+#include "chip_8/random.hpp"
+#include "chip_8/worker_pool.hpp"
+
+namespace emu::environment {  // Reinforcement-learning environments
+
+// Packed framebuffer, one word per row, leftmost pixel in the top bit
+using Frame = std::array<std::uint64_t, display::kHeight>;
+
+struct Config {
+    // Frames run per step with the same keys held, only the last is observed
+    std::size_t frame_skip = 1;
+    // Instructions per 60 Hz frame
+    std::size_t instructions_per_frame = golden::kInstructionsPerFrame;
+    // Frames after which an episode is cut short, 0 for no limit
+    std::uint64_t max_frames = 0;
+    random::Mode random = random::Mode::kXorshift;
+};
+
+/**
+ * @brief Run one 60 Hz frame headless and unthrottled, ticking the timers as
+ * Chip8::cycle does. Fused ops may run past the end of a frame, the next one
+ * is shortened by the overshoot so frames keep their length on average.
+ * Never allocates.
+ *
+ * @param state
+ * @param program predecoded program of the state's memory
+ * @param instructions instructions per frame
+ * @param overshoot instructions the previous frame ran past its end
+ * @return instructions this frame ran past its end
+ */
+std::size_t runFrame(ChipState& state,
+                     predecoder::Program& program,
+                     std::size_t instructions,
+                     std::size_t overshoot) noexcept;
+
+/**
+ * @brief Game-specific knowledge, usually read from memory (score digits,
+ * lives). Batch calls the hooks from its worker threads, so they must be safe
+ * to call concurrently.
+ */
+struct Hooks {
+    // Running score, a step is rewarded with how much it grew. Empty for no
+    // reward.
+    std::function<float(const ChipState&)> score;
+    // Whether the game is over. Faults always end an episode.
+    std::function<bool(const ChipState&)> over;
+};
+
+/**
+ * @brief Outcome of one step
+ */
+struct Step {
+    Frame frame;
+    float reward;
+    bool done;
+};
+
+/**
+ * @brief Machine the ROM starts on and its predecoded program, shared by every
+ * episode
+ */
+class Image {
+    ChipState state_;
+    std::unique_ptr<predecoder::Program> program_;
+
+   public:
+    /**
+     * @brief Load a ROM and predecode what static analysis finds reachable
+     *
+     * @param rom
+     * @throw RomSizeError
+     */
+    explicit Image(std::span<const std::uint8_t> rom);
+
+    [[nodiscard]] const ChipState& state() const noexcept { return state_; }
+    [[nodiscard]] const predecoder::Program& program() const noexcept {
+        return *program_;
+    }
+};
+
+/**
+ * @brief Per-episode bookkeeping next to a machine
+ */
+struct Episode {
+    // Instructions run past the end of the last frame by a fused op
+    std::size_t overshoot{};
+    std::uint64_t frames{};
+    float score{};
+};
+
+/**
+ * @brief Single environment. Steps run on the predecoder, which allocates
+ * nothing once constructed.
+ */
+class Environment {
+    Config config_;
+    Hooks hooks_;
+    Image image_;
+    ChipState state_;
+    // 64 KiB, kept off the stack
+    std::unique_ptr<predecoder::Program> program_;
+    Episode episode_;
+
+   public:
+    /**
+     * @brief Load a ROM, call reset() before stepping
+     *
+     * @param rom
+     * @param config
+     * @param hooks
+     * @throw RomSizeError
+     */
+    Environment(std::span<const std::uint8_t> rom,
+                Config config = {},
+                Hooks hooks = {});
+
+    /**
+     * @brief Start an episode
+     *
+     * @param seed of the Cxkk generator
+     * @return first frame
+     */
+    const Frame& reset(std::uint32_t seed);
+
+    /**
+     * @brief Run config.frame_skip frames with keys held down
+     *
+     * @param action_mask one bit per key, see keyboard::pressed
+     * @return last frame, reward and whether the episode is over
+     */
+    Step step(keyboard::Type action_mask);
+
+    [[nodiscard]] const ChipState& state() const noexcept { return state_; }
+};
+
+/**
+ * @brief N environments on the same ROM, stepped together across a worker
+ * pool. Machines, programs and outputs live in contiguous arrays allocated
+ * once, so steps do not allocate. An environment whose episode ends is reset
+ * within the same step: its frame is the first of the next episode while
+ * done() still reports the end.
+ */
+class Batch {
+    Config config_;
+    Hooks hooks_;
+    Image image_;
+    std::vector<ChipState> states_;
+    std::vector<predecoder::Program> programs_;
+    std::vector<Episode> episodes_;
+    // Seed of the next episode of each environment
+    std::vector<std::uint32_t> seeds_;
+
+    std::vector<Frame> frames_;
+    std::vector<float> rewards_;
+    std::vector<std::uint8_t> dones_;
+
+    WorkerPool pool_;
+
+    void resetOne(std::size_t index) noexcept;
+
+   public:
+    /**
+     * @brief Allocate every environment, call reset() before stepping
+     *
+     * @param rom
+     * @param size number of environments
+     * @param threads see WorkerPool
+     * @param config
+     * @param hooks
+     * @throw RomSizeError
+     */
+    Batch(std::span<const std::uint8_t> rom,
+          std::size_t size,
+          std::size_t threads = 0,
+          Config config = {},
+          Hooks hooks = {});
+
+    /**
+     * @brief Start an episode everywhere, environment i seeded with seed + i.
+     * Later episodes of i continue with seed + i + size, seed + i + 2 * size...
+     *
+     * @param seed
+     */
+    void reset(std::uint32_t seed);
+
+    /**
+     * @brief Step every environment
+     *
+     * @param action_masks one per environment
+     * @throw std::invalid_argument on a size mismatch
+     */
+    void step(std::span<const keyboard::Type> action_masks);
+
+    [[nodiscard]] std::size_t size() const noexcept { return states_.size(); }
+
+    [[nodiscard]] std::size_t threads() const noexcept { return pool_.size(); }
+
+    // Outputs of the last step, one per environment
+    [[nodiscard]] std::span<const Frame> frames() const noexcept {
+        return frames_;
+    }
+    [[nodiscard]] std::span<const float> rewards() const noexcept {
+        return rewards_;
+    }
+    [[nodiscard]] std::span<const std::uint8_t> dones() const noexcept {
+        return dones_;
+    }
+
+    [[nodiscard]] const ChipState& state(const std::size_t index) const {
+        return states_[index];
+    }
+};
+
+}  // namespace emu::environment
+
+#endif /* CHIP_8_ENVIRONMENT_HPP */
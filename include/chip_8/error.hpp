@@ -1,6 +1,7 @@
 #ifndef CHIP_8_ERROR_HANDLING_HPP
 #define CHIP_8_ERROR_HANDLING_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <format>
 #include <stdexcept>
@@ -8,24 +9,68 @@
 
 namespace emu {
 
-class InvalidInstructionError : public std::runtime_error {
+class TraceFormatError : public std::runtime_error {
    public:
-    explicit InvalidInstructionError()
-        : std::runtime_error("Invalid instruction") {};
-    explicit InvalidInstructionError(const std::uint16_t bytecode)
-        : std::runtime_error(
-              std::format("Invalid instruction: 0x{:04X}", bytecode)) {};
-    explicit InvalidInstructionError(const std::string& message)
+    explicit TraceFormatError() : std::runtime_error("Invalid trace") {};
+    explicit TraceFormatError(const std::string& message)
         : std::runtime_error(message) {}
 };
 
-class StackUnderflowError : public std::runtime_error {
+class CaptureFormatError : public std::runtime_error {
    public:
-    explicit StackUnderflowError() : std::runtime_error("Stack underflow") {};
-    explicit StackUnderflowError(const std::string& message)
+    explicit CaptureFormatError() : std::runtime_error("Invalid capture") {};
+    explicit CaptureFormatError(const std::string& message)
         : std::runtime_error(message) {}
 };
 
+class GoldenFormatError : public std::runtime_error {
+   public:
+    explicit GoldenFormatError() : std::runtime_error("Invalid golden file") {};
+    explicit GoldenFormatError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+class RomSizeError : public std::runtime_error {
+   public:
+    explicit RomSizeError() : std::runtime_error("ROM does not fit in memory") {};
+    explicit RomSizeError(const std::size_t size)
+        : std::runtime_error(std::format(
+              "ROM of {} bytes does not fit in memory", size)) {};
+};
+
+class RomLoadError : public std::runtime_error {
+   public:
+    explicit RomLoadError(const std::string& path, const std::string& reason)
+        : std::runtime_error(std::format("Cannot load {}: {}", path, reason)) {}
+};
+
+class RomIndexFormatError : public std::runtime_error {
+   public:
+    explicit RomIndexFormatError() : std::runtime_error("Invalid ROM index") {};
+    explicit RomIndexFormatError(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+class SharedMemoryError : public std::runtime_error {
+   public:
+    explicit SharedMemoryError(const std::string& name,
+                               const std::string& reason)
+        : std::runtime_error(
+              std::format("Cannot share frames as {}: {}", name, reason)) {}
+};
+
+class NetplayError : public std::runtime_error {
+   public:
+    explicit NetplayError(const std::string& reason)
+        : std::runtime_error(std::format("Netplay failed: {}", reason)) {}
+};
+
+class AssemblyError : public std::runtime_error {
+   public:
+    explicit AssemblyError(const std::size_t line, const std::string& message)
+        : std::runtime_error(std::format("line {}: {}", line, message)) {}
+};
+
 }  // namespace emu
 
 #endif /* CHIP_8_ERROR_HANDLING_HPP */
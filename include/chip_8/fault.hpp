@@ -0,0 +1,53 @@
+#ifndef CHIP_8_FAULT_HPP
+#define CHIP_8_FAULT_HPP
+
+#include <cstdint>
+#include <string_view>
+
+namespace emu::fault {  // Execution faults
+
+enum class Status : std::uint8_t {
+    kNone,
+    kInvalidInstruction,
+    // RET with an empty stack
+    kStackUnderflow,
+    // CALL past stack::kDepth nested calls
+    kStackOverflow,
+};
+
+/**
+ * @brief Instruction that stopped the machine. The program counter is left
+ * on it, so stepping a faulted machine faults again.
+ */
+struct Fault {
+    Status status{Status::kNone};
+    // Address of the faulting instruction
+    std::uint16_t address{};
+    std::uint16_t bytecode{};
+};
+
+using Type = Fault;
+
+/**
+ * @brief Describe a status for logs
+ *
+ * @param status
+ * @return std::string_view
+ */
+constexpr std::string_view describe(const Status status) noexcept {
+    switch (status) {
+        case Status::kNone:
+            return "No fault";
+        case Status::kInvalidInstruction:
+            return "Invalid instruction";
+        case Status::kStackUnderflow:
+            return "Stack underflow on RET";
+        case Status::kStackOverflow:
+            return "Stack overflow on CALL";
+    }
+    return "Unknown fault";
+}
+
+}  // namespace emu::fault
+
+#endif /* CHIP_8_FAULT_HPP */
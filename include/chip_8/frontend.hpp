@@ -1,5 +1,112 @@
 #ifndef CHIP_8_FRONTEND_HPP
 #define CHIP_8_FRONTEND_HPP
 
+#include <chrono>
+#include <concepts>
+
+#include "chip_8/display.hpp"
+#include "chip_8/keyboard.hpp"
+
+namespace emu::frontend {  // Where frames go and keys come from
+
+// Wall time the core owes the frontend before its next cycle
+using Duration = std::chrono::duration<double, std::milli>;
+
+/**
+ * @brief What Chip8::cycle needs from a frontend. Chip8::cycle is a template
+ * over the frontend, so these calls are resolved at compile time and inline
+ * into the cycle.
+ *
+ * - present(display): show a frame, called when the display changed
+ * - poll(): keys held down right now
+ * - beep(on): open or close the audio gate, called when it changes
+ * - wait(duration): sleep off the rest of a frame, called by the run loop
+ *   outside the core. Frontends presenting with vsync may return at once.
+ * - kPaced: whether the frontend runs in real time. Unpaced frontends run
+ *   as fast as possible and are never asked to wait.
+ */
+template <typename T>
+concept Frontend = requires(T frontend,
+                            const display::Display& display,
+                            const bool on,
+                            const Duration duration) {
+    { T::kPaced } -> std::convertible_to<bool>;
+    frontend.present(display);
+    { frontend.poll() } -> std::same_as<keyboard::Type>;
+    frontend.beep(on);
+    frontend.wait(duration);
+};
+
+/**
+ * @brief Whether a frontend only hands frames on to be shown later, in which
+ * case whoever shows them reports the present to the instrumentation
+ */
+template <typename T>
+constexpr bool kDeferred = requires { requires T::kDeferred; };
+
+/**
+ * @brief Frontend that shows nothing and reads no keys, for benchmarks and
+ * batch runs. Every hook compiles to nothing.
+ */
+struct Null {
+    static constexpr bool kPaced = false;
+
+    void present(const display::Display& /* not used */) noexcept {}
+    [[nodiscard]] keyboard::Type poll() const noexcept { return 0; }
+    void beep(const bool /* not used */) noexcept {}
+    void wait(const Duration /* not used */) noexcept {}
+};
+
+static_assert(Frontend<Null>);
+
+/**
+ * @brief Frontend keeping the latest frame for another thread to present,
+ * so instances can be emulated off the thread owning their windows. Paced
+ * like a window, but waiting is left to whoever presents.
+ */
+class Offscreen {
+    display::Display frame_;
+    bool fresh_{};
+    keyboard::Type keys_{};
+    bool beeping_{};
+
+   public:
+    static constexpr bool kPaced = true;
+    static constexpr bool kDeferred = true;
+
+    void present(const display::Display& display) noexcept {
+        frame_ = display;
+        fresh_ = true;
+    }
+    [[nodiscard]] keyboard::Type poll() const noexcept { return keys_; }
+    void beep(const bool on) noexcept { beeping_ = on; }
+    void wait(const Duration /* not used */) noexcept {}
+
+    /**
+     * @brief Set the keys the next frames read
+     *
+     * @param keys
+     */
+    void hold(const keyboard::Type keys) noexcept { keys_ = keys; }
+
+    [[nodiscard]] bool beeping() const noexcept { return beeping_; }
+
+    /**
+     * @brief Frame presented since the previous call, if any
+     *
+     * @return const display::Display*
+     */
+    [[nodiscard]] const display::Display* take() noexcept {
+        if (!fresh_) {
+            return nullptr;
+        }
+        fresh_ = false;
+        return &frame_;
+    }
+};
+
+static_assert(Frontend<Offscreen>);
+
+}  // namespace emu::frontend
 
 #endif /* CHIP_8_FRONTEND_HPP */
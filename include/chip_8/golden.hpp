@@ -0,0 +1,150 @@
+#ifndef CHIP_8_GOLDEN_HPP
+#define CHIP_8_GOLDEN_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/display.hpp"
+
+namespace emu::golden {
+
+// Instructions per 60 Hz frame at the pace of Chip8::cycle (1.43 ms each)
+constexpr std::size_t kInstructionsPerFrame = 12;
+
+/**
+ * @brief FNV-1a hash of the framebuffer
+ *
+ * @param display
+ * @return std::uint64_t
+ */
+std::uint64_t hash(const display::Display& display);
+
+/**
+ * @brief FNV-1a hash of the architectural state: memory, registers, timers,
+ * stack and framebuffer. The keyboard and random engine are left out.
+ *
+ * @param state
+ * @return std::uint64_t
+ */
+std::uint64_t hash(const ChipState& state);
+
+/**
+ * @brief Key held down for frames [first, last)
+ */
+struct KeyPress {
+    std::uint8_t key;
+    std::uint32_t first;
+    std::uint32_t last;
+};
+
+/**
+ * @brief One headless run, as listed in a manifest
+ */
+struct Scenario {
+    std::string name;
+    // `workload:<draw|alu|call|timer>:<rounds>`, `asm:<source>` or a binary
+    // ROM path, relative to the manifest
+    std::string rom;
+    std::uint32_t frames{};
+    // Frames between two checkpoints, the last frame is always one
+    std::uint32_t every{};
+    std::vector<KeyPress> presses;
+};
+
+/**
+ * @brief Hashes taken at the end of a frame
+ */
+struct Checkpoint {
+    std::uint32_t frame;
+    std::uint64_t display;
+    std::uint64_t state;
+
+    bool operator==(const Checkpoint&) const = default;
+};
+
+/**
+ * @brief Outcome of a run, or the golden values it is compared against
+ */
+struct Result {
+    std::vector<Checkpoint> checkpoints;
+    std::chrono::nanoseconds elapsed{};
+};
+
+using Goldens = std::map<std::string, Result, std::less<>>;
+
+/**
+ * @brief Parse a manifest. One scenario per line:
+ * `<name> <rom> frames=N [every=N] [press=K@first:last]...`, `#` starts a
+ * comment.
+ *
+ * @param input
+ * @return scenarios in manifest order
+ * @throw GoldenFormatError
+ */
+std::vector<Scenario> parseManifest(std::istream& input);
+
+/**
+ * @brief Produce the ROM of a scenario
+ *
+ * @param rom Scenario::rom
+ * @param directory of the manifest
+ * @return ROM bytes
+ * @throw GoldenFormatError, AssemblyError, RomSizeError
+ */
+std::vector<std::uint8_t> loadRom(const std::string& rom,
+                                  const std::filesystem::path& directory);
+
+/**
+ * @brief Run a ROM headless on the block cache. Frames are exactly
+ * kInstructionsPerFrame instructions so checkpoints do not depend on how
+ * code is split into blocks.
+ *
+ * @param scenario
+ * @param rom
+ * @return checkpoints and wall time spent executing
+ */
+Result run(const Scenario& scenario, std::span<const std::uint8_t> rom);
+
+/**
+ * @brief Read golden values written by writeGoldens
+ *
+ * @param input
+ * @return Goldens
+ * @throw GoldenFormatError
+ */
+Goldens readGoldens(std::istream& input);
+
+/**
+ * @brief Write one line per checkpoint (`<name> <frame> <display> <state>`)
+ * and one per wall time (`<name> time <nanoseconds>`)
+ *
+ * @param output
+ * @param goldens
+ */
+void writeGoldens(std::ostream& output, const Goldens& goldens);
+
+/**
+ * @brief Speed of this machine relative to the one that recorded the golden
+ * times: the geometric mean of golden time over run time, across the ROMs
+ * timed in both. Golden times divided by it are what the ROMs should take
+ * here, so a ROM that got slower than the others stands out on any machine.
+ *
+ * @param results
+ * @param goldens
+ * @return 1 if no ROM was timed in both
+ */
+double machineSpeed(const Goldens& results, const Goldens& goldens);
+
+}  // namespace emu::golden
+
+#endif /* CHIP_8_GOLDEN_HPP */
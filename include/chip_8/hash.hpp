@@ -0,0 +1,46 @@
+#ifndef CHIP_8_HASH_HPP
+#define CHIP_8_HASH_HPP
+
+#include <cstdint>
+
+namespace emu::hash {
+
+constexpr std::uint64_t kFnvOffset = 0xCBF29CE484222325ULL;
+constexpr std::uint64_t kFnvPrime = 0x100000001B3ULL;
+
+/**
+ * @brief Incremental 64-bit FNV-1a hash, multi-byte values are fed little
+ * endian so hashes are portable
+ */
+class Fnv {
+    std::uint64_t value_{kFnvOffset};
+
+   public:
+    void add(const std::uint8_t byte) noexcept {
+        value_ = (value_ ^ byte) * kFnvPrime;
+    }
+
+    void add16(const std::uint16_t word) noexcept {
+        add(static_cast<std::uint8_t>(word & 0xFFU));
+        add(static_cast<std::uint8_t>(word >> 8U));
+    }
+
+    void add64(const std::uint64_t word) noexcept {
+        for (unsigned int shift = 0; shift < 64; shift += 8) {
+            add(static_cast<std::uint8_t>((word >> shift) & 0xFFU));
+        }
+    }
+
+    template <typename Range>
+    void addAll(const Range& bytes) noexcept {
+        for (const auto kByte : bytes) {
+            add(static_cast<std::uint8_t>(kByte));
+        }
+    }
+
+    [[nodiscard]] std::uint64_t value() const noexcept { return value_; }
+};
+
+}  // namespace emu::hash
+
+#endif /* CHIP_8_HASH_HPP */
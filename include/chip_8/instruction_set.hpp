@@ -7,120 +7,124 @@
 
 namespace emu::instruction_set {
 
-using Instruction = void (*)(ChipState& chip, const std::uint16_t);
+using Instruction = void (*)(ChipState& chip, const std::uint16_t) noexcept;
 
 /**
  * @brief JMP to a host machine code - Treated as NOP
  *
  * @param bytecode
  */
-void op0nnn(ChipState& /* not used */, const std::uint16_t /* not used */);
+void op0nnn(ChipState& /* not used */,
+            const std::uint16_t /* not used */) noexcept;
 
 /**
  * @brief CLS - Clear the display.
  *
  * @param bytecode
  */
-void op00E0(ChipState& state, const std::uint16_t bytecode);
+void op00E0(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief Return Call - The interpreter sets the program counter to the
  * address at the top of the stack, then subtracts 1 from the stack pointer.
+ * Faults with fault::Status::kStackUnderflow on an empty stack.
  *
  * @param bytecode
  */
-void op00EE(ChipState& state, const std::uint16_t /* not used */);
+void op00EE(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief JMP to address - The interpreter sets the program counter to nnn.
  *
  * @param bytecode
  */
-void op1nnn(ChipState& state, const std::uint16_t bytecode);
+void op1nnn(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief Call address - The interpreter increments the stack pointer, then
  * puts the current PC on the top of the stack. The PC is then set to nnn.
  *
+ * Faults with fault::Status::kStackOverflow past stack::kDepth nested calls.
+ *
  * @param bytecode
  */
-void op2nnn(ChipState& state, const std::uint16_t bytecode);
+void op2nnn(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SE Vx, byte - Skip next bytecode if Vx = kk.
  *
  * @param bytecode
  */
-void op3xkk(ChipState& state, const std::uint16_t bytecode);
+void op3xkk(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SNE Vx, byte - Skip next bytecode if Vx != kk.
  *
  * @param bytecode
  */
-void op4xkk(ChipState& state, const std::uint16_t bytecode);
+void op4xkk(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SE Vx, Vy - Skip next bytecode if Vx = Vy.
  *
  * @param bytecode
  */
-void op5xy0(ChipState& state, const std::uint16_t bytecode);
+void op5xy0(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD Vx, byte - Set Vx = kk.
  *
  * @param bytecode
  */
-void op6xkk(ChipState& state, const std::uint16_t bytecode);
+void op6xkk(ChipState& state, const std::uint16_t bytecode) noexcept;
 /**
  * @brief ADD Vx, byte - Set Vx = Vx + kk.
  *
  * @param bytecode
  */
-void op7xkk(ChipState& state, const std::uint16_t bytecode);
+void op7xkk(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD Vx, Vy - Set Vx = Vy.
  *
  * @param bytecode
  */
-void op8xy0(ChipState& state, const std::uint16_t bytecode);
+void op8xy0(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief OR Vx, Vy - Set Vx = Vx OR Vy.
  *
  * @param bytecode
  */
-void op8xy1(ChipState& state, const std::uint16_t bytecode);
+void op8xy1(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief AND Vx, Vy - Set Vx = Vx AND Vy.
  *
  * @param bytecode
  */
-void op8xy2(ChipState& state, const std::uint16_t bytecode);
+void op8xy2(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief XOR Vx, Vy - Set Vx = Vx XOR Vy.
  *
  * @param bytecode
  */
-void op8xy3(ChipState& state, const std::uint16_t bytecode);
+void op8xy3(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief ADD Vx, Vy - Set Vx = Vx + Vy, set VF = carry.
  *
  * @param bytecode
  */
-void op8xy4(ChipState& state, const std::uint16_t bytecode);
+void op8xy4(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SUB Vx, Vy - Set Vx = Vx - Vy, set VF = NOT borrow.
  *
  * @param bytecode
  */
-void op8xy5(ChipState& state, const std::uint16_t bytecode);
+void op8xy5(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SHR Vx {, Vy} - Set Vx = Vx SHR 1.
@@ -128,14 +132,14 @@ void op8xy5(ChipState& state, const std::uint16_t bytecode);
  * @todo Add option to recreate COSMAC VIP. Store Vy into Vx first.
  * @param bytecode
  */
-void op8xy6(ChipState& state, const std::uint16_t bytecode);
+void op8xy6(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SUBN Vx, Vy - Set Vx = Vy - Vx, set VF = NOT borrow.
  *
  * @param bytecode
  */
-void op8xy7(ChipState& state, const std::uint16_t bytecode);
+void op8xy7(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SHL Vx {, Vy} - Set Vx = Vx SHL 1.
@@ -143,21 +147,21 @@ void op8xy7(ChipState& state, const std::uint16_t bytecode);
  * @todo Add option to recreate COSMAC VIP. Store Vy into Vx first.
  * @param bytecode
  */
-void op8xyE(ChipState& state, const std::uint16_t bytecode);
+void op8xyE(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SNE Vx, Vy - Skip next bytecode if Vx != Vy.
  *
  * @param bytecode
  */
-void op9xy0(ChipState& state, const std::uint16_t bytecode);
+void op9xy0(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD I, addr - Set I = nnn.
  *
  * @param bytecode
  */
-void opAnnn(ChipState& state, const std::uint16_t bytecode);
+void opAnnn(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief JP V0, addr - Jump to location nnn + V0.
@@ -165,22 +169,23 @@ void opAnnn(ChipState& state, const std::uint16_t bytecode);
  * @todo Add option to recreate CHIP-48 and SUPER-CHIP. Use Vx instead of V0.
  * @param bytecode
  */
-void opBnnn(ChipState& state, const std::uint16_t bytecode);
+void opBnnn(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief RND Vx, byte - Set Vx = random byte AND kk.
  *
  * @param bytecode
  */
-void opCxkk(ChipState& state, const std::uint16_t bytecode);
+void opCxkk(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief DRW Vx, Vy, nibble - Display n-byte sprite starting at memory
- * location I at (Vx, Vy), set VF = collision.
+ * location I at (Vx, Vy), set VF = collision. Like every access through I,
+ * reads wrap around the end of memory.
  *
  * @param bytecode
  */
-void opDxyn(ChipState& state, const std::uint16_t bytecode);
+void opDxyn(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SKP Vx - Skip next bytecode if key with the value of Vx is
@@ -188,7 +193,7 @@ void opDxyn(ChipState& state, const std::uint16_t bytecode);
  *
  * @param bytecode
  */
-void opEx9E(ChipState& state, const std::uint16_t bytecode);
+void opEx9E(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief SKNP Vx - Skip next bytecode if key with the value of Vx is not
@@ -196,49 +201,49 @@ void opEx9E(ChipState& state, const std::uint16_t bytecode);
  *
  * @param bytecode
  */
-void opExA1(ChipState& state, const std::uint16_t bytecode);
+void opExA1(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD Vx, DT - Set Vx = delay timer value.
  *
  * @param bytecode
  */
-void opFx07(ChipState& state, const std::uint16_t bytecode);
+void opFx07(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD Vx, K - Wait for a key press, store the value of the key in Vx.
  *
  * @param bytecode
  */
-void opFx0A(ChipState& state, const std::uint16_t bytecode);
+void opFx0A(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD DT, Vx - Set delay timer = Vx.
  *
  * @param bytecode
  */
-void opFx15(ChipState& state, const std::uint16_t bytecode);
+void opFx15(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD ST, Vx - Set sound timer = Vx.
  *
  * @param bytecode
  */
-void opFx18(ChipState& state, const std::uint16_t bytecode);
+void opFx18(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief ADD I, Vx - Set I = I + Vx.
  *
  * @param bytecode
  */
-void opFx1E(ChipState& state, const std::uint16_t bytecode);
+void opFx1E(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD F, Vx - Set I = location of sprite for digit Vx.
  *
  * @param bytecode
  */
-void opFx29(ChipState& state, const std::uint16_t bytecode);
+void opFx29(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD B, Vx - Store BCD representation of Vx in memory locations I,
@@ -246,7 +251,7 @@ void opFx29(ChipState& state, const std::uint16_t bytecode);
  *
  * @param bytecode
  */
-void opFx33(ChipState& state, const std::uint16_t bytecode);
+void opFx33(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief LD [I], Vx - Store registers V0 through Vx in memory starting at
@@ -255,7 +260,7 @@ void opFx33(ChipState& state, const std::uint16_t bytecode);
  * @todo Add option to recreate COSMAC VIP. Update I after each store.
  * @param bytecode
  */
-void opFx55(ChipState& state, const std::uint16_t bytecode);
+void opFx55(ChipState& state, const std::uint16_t bytecode) noexcept;
 
 /**
  * @brief Fx65 - LD Vx, [I] - Load memory starting at location I into registers V0 through Vx.
@@ -263,7 +268,65 @@ void opFx55(ChipState& state, const std::uint16_t bytecode);
  * @todo Add option to recreate COSMAC VIP. Update [I] after each load.
  * @param bytecode
  */
-void opFx65(ChipState& state, const std::uint16_t bytecode);
+void opFx65(ChipState& state, const std::uint16_t bytecode) noexcept;
+
+/**
+ * @brief Not an instruction - Faults with fault::Status::kInvalidInstruction.
+ *
+ * @param bytecode
+ */
+void opInvalid(ChipState& state, const std::uint16_t bytecode) noexcept;
+
+// ============================================================================
+// Superinstructions - Fused sequences emitted by the predecoder. The program
+// counter must already point past the whole sequence.
+// ============================================================================
+
+/**
+ * @brief 6xkk; 6xkk - Two consecutive register loads.
+ *
+ * @param first
+ * @param second
+ */
+void op6xkk6xkk(ChipState& state,
+                const std::uint16_t first,
+                const std::uint16_t second) noexcept;
+
+/**
+ * @brief Annn; Dxyn - Point I to a sprite and draw it.
+ *
+ * @param first
+ * @param second
+ */
+void opAnnnDxyn(ChipState& state,
+                const std::uint16_t first,
+                const std::uint16_t second) noexcept;
+
+/**
+ * @brief 7xkk; 3xkk; 1nnn - Counting loop. Add to a register, then jump
+ * back unless it reached the limit.
+ *
+ * @param first
+ * @param second
+ * @param third
+ */
+void op7xkk3xkk1nnn(ChipState& state,
+                    const std::uint16_t first,
+                    const std::uint16_t second,
+                    const std::uint16_t third) noexcept;
+
+/**
+ * @brief Fx07; 3xkk; 1nnn - Timer wait. Read the delay timer, then jump back
+ * unless it reached the expected value.
+ *
+ * @param first
+ * @param second
+ * @param third
+ */
+void opFx073xkk1nnn(ChipState& state,
+                    const std::uint16_t first,
+                    const std::uint16_t second,
+                    const std::uint16_t third) noexcept;
 
 };  // namespace emu::instruction_set
 
@@ -0,0 +1,470 @@
+#ifndef CHIP_8_INSTRUMENTATION_HPP
+#define CHIP_8_INSTRUMENTATION_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <span>
+#include <utility>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/opcode.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#    include <intrin.h>
+#endif
+
+namespace emu::instrumentation {
+
+// Driven by the CHIP_8_ENABLE_INSTRUMENTATION CMake option
+#ifdef CHIP_8_ENABLE_INSTRUMENTATION
+constexpr bool kEnabled = true;
+#else
+constexpr bool kEnabled = false;
+#endif
+
+// Engine the counters are measured on. Chip8 leaves the block cache and the
+// recompiled code aside while instrumentation is compiled in, so the costs
+// are those of the reference interpreter, not of the production fast paths.
+constexpr const char* kEngine = "reference";
+
+// One out of kSampleInterval instructions is timed with the cycle counter
+constexpr std::uint64_t kSampleInterval = 64;
+
+// Histogram buckets, bucket n holds durations up to 2^n microseconds and the
+// last one everything longer
+constexpr std::size_t kHistogramBuckets = 21;
+
+// Key events followed at once, a newer one drops the oldest
+constexpr std::size_t kMaxKeyEvents = 8;
+
+// About 30 frames, a key event nothing answered by then was ignored by the
+// ROM and is dropped instead of matched with an unrelated later read
+constexpr std::chrono::milliseconds kInputTimeout(500);
+
+/**
+ * @brief Read the CPU timestamp counter, or a monotonic clock in nanoseconds
+ * where no such counter is available
+ *
+ * @return std::uint64_t
+ */
+inline std::uint64_t readTimestampCounter() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * @brief Running count, sum and maximum of a duration in nanoseconds
+ */
+struct Latency {
+    std::uint64_t count{};
+    std::uint64_t total_ns{};
+    std::uint64_t max_ns{};
+
+    void record(const std::uint64_t nanoseconds) noexcept {
+        count += 1;
+        total_ns += nanoseconds;
+        if (nanoseconds > max_ns) {
+            max_ns = nanoseconds;
+        }
+    }
+
+    [[nodiscard]] double mean() const noexcept {
+        return count == 0 ? 0.0
+                          : static_cast<double>(total_ns) /
+                                static_cast<double>(count);
+    }
+};
+
+/**
+ * @brief Distribution of a duration in nanoseconds over power-of-two buckets
+ */
+struct Histogram {
+    Latency latency;
+    std::array<std::uint64_t, kHistogramBuckets> buckets{};
+
+    /**
+     * @brief Upper bound of a bucket, the last one has none
+     *
+     * @param bucket
+     * @return std::uint64_t
+     */
+    static constexpr std::uint64_t bound(const std::size_t bucket) noexcept {
+        return std::uint64_t{1000} << bucket;
+    }
+
+    void record(const std::uint64_t nanoseconds) noexcept {
+        latency.record(nanoseconds);
+        const auto kMicroseconds = (nanoseconds + 999) / 1000;
+        const auto kBucket =
+            kMicroseconds <= 1
+                ? 0
+                : static_cast<std::size_t>(std::bit_width(kMicroseconds - 1));
+        buckets[std::min(kBucket, kHistogramBuckets - 1)] += 1;
+    }
+
+    /**
+     * @brief Upper bound of the bucket holding a quantile, the maximum when
+     * it falls in the last bucket
+     *
+     * @param quantile in [0, 1]
+     * @return std::uint64_t
+     */
+    [[nodiscard]] std::uint64_t quantile(const double quantile) const {
+        const auto kRank = static_cast<double>(latency.count) * quantile;
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket + 1 < kHistogramBuckets;
+             bucket++) {
+            seen += buckets[bucket];
+            if (seen != 0 && static_cast<double>(seen) >= kRank) {
+                return std::min(bound(bucket), latency.max_ns);
+            }
+        }
+        return latency.max_ns;
+    }
+};
+
+/**
+ * @brief Copy of every counter gathered by the recorder
+ */
+struct Snapshot {
+    // Instructions executed, per opcode
+    std::array<std::uint64_t, opcode::kCount> executions{};
+    // Instructions timed with the cycle counter, per opcode
+    std::array<std::uint64_t, opcode::kCount> sampled_executions{};
+    // Cycle counter ticks spent on timed instructions, per opcode
+    std::array<std::uint64_t, opcode::kCount> sampled_ticks{};
+    // Dxyn executions and how many of them set VF
+    std::uint64_t draws{};
+    std::uint64_t collisions{};
+    // Time from the first instruction that dirties the display to present
+    Latency draw_to_present;
+    // Time the wait for the next frame, a sleep or a present synced to the
+    // display, ended past the scheduler target
+    Latency sleep_overshoot;
+    // Time from a key event to the first instruction reading the keys, to
+    // the next display change after that, and to the present showing it
+    Histogram key_to_read;
+    Histogram key_to_draw;
+    Histogram key_to_present;
+    // Key events dropped unanswered, see kInputTimeout and kMaxKeyEvents
+    std::uint64_t key_expired{};
+
+    /**
+     * @brief Extrapolate the cumulative ticks spent on an opcode from its
+     * sampled executions
+     *
+     * @param id
+     * @return std::uint64_t
+     */
+    [[nodiscard]] std::uint64_t estimatedTicks(const opcode::Id id) const {
+        const auto kIdx = opcode::index(id);
+        if (sampled_executions[kIdx] == 0) {
+            return 0;
+        }
+        return static_cast<std::uint64_t>(
+            static_cast<double>(sampled_ticks[kIdx]) *
+            (static_cast<double>(executions[kIdx]) /
+             static_cast<double>(sampled_executions[kIdx])));
+    }
+
+    [[nodiscard]] double collisionRate() const noexcept {
+        return draws == 0 ? 0.0
+                          : static_cast<double>(collisions) /
+                                static_cast<double>(draws);
+    }
+};
+
+enum class Format : std::uint8_t { kJson, kPrometheus };
+
+/**
+ * @brief Serialize a snapshot as a single JSON object
+ *
+ * @param output
+ * @param snapshot
+ */
+void writeJson(std::ostream& output, const Snapshot& snapshot);
+
+/**
+ * @brief Serialize a snapshot in the Prometheus text exposition format
+ *
+ * @param output
+ * @param snapshot
+ */
+void writePrometheus(std::ostream& output, const Snapshot& snapshot);
+
+/**
+ * @brief Replace the file at path with the serialized snapshot. Writes to a
+ * sibling temporary file first so readers never observe a partial dump.
+ *
+ * @return true at success, false at failure
+ */
+bool dump(const std::filesystem::path& path,
+          Format format,
+          const Snapshot& snapshot);
+
+template <bool kEnable>
+class Recorder;
+
+/**
+ * @brief Disabled recorder. Every hook is an empty inline function so the
+ * interpreter loop compiles to the same code as without instrumentation.
+ */
+template <>
+class Recorder<false> {
+   public:
+    struct Token {};
+
+    static constexpr Token beginInstruction(
+        const std::uint16_t /* not used */) noexcept {
+        return {};
+    }
+    static constexpr void endInstruction(
+        const Token /* not used */,
+        const ChipState& /* not used */) noexcept {}
+    static constexpr void keyEvent() noexcept {}
+    static constexpr void framePresented() noexcept {}
+    static constexpr void slept(
+        const std::chrono::nanoseconds /* not used */,
+        const std::chrono::nanoseconds /* not used */) noexcept {}
+    static void setDumpTarget(const std::filesystem::path& /* not used */,
+                              const Format /* not used */,
+                              const std::uint64_t /* not used */) noexcept {}
+    static constexpr void maybeDump() noexcept {}
+    static constexpr void flush() noexcept {}
+};
+
+/**
+ * @brief Enabled recorder. Counts every instruction and samples its cost
+ * with the cycle counter, without touching the instruction handlers.
+ */
+template <>
+class Recorder<true> {
+    using Clock = std::chrono::steady_clock;
+
+    // What a key event waits for next
+    enum class Input : std::uint8_t { kRead, kDraw, kPresent };
+
+    struct KeyEvent {
+        Clock::time_point since;
+        Input input;
+    };
+
+    Snapshot snapshot_;
+    std::uint64_t instructions_{};
+    Clock::time_point dirty_since_;
+    bool dirty_{};
+    // Key events in flight, oldest first
+    std::array<KeyEvent, kMaxKeyEvents> keys_{};
+    std::size_t pending_{};
+
+    [[nodiscard]] std::span<KeyEvent> pending() noexcept {
+        return {keys_.data(), pending_};
+    }
+
+    [[nodiscard]] static std::uint64_t since(const KeyEvent& key,
+                                             const Clock::time_point now) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now -
+                                                                 key.since)
+                .count());
+    }
+
+    /**
+     * @brief Drop the key events nothing answered within kInputTimeout
+     *
+     * @param now
+     */
+    void expire(const Clock::time_point now) noexcept {
+        std::size_t kept = 0;
+        for (const auto& key : pending()) {
+            if (now - key.since < kInputTimeout) {
+                keys_[kept++] = key;
+            } else {
+                snapshot_.key_expired += 1;
+            }
+        }
+        pending_ = kept;
+    }
+
+    /**
+     * @brief Follow the key events in flight through the instruction stream.
+     * A read answers the events before it, a display change answers the
+     * events an earlier read already answered.
+     *
+     * @param id
+     */
+    void trackInput(const opcode::Id id) noexcept {
+        Input stage{};
+        Histogram* histogram{};
+        if (id == opcode::Id::kEx9E || id == opcode::Id::kExA1 ||
+            id == opcode::Id::kFx0A) {
+            stage = Input::kRead;
+            histogram = &snapshot_.key_to_read;
+        } else if (id == opcode::Id::kDxyn || id == opcode::Id::k00E0) {
+            stage = Input::kDraw;
+            histogram = &snapshot_.key_to_draw;
+        } else {
+            return;
+        }
+
+        const auto kNow = Clock::now();
+        expire(kNow);
+        for (auto& key : pending()) {
+            if (key.input == stage) {
+                histogram->record(since(key, kNow));
+                key.input =
+                    stage == Input::kRead ? Input::kDraw : Input::kPresent;
+            }
+        }
+    }
+
+    std::filesystem::path dump_path_;
+    Format dump_format_{Format::kJson};
+    std::uint64_t dump_interval_{};
+    std::uint64_t next_dump_{};
+
+   public:
+    struct Token {
+        opcode::Id id;
+        std::uint64_t start;
+        bool sampled;
+    };
+
+    Token beginInstruction(const std::uint16_t bytecode) noexcept {
+        const bool kSampled = (instructions_++ % kSampleInterval) == 0;
+        return {opcode::identify(bytecode),
+                kSampled ? readTimestampCounter() : 0, kSampled};
+    }
+
+    void endInstruction(const Token token, const ChipState& state) noexcept {
+        const auto kIdx = opcode::index(token.id);
+        if (token.sampled) {
+            snapshot_.sampled_ticks[kIdx] +=
+                readTimestampCounter() - token.start;
+            snapshot_.sampled_executions[kIdx] += 1;
+        }
+        snapshot_.executions[kIdx] += 1;
+
+        if (token.id == opcode::Id::kDxyn) {
+            snapshot_.draws += 1;
+            snapshot_.collisions += state.V[0xF];
+        }
+
+        if (state.display.draw && !dirty_) {
+            dirty_since_ = Clock::now();
+            dirty_ = true;
+        }
+
+        if (pending_ != 0) {
+            trackInput(token.id);
+        }
+    }
+
+    /**
+     * @brief Mark a key press or release as the host saw it. Every event is
+     * followed on its own, up to kMaxKeyEvents at once.
+     *
+     */
+    void keyEvent() noexcept {
+        const auto kNow = Clock::now();
+        expire(kNow);
+        if (pending_ == kMaxKeyEvents) {
+            std::shift_left(keys_.begin(), keys_.end(), 1);
+            pending_ -= 1;
+            snapshot_.key_expired += 1;
+        }
+        keys_[pending_++] = {kNow, Input::kRead};
+    }
+
+    void framePresented() noexcept {
+        const auto kNow = Clock::now();
+        std::size_t kept = 0;
+        for (const auto& key : pending()) {
+            if (key.input == Input::kPresent) {
+                snapshot_.key_to_present.record(since(key, kNow));
+            } else if (kNow - key.since >= kInputTimeout) {
+                snapshot_.key_expired += 1;
+            } else {
+                keys_[kept++] = key;
+            }
+        }
+        pending_ = kept;
+
+        if (!dirty_) {
+            return;
+        }
+        snapshot_.draw_to_present.record(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(kNow -
+                                                                 dirty_since_)
+                .count()));
+        dirty_ = false;
+    }
+
+    void slept(const std::chrono::nanoseconds requested,
+               const std::chrono::nanoseconds actual) noexcept {
+        const auto kOvershoot = (actual - requested).count();
+        snapshot_.sleep_overshoot.record(
+            kOvershoot > 0 ? static_cast<std::uint64_t>(kOvershoot) : 0);
+    }
+
+    /**
+     * @brief Periodically dump the counters to a file
+     *
+     * @param path destination, replaced on every dump
+     * @param format
+     * @param interval number of instructions between dumps
+     */
+    void setDumpTarget(std::filesystem::path path,
+                       const Format format,
+                       const std::uint64_t interval) {
+        dump_path_ = std::move(path);
+        dump_format_ = format;
+        dump_interval_ = interval;
+        next_dump_ = instructions_ + interval;
+    }
+
+    void maybeDump() {
+        if (dump_interval_ == 0 || instructions_ < next_dump_) {
+            return;
+        }
+        next_dump_ = instructions_ + dump_interval_;
+        dump(dump_path_, dump_format_, snapshot_);
+    }
+
+    /**
+     * @brief Write a final dump, if a dump target was set
+     *
+     */
+    void flush() {
+        if (dump_interval_ != 0) {
+            dump(dump_path_, dump_format_, snapshot_);
+        }
+    }
+
+    [[nodiscard]] const Snapshot& snapshot() const noexcept {
+        return snapshot_;
+    }
+
+    void reset() noexcept {
+        snapshot_ = Snapshot();
+        dirty_ = false;
+        pending_ = 0;
+    }
+};
+
+}  // namespace emu::instrumentation
+
+#endif /* CHIP_8_INSTRUMENTATION_HPP */
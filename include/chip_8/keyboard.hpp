@@ -54,7 +54,50 @@ inline std::size_t mapping(const std::uint8_t key) {
     }
 }
 
-using Type = const bool*;
+// Bit n is set while key n is held down
+using Type = std::uint16_t;
+
+/**
+ * @brief Whether a key is held down, keys past 0xF never are
+ *
+ * @param keys
+ * @param key
+ * @return bool
+ */
+constexpr bool pressed(const Type keys, const unsigned int key) noexcept {
+    return key < kNumKeys && ((keys >> key) & 1U) != 0;
+}
+
+/**
+ * @brief Sample the mapped keys from an SDL keyboard state
+ *
+ * @param scancodes indexed by SDL_Scancode, as from SDL_GetKeyboardState
+ * @return Type
+ */
+inline Type read(const bool* scancodes) {
+    Type keys = 0;
+    for (std::uint8_t key = 0; key < kNumKeys; key++) {
+        if (scancodes[mapping(key)]) {
+            keys |= static_cast<Type>(1U << key);
+        }
+    }
+    return keys;
+}
+
+/**
+ * @brief Whether an SDL scancode is mapped to a keypad key
+ *
+ * @param scancode
+ * @return bool
+ */
+inline bool mapped(const std::size_t scancode) {
+    for (std::uint8_t key = 0; key < kNumKeys; key++) {
+        if (mapping(key) == scancode) {
+            return true;
+        }
+    }
+    return false;
+}
 
 };  // namespace emu::keyboard
 
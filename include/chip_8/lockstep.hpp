@@ -0,0 +1,240 @@
+#ifndef CHIP_8_LOCKSTEP_HPP
+#define CHIP_8_LOCKSTEP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+
+#include "chip_8/aot.hpp"
+#include "chip_8/block_cache.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/hash.hpp"
+#include "chip_8/predecoder.hpp"
+
+namespace emu::lockstep {
+
+// Boundaries between two full state comparisons, registers are compared at
+// every boundary
+constexpr std::size_t kFullCompareInterval = 64;
+
+enum class Engine : std::uint8_t {
+    // One instruction at a time through the instruction_set handlers
+    kReference,
+    kPredecoder,
+    kBlockCache,
+    // Recompiled blocks, falling back to the block cache
+    kAot,
+};
+
+/**
+ * @brief Execute one instruction on the reference interpreter
+ *
+ * @param state
+ * @return number of instructions retired, always 1
+ */
+std::size_t stepReference(ChipState& state);
+
+/**
+ * @brief Cheap hash of the registers, program counter, index, timers, top
+ * of the stack, fault status and random generator
+ *
+ * @param state
+ * @return std::uint64_t
+ */
+std::uint64_t hashRegisters(const ChipState& state);
+
+/**
+ * @brief An engine running on its own machine. Timers tick once per retired
+ * instruction after every step, as in Chip8::cycle.
+ */
+class Runner {
+    ChipState state_;
+    Engine engine_;
+    std::unique_ptr<predecoder::Program> program_;
+    std::unique_ptr<block_cache::BlockCache> blocks_;
+    std::unique_ptr<aot::Runner> aot_;
+
+   public:
+    explicit Runner(Engine engine);
+
+    // aot_ falls back to blocks_
+    Runner(const Runner&) = delete;
+    Runner(Runner&&) = delete;
+    Runner& operator=(const Runner&) = delete;
+    Runner& operator=(Runner&&) = delete;
+    ~Runner() = default;
+
+    /**
+     * @brief Load a ROM at kProgramSpaceOffset on a fresh machine
+     *
+     * @param rom
+     * @param program recompiled ROM, required by Engine::kAot
+     * @throw RomSizeError
+     * @throw std::invalid_argument if the program was not compiled from rom
+     */
+    void load(std::span<const std::uint8_t> rom,
+              const aot::Program* program = nullptr);
+
+    /**
+     * @brief Hold down the keys whose bit is set
+     *
+     * @param mask bit n is key n
+     */
+    void press(std::uint16_t mask);
+
+    /**
+     * @brief Execute the next block, op or instruction, depending on the
+     * engine, without ticking timers
+     *
+     * @return number of instructions retired
+     */
+    std::size_t execute();
+
+    void tick(std::size_t retired) noexcept;
+
+    std::size_t step() {
+        const auto kRetired = execute();
+        tick(kRetired);
+        return kRetired;
+    }
+
+    [[nodiscard]] const ChipState& state() const noexcept { return state_; }
+    [[nodiscard]] Engine engine() const noexcept { return engine_; }
+};
+
+/**
+ * @brief First step where two engines disagree
+ */
+struct Divergence {
+    // Candidate steps before the diverging one
+    std::uint64_t boundary;
+    // Instructions retired before the diverging step
+    std::uint64_t instructions;
+    // Program counter the diverging step started at
+    std::uint16_t entry;
+    // Instructions retired by the diverging step
+    std::size_t retired;
+    ChipState expected;
+    ChipState actual;
+};
+
+/**
+ * @brief Write the fields that differ and the instructions of the step
+ *
+ * @param output
+ * @param divergence
+ */
+void writeReport(std::ostream& output, const Divergence& divergence);
+
+/**
+ * @brief Replay a step on the reference interpreter, ticking timers after
+ * every instruction, and compare the result. Cheap enough to sample in
+ * production.
+ *
+ * @param before state before the step
+ * @param retired instructions the step retired
+ * @param after state after the step and its timer ticks
+ * @return divergence if the reference ends in a different state
+ */
+std::optional<Divergence> verify(const ChipState& before,
+                                 std::size_t retired,
+                                 const ChipState& after);
+
+/**
+ * @brief Runs a candidate engine and the reference interpreter on the same
+ * ROM and input, comparing them after every candidate step
+ */
+class Checker {
+    Runner reference_{Engine::kReference};
+    Runner candidate_;
+    std::size_t full_interval_;
+    std::uint64_t boundaries_{};
+    std::uint64_t instructions_{};
+    hash::Fnv signature_;
+
+   public:
+    /**
+     * @param candidate
+     * @param rom
+     * @param program recompiled ROM, required by Engine::kAot
+     * @param full_interval boundaries between two full state comparisons
+     */
+    Checker(Engine candidate,
+            std::span<const std::uint8_t> rom,
+            const aot::Program* program = nullptr,
+            std::size_t full_interval = kFullCompareInterval);
+
+    void press(std::uint16_t mask);
+
+    /**
+     * @brief Run one candidate step and as many reference instructions,
+     * each followed by its timer tick
+     *
+     * @return divergence, if any
+     */
+    std::optional<Divergence> step();
+
+    /**
+     * @brief Step until at least the given number of instructions retired
+     * since construction, the engines diverge or the candidate faults
+     *
+     * @param instructions
+     * @return divergence, if any
+     */
+    std::optional<Divergence> runUntil(std::uint64_t instructions);
+
+    [[nodiscard]] std::uint64_t instructions() const noexcept {
+        return instructions_;
+    }
+
+    /**
+     * @brief Instruction that stopped both engines, if any
+     *
+     * @return const fault::Fault&
+     */
+    [[nodiscard]] const fault::Fault& fault() const noexcept {
+        return candidate_.state().fault;
+    }
+
+    /**
+     * @brief Rolling hash of the candidate registers at every boundary so
+     * far. Depends on where the candidate ends its steps, so compare it across
+     * machines and builds of the same engine, not across engines.
+     */
+    [[nodiscard]] std::uint64_t signature() const noexcept {
+        return signature_.value();
+    }
+};
+
+/**
+ * @brief Decides which steps a production self-check verifies
+ */
+class Sampler {
+    std::uint32_t interval_;
+    std::uint32_t countdown_;
+
+   public:
+    /**
+     * @param interval verify one step in interval, 0 to never verify
+     */
+    explicit Sampler(const std::uint32_t interval = 0) noexcept
+        : interval_(interval), countdown_(interval) {}
+
+    [[nodiscard]] bool enabled() const noexcept { return interval_ != 0; }
+
+    bool due() noexcept {
+        if (interval_ == 0 || --countdown_ != 0) {
+            return false;
+        }
+        countdown_ = interval_;
+        return true;
+    }
+};
+
+}  // namespace emu::lockstep
+
+#endif /* CHIP_8_LOCKSTEP_HPP */
@@ -0,0 +1,210 @@
+#ifndef CHIP_8_NETPLAY_HPP
+#define CHIP_8_NETPLAY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/display.hpp"
+#include "chip_8/golden.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/predecoder.hpp"
+#include "chip_8/random.hpp"
+
+namespace emu::netplay {  // Two-player rollback sessions
+
+// Frames a session may run past the last remote input it received, and so
+// the most frames a misprediction rolls back
+constexpr std::size_t kMaxRollback = 8;
+
+// Frames of inputs and snapshots kept, enough for the rollback window, the
+// input delay and the inputs the peer has not acknowledged yet
+constexpr std::size_t kHistory = 32;
+static_assert((kHistory & (kHistory - 1)) == 0, "Ring indexed by masking");
+
+// Magic, acknowledged frame, first frame, count, then one mask per frame
+constexpr std::size_t kPacketHeaderSize = 13;
+constexpr std::size_t kMaxPacketSize =
+    kPacketHeaderSize + (kHistory * sizeof(keyboard::Type));
+
+using Packet = std::array<std::uint8_t, kMaxPacketSize>;
+
+struct Config {
+    // Frames the local keys are held back, hides that much latency without
+    // rolling back, clamped to kMaxRollback
+    std::size_t input_delay = 2;
+    // Instructions per 60 Hz frame, the same on both peers
+    std::size_t instructions_per_frame = golden::kInstructionsPerFrame;
+    // Cxkk generator, the same on both peers
+    std::uint32_t seed = random::kDefaultSeed;
+    random::Mode random = random::Mode::kXorshift;
+};
+
+struct Stats {
+    // Frames run for the first time
+    std::uint64_t frames{};
+    // Mispredicted remote inputs, and the frames run again to correct them
+    std::uint64_t rollbacks{};
+    std::uint64_t resimulated_frames{};
+    // Frames skipped waiting for the peer
+    std::uint64_t stalls{};
+    // Packets dropped as malformed
+    std::uint64_t invalid_packets{};
+};
+
+/**
+ * @brief Deterministic two-player session with rollback. Both peers run the
+ * same ROM and feed it the OR of both players' keys. Remote keys not yet
+ * received are predicted to stay as they last were. When a prediction turns
+ * out wrong, the session restores the snapshot taken before that frame and
+ * runs the frames since again, headless, with the keys now known.
+ *
+ * The machine state is trivially copyable and snapshotted every frame, so a
+ * full kMaxRollback correction costs a copy and a few hundred instructions.
+ * The session knows nothing about transport: write() fills the packet to
+ * send, read() takes one received.
+ */
+class Session {
+    // State at the start of a frame
+    struct Snapshot {
+        ChipState state;
+        std::size_t overshoot{};
+    };
+
+    Config config_;
+    ChipState state_;
+    std::size_t overshoot_{};
+    std::unique_ptr<predecoder::Program> program_;
+    std::unique_ptr<std::array<Snapshot, kHistory>> snapshots_;
+
+    std::array<keyboard::Type, kHistory> local_{};
+    std::array<keyboard::Type, kHistory> remote_{};
+    // Remote keys each frame was run with, to spot mispredictions
+    std::array<keyboard::Type, kHistory> used_{};
+
+    // Next frame to run
+    std::uint64_t frame_{};
+    // Local keys are known for frames before local_end_
+    std::uint64_t local_end_{};
+    // Remote keys are known for frames before confirmed_
+    std::uint64_t confirmed_{};
+    // Local keys the peer confirmed
+    std::uint64_t acknowledged_{};
+    // Earliest frame run with a wrong prediction, if any
+    std::uint64_t rollback_from_{};
+    bool rollback_{};
+
+    Stats stats_;
+
+    [[nodiscard]] keyboard::Type remoteKeys(
+        std::uint64_t frame) const noexcept;
+    void run(std::uint64_t frame) noexcept;
+    void restore(const Snapshot& snapshot) noexcept;
+
+   public:
+    /**
+     * @brief Start a session at frame 0
+     *
+     * @param rom
+     * @param config
+     * @throw RomSizeError
+     */
+    explicit Session(std::span<const std::uint8_t> rom, Config config = {});
+
+    /**
+     * @brief Restore and run again from the first frame run with a wrong
+     * prediction, if any. Otherwise only done by advance().
+     */
+    void synchronize() noexcept;
+
+    /**
+     * @brief Correct any misprediction, then run the next frame with the
+     * local keys. Skips the frame and returns false when it would run more
+     * than kMaxRollback frames past the remote keys received.
+     *
+     * @param local_keys
+     * @return whether a frame was run
+     */
+    bool advance(keyboard::Type local_keys) noexcept;
+
+    /**
+     * @brief Fill a packet with the local keys the peer has not confirmed
+     *
+     * @param packet
+     * @return bytes used
+     */
+    [[nodiscard]] std::size_t write(Packet& packet) const noexcept;
+
+    /**
+     * @brief Take in a packet from the peer. Malformed packets are counted
+     * and dropped, duplicated and reordered ones are harmless.
+     *
+     * @param packet
+     */
+    void read(std::span<const std::uint8_t> packet) noexcept;
+
+    [[nodiscard]] const ChipState& state() const noexcept { return state_; }
+    [[nodiscard]] const display::Display& display() const noexcept {
+        return state_.display;
+    }
+    [[nodiscard]] std::uint64_t frame() const noexcept { return frame_; }
+    [[nodiscard]] std::uint64_t confirmed() const noexcept {
+        return confirmed_;
+    }
+    [[nodiscard]] const Stats& stats() const noexcept { return stats_; }
+};
+
+/**
+ * @brief Non-blocking UDP socket exchanging session packets with one peer.
+ * Sessions are symmetric, both peers bind a port and connect to the other.
+ */
+class Connection {
+    int descriptor_{-1};
+
+   public:
+    /**
+     * @brief Bind a local port
+     *
+     * @param port 0 for any
+     * @throw NetplayError
+     */
+    explicit Connection(std::uint16_t port);
+    ~Connection();
+
+    Connection(const Connection&) = delete;
+    Connection(Connection&&) = delete;
+    Connection& operator=(const Connection&) = delete;
+    Connection& operator=(Connection&&) = delete;
+
+    /**
+     * @brief Local port, e.g. the one picked for port 0
+     *
+     * @return std::uint16_t
+     */
+    [[nodiscard]] std::uint16_t port() const;
+
+    /**
+     * @brief Send to and only receive from the peer
+     *
+     * @param host name or address
+     * @param port
+     * @throw NetplayError
+     */
+    void connect(const std::string& host, std::uint16_t port);
+
+    /**
+     * @brief Read every packet waiting, then send the session's. Never
+     * blocks, lost packets are made up for by the next ones.
+     *
+     * @param session
+     */
+    void exchange(Session& session) const noexcept;
+};
+
+}  // namespace emu::netplay
+
+#endif /* CHIP_8_NETPLAY_HPP */
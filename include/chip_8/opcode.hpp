@@ -0,0 +1,236 @@
+#ifndef CHIP_8_OPCODE_HPP
+#define CHIP_8_OPCODE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace emu::opcode {  // Opcode metadata
+
+/**
+ * @brief Identifier of every instruction known by the interpreter. Mirrors
+ * the handlers in instruction_set, plus kInvalid for unmapped bytecodes.
+ */
+enum class Id : std::uint8_t {
+    k0nnn,
+    k00E0,
+    k00EE,
+    k1nnn,
+    k2nnn,
+    k3xkk,
+    k4xkk,
+    k5xy0,
+    k6xkk,
+    k7xkk,
+    k8xy0,
+    k8xy1,
+    k8xy2,
+    k8xy3,
+    k8xy4,
+    k8xy5,
+    k8xy6,
+    k8xy7,
+    k8xyE,
+    k9xy0,
+    kAnnn,
+    kBnnn,
+    kCxkk,
+    kDxyn,
+    kEx9E,
+    kExA1,
+    kFx07,
+    kFx0A,
+    kFx15,
+    kFx18,
+    kFx1E,
+    kFx29,
+    kFx33,
+    kFx55,
+    kFx65,
+    kInvalid,
+};
+
+constexpr std::size_t kCount = static_cast<std::size_t>(Id::kInvalid) + 1;
+
+/**
+ * @brief Map a bytecode to its opcode identifier. Follows the same grouping
+ * as the interpreter decoder.
+ *
+ * @param bytecode
+ * @return Id
+ */
+constexpr Id identify(const std::uint16_t bytecode) noexcept {
+    switch (bytecode & 0xF000U) {
+        case 0x0000:
+            switch (bytecode & 0x0FFFU) {
+                case 0x00E0:
+                    return Id::k00E0;
+                case 0x00EE:
+                    return Id::k00EE;
+                default:
+                    return Id::k0nnn;
+            }
+        case 0x1000:
+            return Id::k1nnn;
+        case 0x2000:
+            return Id::k2nnn;
+        case 0x3000:
+            return Id::k3xkk;
+        case 0x4000:
+            return Id::k4xkk;
+        case 0x5000:
+            return Id::k5xy0;
+        case 0x6000:
+            return Id::k6xkk;
+        case 0x7000:
+            return Id::k7xkk;
+        case 0x8000:
+            switch (bytecode & 0x000FU) {
+                case 0x0000:
+                    return Id::k8xy0;
+                case 0x0001:
+                    return Id::k8xy1;
+                case 0x0002:
+                    return Id::k8xy2;
+                case 0x0003:
+                    return Id::k8xy3;
+                case 0x0004:
+                    return Id::k8xy4;
+                case 0x0005:
+                    return Id::k8xy5;
+                case 0x0006:
+                    return Id::k8xy6;
+                case 0x0007:
+                    return Id::k8xy7;
+                case 0x000E:
+                    return Id::k8xyE;
+                default:
+                    return Id::kInvalid;
+            }
+        case 0x9000:
+            return Id::k9xy0;
+        case 0xA000:
+            return Id::kAnnn;
+        case 0xB000:
+            return Id::kBnnn;
+        case 0xC000:
+            return Id::kCxkk;
+        case 0xD000:
+            return Id::kDxyn;
+        case 0xE000:
+            switch (bytecode & 0x00FFU) {
+                case 0x009E:
+                    return Id::kEx9E;
+                case 0x00A1:
+                    return Id::kExA1;
+                default:
+                    return Id::kInvalid;
+            }
+        case 0xF000:
+            switch (bytecode & 0x00FFU) {
+                case 0x0007:
+                    return Id::kFx07;
+                case 0x000A:
+                    return Id::kFx0A;
+                case 0x0015:
+                    return Id::kFx15;
+                case 0x0018:
+                    return Id::kFx18;
+                case 0x001E:
+                    return Id::kFx1E;
+                case 0x0029:
+                    return Id::kFx29;
+                case 0x0033:
+                    return Id::kFx33;
+                case 0x0055:
+                    return Id::kFx55;
+                case 0x0065:
+                    return Id::kFx65;
+                default:
+                    return Id::kInvalid;
+            }
+        default:
+            return Id::kInvalid;
+    }
+}
+
+namespace detail {
+constexpr std::array<std::string_view, kCount> kNames{
+    "0nnn", "00E0", "00EE", "1nnn", "2nnn", "3xkk", "4xkk", "5xy0", "6xkk",
+    "7xkk", "8xy0", "8xy1", "8xy2", "8xy3", "8xy4", "8xy5", "8xy6", "8xy7",
+    "8xyE", "9xy0", "Annn", "Bnnn", "Cxkk", "Dxyn", "Ex9E", "ExA1", "Fx07",
+    "Fx0A", "Fx15", "Fx18", "Fx1E", "Fx29", "Fx33", "Fx55", "Fx65", "invalid",
+};
+}  // namespace detail
+
+/**
+ * @brief Get the pattern name of an opcode (e.g. "Dxyn")
+ *
+ * @param id
+ * @return std::string_view
+ */
+constexpr std::string_view name(const Id id) noexcept {
+    return detail::kNames[static_cast<std::size_t>(id)];
+}
+
+/**
+ * @brief Get the position of an opcode in per-opcode tables
+ *
+ * @param id
+ * @return std::size_t
+ */
+constexpr std::size_t index(const Id id) noexcept {
+    return static_cast<std::size_t>(id);
+}
+
+/**
+ * @brief Whether execution may continue anywhere but the next instruction.
+ * Fx0A waits by rewinding the program counter, as do faulting instructions.
+ *
+ * @param id
+ * @return bool
+ */
+constexpr bool endsBlock(const Id id) noexcept {
+    switch (id) {
+        case Id::k00EE:
+        case Id::k1nnn:
+        case Id::k2nnn:
+        case Id::k3xkk:
+        case Id::k4xkk:
+        case Id::k5xy0:
+        case Id::k9xy0:
+        case Id::kBnnn:
+        case Id::kEx9E:
+        case Id::kExA1:
+        case Id::kFx0A:
+        case Id::kInvalid:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Whether the instruction reads or sets the timers or the random
+ * generator. Both tick once per retired instruction, and blocks only tick
+ * them after they exit, so these run alone in a block.
+ *
+ * @param id
+ * @return bool
+ */
+constexpr bool observesTime(const Id id) noexcept {
+    switch (id) {
+        case Id::kCxkk:
+        case Id::kFx07:
+        case Id::kFx15:
+        case Id::kFx18:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace emu::opcode
+
+#endif /* CHIP_8_OPCODE_HPP */
@@ -0,0 +1,167 @@
+#ifndef CHIP_8_PACING_HPP
+#define CHIP_8_PACING_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "chip_8/frontend.hpp"
+#include "chip_8/rom.hpp"
+
+namespace emu::pacing {  // Emulation speed
+
+using Clock = std::chrono::steady_clock;
+
+// Fastest and slowest speed multipliers
+constexpr double kMaxMultiplier = 64.0;
+constexpr double kMinMultiplier = 1.0 / 16.0;
+
+// Wall time of one presented frame when the frontend does not sync to the
+// display, and the slice run per frame in unlimited mode
+constexpr frontend::Duration kFrameInterval(1000.0 / 60.0);
+
+// Longest wall time paid back at once, so a stalled host does not cause a
+// burst of instructions
+constexpr frontend::Duration kMaxLag(100.0);
+
+// Instructions between two clock reads in unlimited mode
+constexpr std::size_t kClockCheckInterval = 256;
+
+// Window over which the achieved rate is measured
+constexpr frontend::Duration kRateWindow(500.0);
+
+/**
+ * @brief Holds a target rate of instructions per second with an accumulator:
+ * each frame is owed the instructions for the wall time since the previous
+ * one, and instructions run past the budget, e.g. by a block, are taken off
+ * the next. The rate follows real time however long frames take, so the
+ * caller never needs to sleep.
+ */
+class Governor {
+    double rate_{rom::kDefaultSpeed};
+    double multiplier_{1.0};
+    bool unlimited_{};
+
+    // Instructions owed, negative after running past a budget
+    double credit_{};
+    Clock::time_point last_;
+    bool scheduled_{};
+
+    // Set once the first frame opened a measurement window
+    bool measuring_{};
+    Clock::time_point window_start_;
+    std::uint64_t window_instructions_{};
+    double measured_rate_{};
+
+    void reschedule() noexcept { scheduled_ = false; }
+
+   public:
+    /**
+     * @brief Set the rate at 1x
+     *
+     * @param instructions_per_second
+     */
+    void setRate(const double instructions_per_second) noexcept {
+        rate_ = instructions_per_second;
+        reschedule();
+    }
+
+    /**
+     * @brief Run faster (turbo) or slower (slow motion) than the ROM's rate,
+     * clamped to [kMinMultiplier, kMaxMultiplier]
+     *
+     * @param multiplier
+     */
+    void setMultiplier(const double multiplier) noexcept {
+        multiplier_ = multiplier < kMinMultiplier   ? kMinMultiplier
+                      : multiplier > kMaxMultiplier ? kMaxMultiplier
+                                                    : multiplier;
+        reschedule();
+    }
+
+    /**
+     * @brief Run as fast as the host allows, kFrameInterval per frame
+     *
+     * @param unlimited
+     */
+    void setUnlimited(const bool unlimited) noexcept {
+        unlimited_ = unlimited;
+        reschedule();
+    }
+
+    [[nodiscard]] double multiplier() const noexcept { return multiplier_; }
+    [[nodiscard]] bool unlimited() const noexcept { return unlimited_; }
+
+    /**
+     * @brief Instructions per second aimed at, 0 when unlimited
+     *
+     * @return double
+     */
+    [[nodiscard]] double targetRate() const noexcept {
+        return unlimited_ ? 0.0 : rate_ * multiplier_;
+    }
+
+    /**
+     * @brief Instructions per second achieved over the last kRateWindow
+     *
+     * @return double
+     */
+    [[nodiscard]] double measuredRate() const noexcept {
+        return measured_rate_;
+    }
+
+    /**
+     * @brief Instructions owed for the wall time since the previous call, at
+     * most kMaxLag worth. The first call after a speed change starts a new
+     * schedule and owes nothing.
+     *
+     * @param now
+     * @return std::size_t
+     */
+    std::size_t owed(const Clock::time_point now) noexcept {
+        if (!scheduled_) {
+            last_ = now;
+            credit_ = 0.0;
+            scheduled_ = true;
+        }
+
+        const auto kElapsed =
+            std::min<frontend::Duration>(now - last_, kMaxLag);
+        last_ = now;
+        credit_ += std::chrono::duration<double>(kElapsed).count() *
+                   targetRate();
+        return credit_ > 0.0 ? static_cast<std::size_t>(credit_) : 0;
+    }
+
+    /**
+     * @brief Account for the instructions a frame retired
+     *
+     * @param retired
+     * @param now
+     */
+    void retire(const std::size_t retired,
+                const Clock::time_point now) noexcept {
+        credit_ -= static_cast<double>(retired);
+
+        // Nothing ran before the first frame, it opens the first window
+        if (!measuring_) {
+            measuring_ = true;
+            window_start_ = now;
+            return;
+        }
+
+        window_instructions_ += retired;
+        if (now - window_start_ >= kRateWindow) {
+            measured_rate_ =
+                static_cast<double>(window_instructions_) /
+                std::chrono::duration<double>(now - window_start_).count();
+            window_start_ = now;
+            window_instructions_ = 0;
+        }
+    }
+};
+
+}  // namespace emu::pacing
+
+#endif /* CHIP_8_PACING_HPP */
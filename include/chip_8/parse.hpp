@@ -0,0 +1,92 @@
+#ifndef CHIP_8_PARSE_HPP
+#define CHIP_8_PARSE_HPP
+
+#include <charconv>
+#include <cmath>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace emu::parse {  // Strict number parsing for settings and options
+
+/**
+ * @brief Parse the whole text as a number. Unlike strtoul and friends, a
+ * sign on an unsigned type, leading spaces, trailing characters or a value
+ * that does not fit are errors, and so are infinities and NaNs.
+ *
+ * @tparam Number integer or floating-point type
+ * @param text
+ * @param base of an integer, ignored for floating-point types
+ * @return std::optional<Number> empty when the text is not such a number
+ */
+template <typename Number>
+std::optional<Number> number(const std::string_view text,
+                             const int base = 10) {
+    Number value{};
+    const auto* const kEnd = text.data() + text.size();
+    std::from_chars_result result{};
+    if constexpr (std::is_floating_point_v<Number>) {
+        result = std::from_chars(text.data(), kEnd, value);
+    } else {
+        result = std::from_chars(text.data(), kEnd, value, base);
+    }
+    if (result.ec != std::errc() || result.ptr != kEnd) {
+        return std::nullopt;
+    }
+    if constexpr (std::is_floating_point_v<Number>) {
+        if (!std::isfinite(value)) {
+            return std::nullopt;
+        }
+    }
+    return value;
+}
+
+/**
+ * @brief Parse the whole text as a number in [low, high]
+ *
+ * @tparam Number integer or floating-point type
+ * @param text
+ * @param low
+ * @param high
+ * @param base of an integer, ignored for floating-point types
+ * @return std::optional<Number> empty when the text is not such a number
+ */
+template <typename Number>
+std::optional<Number> bounded(const std::string_view text,
+                              const Number low,
+                              const Number high,
+                              const int base = 10) {
+    const auto kValue = number<Number>(text, base);
+    if (!kValue || *kValue < low || *kValue > high) {
+        return std::nullopt;
+    }
+    return kValue;
+}
+
+/**
+ * @brief Parse the whole text as an integer literal: decimal, hexadecimal
+ * after 0x or binary after 0b
+ *
+ * @tparam Integer
+ * @param text
+ * @return std::optional<Integer> empty when the text is not such a number
+ */
+template <typename Integer>
+std::optional<Integer> literal(std::string_view text) {
+    int base = 10;
+    if (text.size() > 2 && text[0] == '0' &&
+        (text[1] == 'x' || text[1] == 'X')) {
+        base = 16;
+        text.remove_prefix(2);
+    } else if (text.size() > 2 && text[0] == '0' &&
+               (text[1] == 'b' || text[1] == 'B')) {
+        base = 2;
+        text.remove_prefix(2);
+    }
+    return number<Integer>(text, base);
+}
+
+}  // namespace emu::parse
+
+#endif /* CHIP_8_PARSE_HPP */
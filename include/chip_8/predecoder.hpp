@@ -0,0 +1,206 @@
+#ifndef CHIP_8_PREDECODER_HPP
+#define CHIP_8_PREDECODER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/opcode.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::predecoder {
+
+struct Op;
+
+using Handler = void (*)(ChipState& state, const Op& op) noexcept;
+
+// Longest instruction sequence fused into a single superinstruction
+constexpr std::size_t kMaxFusedLength = 3;
+
+/**
+ * @brief Decoded instruction, or fused sequence of instructions, ready to be
+ * dispatched without looking at memory again
+ */
+struct Op {
+    Handler handler;
+    std::array<std::uint16_t, kMaxFusedLength> bytecodes;
+    // Instructions covered by this op, 0 while not decoded yet
+    std::uint8_t length;
+    // Whether the op stores into memory (Fx33, Fx55)
+    bool writes_memory;
+};
+
+/**
+ * @brief Decode the instruction at address, fusing it with the following
+ * ones when they form a known sequence (6xkk;6xkk, Annn;Dxyn,
+ * 7xkk;3xkk;1nnn, Fx07;3xkk;1nnn)
+ *
+ * @param memory
+ * @param address
+ * @return Op
+ */
+Op decode(const memory::Type& memory, std::uint16_t address);
+
+/**
+ * @brief Decode a single instruction without fusion
+ *
+ * @param bytecode
+ * @return Op
+ */
+Op decodeSingle(std::uint16_t bytecode);
+
+/**
+ * @brief Read the bytecode at address, wrapping around the end of memory
+ *
+ * @param memory
+ * @param address
+ * @return std::uint16_t
+ */
+inline std::uint16_t bytecodeAt(const memory::Type& memory,
+                                const std::uint16_t address) {
+    return static_cast<std::uint16_t>(
+        (static_cast<unsigned int>(memory[address & kAddressMask])
+         << kByteWidth) |
+        static_cast<unsigned int>(memory[(address + 1U) & kAddressMask]));
+}
+
+/**
+ * @brief Range of memory written by a memory-writing op, computed from the
+ * state right before the op executes
+ *
+ * @param op
+ * @param state
+ * @return first written address and number of bytes written
+ */
+inline std::pair<std::uint16_t, std::uint16_t> writtenRange(
+    const Op& op,
+    const ChipState& state) {
+    const auto kBytecode = op.bytecodes[0];
+    const auto kLength = opcode::identify(kBytecode) == opcode::Id::kFx33
+                             ? std::uint16_t{3}
+                             : static_cast<std::uint16_t>(
+                                   getNibbleX(kBytecode) + 1U);
+    return {state.index_register, kLength};
+}
+
+/**
+ * @brief Execute an op located at the program counter. An op that faults
+ * counts as retired and leaves the program counter on itself.
+ *
+ * @param state
+ * @param op
+ * @return number of instructions retired
+ */
+inline std::size_t execute(ChipState& state, const Op& op) noexcept {
+    const auto kLength = op.length;
+
+    state.program_counter += static_cast<std::uint16_t>(2U * kLength);
+    const auto kEnd = state.program_counter;
+
+    op.handler(state, op);
+
+    // Falling through a skip;jump sequence means the jump was skipped
+    if (kLength == kMaxFusedLength && state.program_counter == kEnd) {
+        return kLength - 1U;
+    }
+    return kLength;
+}
+
+/**
+ * @brief Program predecoded per address. Slots are decoded on first
+ * execution and dropped whenever the bytes they were decoded from change,
+ * so jumps into the middle of a fused sequence and self-modifying code keep
+ * the reference semantics.
+ */
+class Program {
+    std::array<Op, memory::kSize> ops_{};
+
+   public:
+    /**
+     * @brief Eagerly decode every valid instruction in [begin, end)
+     *
+     * @param memory
+     * @param begin
+     * @param end
+     */
+    void predecode(const memory::Type& memory,
+                   std::uint16_t begin,
+                   std::uint16_t end);
+
+    /**
+     * @brief Decode every instruction static analysis found reachable,
+     * leaving data bytes alone
+     *
+     * @param memory
+     * @param analysis
+     */
+    void predecode(const memory::Type& memory,
+                   const analysis::Analysis& analysis);
+
+    /**
+     * @brief Drop every slot
+     *
+     */
+    void invalidate() noexcept;
+
+    /**
+     * @brief Drop every slot decoded from bytes in [address, address + size)
+     *
+     * @param address
+     * @param size
+     */
+    void invalidate(std::uint16_t address, std::uint16_t size) noexcept;
+
+    /**
+     * @brief Drop every slot decoded from bytes that differ between the
+     * memory the program was decoded from and the one it is moved to, e.g.
+     * when a machine is put back on a snapshot
+     *
+     * @param before
+     * @param after
+     */
+    void invalidate(const memory::Type& before,
+                    const memory::Type& after) noexcept;
+
+    /**
+     * @brief Get the op at address, decoding it if needed
+     *
+     * @param memory
+     * @param address
+     * @return const Op&
+     */
+    const Op& at(const memory::Type& memory, const std::uint16_t address) {
+        auto& op = ops_[address & kAddressMask];
+        if (op.length == 0) {
+            op = decode(memory, address);
+        }
+        return op;
+    }
+
+    /**
+     * @brief Execute the op at the program counter
+     *
+     * @param state
+     * @return number of instructions retired
+     */
+    std::size_t step(ChipState& state) {
+        const auto& op = at(state.memory, state.program_counter);
+
+        if (op.writes_memory) {
+            const auto [kAddress, kSize] = writtenRange(op, state);
+            const auto kRetired = execute(state, op);
+            invalidate(kAddress, kSize);
+            return kRetired;
+        }
+
+        return execute(state, op);
+    }
+};
+
+}  // namespace emu::predecoder
+
+#endif /* CHIP_8_PREDECODER_HPP */
@@ -0,0 +1,93 @@
+#ifndef CHIP_8_PROFILER_HPP
+#define CHIP_8_PROFILER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+#include "chip_8/memory.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::profiler {
+
+/**
+ * @brief ROM profiler. Counts executions per address and attributes them to
+ * the CHIP-8 call stack, mirroring ChipState::stack on every 2nnn and 00EE.
+ */
+class Profiler {
+    struct Frame {
+        // Entry address of the routine, memory::kProgramSpaceOffset at root
+        std::uint16_t address;
+        // Index of the caller frame, the root is its own parent
+        std::uint32_t parent;
+        // Instructions executed while this frame was on top of the stack
+        std::uint64_t samples;
+    };
+
+    std::array<std::uint64_t, memory::kSize> heat_{};
+    // Call tree, every distinct call path gets exactly one frame
+    std::vector<Frame> frames_;
+    // (parent frame << 16 | routine address) to child frame
+    std::unordered_map<std::uint64_t, std::uint32_t> children_;
+    std::uint32_t current_{};
+    std::size_t depth_{};
+
+    std::uint32_t enter(std::uint16_t address);
+
+   public:
+    Profiler();
+
+    /**
+     * @brief Account an instruction after it was executed
+     *
+     * @param address location the instruction was fetched from
+     * @param bytecode
+     */
+    void record(const std::uint16_t address, const std::uint16_t bytecode) {
+        heat_[address & kAddressMask] += 1;
+        frames_[current_].samples += 1;
+
+        if ((bytecode & 0xF000U) == 0x2000U) {
+            current_ = enter(getAddress(bytecode));
+            depth_ += 1;
+        } else if (bytecode == 0x00EEU && depth_ > 0) {
+            current_ = frames_[current_].parent;
+            depth_ -= 1;
+        }
+    }
+
+    /**
+     * @brief Executions per address over the whole memory
+     *
+     * @return const std::array<std::uint64_t, memory::kSize>&
+     */
+    [[nodiscard]] const std::array<std::uint64_t, memory::kSize>& heat()
+        const noexcept {
+        return heat_;
+    }
+
+    /**
+     * @brief Write one line per call path in the folded format read by
+     * flamegraph.pl and compatible tools ("main;sub_0234;sub_0310 42")
+     *
+     * @param output
+     */
+    void writeFolded(std::ostream& output) const;
+
+    /**
+     * @brief Write the address heat map as a 64x64 grayscale PGM image, one
+     * pixel per address, brightness on a logarithmic scale
+     *
+     * @param output
+     */
+    void writeHeatMap(std::ostream& output) const;
+
+    void reset();
+};
+
+}  // namespace emu::profiler
+
+#endif /* CHIP_8_PROFILER_HPP */
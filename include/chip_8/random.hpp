@@ -0,0 +1,138 @@
+#ifndef CHIP_8_RANDOM_HPP
+#define CHIP_8_RANDOM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace emu::random {  // Random numbers for Cxkk
+
+// Seed of a default-constructed generator, so runs are reproducible
+constexpr std::uint32_t kDefaultSeed = 0x2A6D365BU;
+
+enum class Mode : std::uint8_t {
+    // 32-bit xorshift, three shifts and xors per byte
+    kXorshift,
+    // Structure of the COSMAC VIP interpreter: a 16-bit register whose low
+    // byte counts timer ticks and indexes a page of bytes, the high byte
+    // accumulates them
+    kCosmacVip,
+};
+
+namespace detail {
+// Stands in for the interpreter code page the VIP reads. The original bytes
+// are not shipped, so VIP sequences follow its timing, not its exact values.
+constexpr std::array<std::uint8_t, 256> kVipPage = [] {
+    std::array<std::uint8_t, 256> page{};
+    std::uint32_t value = kDefaultSeed;
+    for (auto& byte : page) {
+        value = (value * 1103515245U) + 12345U;
+        byte = static_cast<std::uint8_t>(value >> 24U);
+    }
+    return page;
+}();
+}  // namespace detail
+
+/**
+ * @brief Byte generator behind Cxkk. Trivially copyable, its whole state
+ * packs into 64 bits for snapshots. The mode is a switch, not a virtual
+ * call, so next() inlines into the handler.
+ */
+class Generator {
+    std::uint32_t state_{kDefaultSeed};
+    Mode mode_{Mode::kXorshift};
+
+   public:
+    Generator() = default;
+
+    explicit Generator(const std::uint32_t value,
+                       const Mode mode = Mode::kXorshift) noexcept {
+        seed(value, mode);
+    }
+
+    /**
+     * @brief Restart the sequence
+     *
+     * @param value any seed, 0 is remapped as xorshift would get stuck on it
+     * @param mode
+     */
+    void seed(const std::uint32_t value,
+              const Mode mode = Mode::kXorshift) noexcept {
+        mode_ = mode;
+        state_ = mode == Mode::kCosmacVip ? (value & 0xFFFFU)
+                 : value == 0             ? kDefaultSeed
+                                          : value;
+    }
+
+    [[nodiscard]] Mode mode() const noexcept { return mode_; }
+
+    /**
+     * @brief Next random byte
+     *
+     * @return std::uint8_t
+     */
+    std::uint8_t next() noexcept {
+        switch (mode_) {
+            case Mode::kXorshift:
+                state_ ^= state_ << 13U;
+                state_ ^= state_ >> 17U;
+                state_ ^= state_ << 5U;
+                // The high bits are the best mixed
+                return static_cast<std::uint8_t>(state_ >> 24U);
+            case Mode::kCosmacVip: {
+                const auto kByte = static_cast<std::uint8_t>(
+                    detail::kVipPage[state_ & 0xFFU] + (state_ >> 8U));
+                state_ = (static_cast<std::uint32_t>(kByte) << 8U) |
+                         (state_ & 0xFFU);
+                return kByte;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Advance with the timers, only the VIP mode depends on time
+     *
+     * @param ticks
+     */
+    void tick(const std::size_t ticks) noexcept {
+        if (mode_ == Mode::kCosmacVip) {
+            state_ = (state_ & 0xFF00U) |
+                     static_cast<std::uint32_t>((state_ + ticks) & 0xFFU);
+        }
+    }
+
+    /**
+     * @brief Pack mode and state for a snapshot
+     *
+     * @return std::uint64_t
+     */
+    [[nodiscard]] std::uint64_t save() const noexcept {
+        return (static_cast<std::uint64_t>(mode_) << 32U) | state_;
+    }
+
+    /**
+     * @brief Unpack a snapshot taken by save()
+     *
+     * @param saved
+     * @return Generator
+     */
+    static Generator load(const std::uint64_t saved) noexcept {
+        Generator generator;
+        generator.mode_ = static_cast<Mode>((saved >> 32U) & 0xFFU) ==
+                                  Mode::kCosmacVip
+                              ? Mode::kCosmacVip
+                              : Mode::kXorshift;
+        generator.state_ = static_cast<std::uint32_t>(saved);
+        if (generator.mode_ == Mode::kXorshift && generator.state_ == 0) {
+            generator.state_ = kDefaultSeed;
+        }
+        return generator;
+    }
+
+    friend bool operator==(const Generator&, const Generator&) = default;
+};
+
+}  // namespace emu::random
+
+#endif /* CHIP_8_RANDOM_HPP */
@@ -0,0 +1,43 @@
+#ifndef CHIP_8_RECOMPILER_HPP
+#define CHIP_8_RECOMPILER_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+
+namespace emu::recompiler {
+
+using BasicBlock = analysis::Block;
+
+/**
+ * @brief Recover the basic blocks the recompiler emits, as found by
+ * analysis::analyse
+ *
+ * @param rom
+ * @return blocks sorted by entry address
+ * @throw RomSizeError if the ROM does not fit in memory
+ */
+std::vector<BasicBlock> findBlocks(std::span<const std::uint8_t> rom);
+
+/**
+ * @brief Write a C++ translation unit running the ROM's basic blocks on a
+ * ChipState. The unit defines `const emu::aot::Program& emu::aot::roms::name()`
+ * and is meant to be linked against the core library.
+ *
+ * @param output
+ * @param rom
+ * @param name identifier of the generated program
+ * @throw RomSizeError if the ROM does not fit in memory
+ * @throw std::invalid_argument if name is not a C++ identifier
+ */
+void emit(std::ostream& output,
+          std::span<const std::uint8_t> rom,
+          std::string_view name);
+
+}  // namespace emu::recompiler
+
+#endif /* CHIP_8_RECOMPILER_HPP */
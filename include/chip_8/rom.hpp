@@ -0,0 +1,232 @@
+#ifndef CHIP_8_ROM_HPP
+#define CHIP_8_ROM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "chip_8/memory.hpp"
+#include "chip_8/random.hpp"
+
+namespace emu::rom {  // ROM files and the ROM index
+
+// Program space from kProgramSpaceOffset to the end of memory, 3584 bytes
+constexpr std::size_t kMaxSize =
+    memory::kSize - memory::kProgramSpaceOffset;
+
+// Instructions per second at the pace of Chip8::cycle (1.43 ms each)
+constexpr std::uint32_t kDefaultSpeed = 700;
+
+/**
+ * @brief Read-only view of a whole file. Memory-mapped where the platform
+ * supports it, so scanning a directory does not copy every ROM.
+ */
+class Mapping {
+    const std::uint8_t* data_{};
+    std::size_t size_{};
+    // Contents when the file could not be mapped
+    std::vector<std::uint8_t> copy_;
+
+    void unmap() noexcept;
+
+   public:
+    /**
+     * @brief Map a file
+     *
+     * @param path
+     * @throw RomLoadError if the file cannot be opened or mapped
+     */
+    explicit Mapping(const std::filesystem::path& path);
+
+    Mapping(const Mapping&) = delete;
+    Mapping(Mapping&& other) noexcept;
+    Mapping& operator=(const Mapping&) = delete;
+    Mapping& operator=(Mapping&& other) noexcept;
+    ~Mapping();
+
+    [[nodiscard]] std::span<const std::uint8_t> bytes() const noexcept {
+        return {data_, size_};
+    }
+};
+
+/**
+ * @brief Reject ROMs that do not fit in program space
+ *
+ * @param rom
+ * @throw RomSizeError
+ */
+void check(std::span<const std::uint8_t> rom);
+
+/**
+ * @brief Read a ROM file
+ *
+ * @param path
+ * @return std::vector<std::uint8_t>
+ * @throw RomLoadError
+ * @throw RomSizeError
+ */
+std::vector<std::uint8_t> read(const std::filesystem::path& path);
+
+/**
+ * @brief FNV-1a hash of the ROM bytes, the same ROM has the same hash
+ * wherever it is stored
+ *
+ * @param rom
+ * @return std::uint64_t
+ */
+std::uint64_t contentHash(std::span<const std::uint8_t> rom);
+
+/**
+ * @brief How a ROM wants to be run
+ */
+struct Profile {
+    // Cxkk generator, the only behaviour the core lets ROMs pick so far
+    random::Mode random{random::Mode::kXorshift};
+    // Instructions per second
+    std::uint32_t speed{kDefaultSpeed};
+
+    friend bool operator==(const Profile&, const Profile&) = default;
+};
+
+/**
+ * @brief Summary of analysis::analyse, so a launcher can show it without
+ * reading the ROM
+ */
+struct Metadata {
+    std::uint32_t blocks{};
+    std::uint32_t code_bytes{};
+    std::uint32_t sprite_bytes{};
+    // Has Bnnn jumps, whose targets are only known at runtime
+    bool dynamic{};
+
+    friend bool operator==(const Metadata&, const Metadata&) = default;
+};
+
+/**
+ * @brief Indexed ROM. Path and modification time are those of the file it
+ * was last read from.
+ */
+struct Entry {
+    std::uint64_t hash{};
+    std::uint64_t size{};
+    std::int64_t modified{};
+    Profile profile;
+    Metadata metadata;
+    std::string path;
+};
+
+/**
+ * @brief Modification time of a file in the units of Entry::modified
+ *
+ * @param path
+ * @return 0 if the file cannot be queried
+ */
+std::int64_t modifiedTime(const std::filesystem::path& path);
+
+/**
+ * @brief Analyse a ROM for its index entry
+ *
+ * @param rom
+ * @return Metadata
+ * @throw RomSizeError
+ */
+Metadata describe(std::span<const std::uint8_t> rom);
+
+/**
+ * @brief File last read at an indexed path. Size and modification time
+ * tell whether the file changed since it was hashed.
+ */
+struct File {
+    std::uint64_t hash{};
+    std::uint64_t size{};
+    std::int64_t modified{};
+};
+
+/**
+ * @brief ROMs keyed by content hash, saved as one line per file. Copies of
+ * a ROM share its entry, and profiles follow a ROM when it is moved or
+ * renamed.
+ */
+class Index {
+    std::unordered_map<std::uint64_t, Entry> entries_;
+    // Every indexed path, several of them may hold the same ROM
+    std::unordered_map<std::string, File> files_;
+
+    void forget(const std::string& path);
+
+   public:
+    /**
+     * @brief Parse a saved index
+     *
+     * @param input
+     * @return Index
+     * @throw RomIndexFormatError
+     */
+    static Index load(std::istream& input);
+
+    void save(std::ostream& output) const;
+
+    /**
+     * @brief Get the entry of a ROM
+     *
+     * @param hash from contentHash
+     * @return entry, nullptr if the ROM is not indexed
+     */
+    [[nodiscard]] const Entry* find(std::uint64_t hash) const;
+
+    /**
+     * @brief Index the ROM found at path. A known ROM keeps its profile.
+     * Paths are stored absolute.
+     *
+     * @param path
+     * @param rom
+     * @param modified file time, as in Entry
+     * @return Entry&
+     * @throw RomSizeError
+     */
+    Entry& add(const std::filesystem::path& path,
+               std::span<const std::uint8_t> rom,
+               std::int64_t modified = 0);
+
+    /**
+     * @brief Set the profile of an indexed ROM
+     *
+     * @param hash
+     * @param profile
+     * @return false if the ROM is not indexed
+     */
+    bool setProfile(std::uint64_t hash, const Profile& profile);
+
+    /**
+     * @brief Bring the index in line with the .ch8 files under directory.
+     * Only new or modified files are read, entries whose file is gone are
+     * dropped.
+     *
+     * @param directory
+     * @return number of files read
+     */
+    std::size_t scan(const std::filesystem::path& directory);
+
+    /**
+     * @brief Number of ROMs, copies count once
+     *
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        return entries_.size();
+    }
+
+    [[nodiscard]] const std::unordered_map<std::uint64_t, Entry>& entries()
+        const noexcept {
+        return entries_;
+    }
+};
+
+}  // namespace emu::rom
+
+#endif /* CHIP_8_ROM_HPP */
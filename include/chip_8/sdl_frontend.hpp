@@ -0,0 +1,144 @@
+#ifndef CHIP_8_SDL_FRONTEND_HPP
+#define CHIP_8_SDL_FRONTEND_HPP
+
+#include <cstddef>
+#include <thread>
+
+#include "chip_8/display.hpp"
+#include "chip_8/frontend.hpp"
+#include "chip_8/keyboard.hpp"
+
+#include "SDL3/SDL_keyboard.h"
+#include "SDL3/SDL_render.h"
+#include "SDL3/SDL_video.h"
+
+namespace emu::frontend {
+
+/**
+ * @brief Window drawn with the SDL renderer, keys read from the SDL keyboard
+ * state while the window has focus. Call init() after SDL_Init. Presenting
+ * waits for the vertical blank, which paces the run loop, frames without a
+ * present sleep in wait() instead. Calls must come from the thread that
+ * initialized SDL.
+ */
+class Sdl {
+    SDL_Window* window_{};
+    SDL_Renderer* renderer_{};
+    // Whether presenting blocks until the vertical blank
+    bool vsync_{};
+    // Whether the window presented since the last wait()
+    bool presented_{};
+
+   public:
+    static constexpr bool kPaced = true;
+
+    Sdl() = default;
+    Sdl(const Sdl&) = delete;
+    Sdl(Sdl&&) = delete;
+    Sdl& operator=(const Sdl&) = delete;
+    Sdl& operator=(Sdl&&) = delete;
+
+    ~Sdl() {
+        if (renderer_ != nullptr) {
+            SDL_DestroyRenderer(renderer_);
+        }
+        if (window_ != nullptr) {
+            SDL_DestroyWindow(window_);
+        }
+    }
+
+    /**
+     * @brief Open the window
+     *
+     * @param vsync whether presenting waits for the vertical blank, only one
+     * of several windows presented in a row should
+     * @return true at success, false at failure
+     */
+    bool init(const bool vsync = true) {
+        if (!SDL_CreateWindowAndRenderer(
+                "Chip-8", display::kWidth * 10, display::kHeight * 10,
+                SDL_WINDOW_RESIZABLE, &window_, &renderer_)) {
+            return false;
+        }
+        if (!SDL_SetRenderScale(renderer_, 10.0F, 10.0F)) {
+            return false;
+        }
+        // Without vsync, e.g. on some virtual displays, wait() sleeps instead
+        vsync_ = vsync && SDL_SetRenderVSync(renderer_, 1);
+
+        return true;
+    }
+
+    void present(const display::Display& display) {
+        // Clear screen to black
+        SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
+        SDL_RenderClear(renderer_);
+
+        // Set drawing color to white (CHIP-8 foreground)
+        SDL_SetRenderDrawColor(renderer_, 255, 255, 255, 255);
+
+        // Draw pixels
+        for (std::size_t y = 0; y < display::kHeight; y++) {
+            for (std::size_t x = 0; x < display::kWidth; x++) {
+                if (display::pixel(display, x, y)) {
+                    // REVIEW: How expensive are these casts?
+                    SDL_RenderPoint(renderer_, static_cast<float>(x),
+                                    static_cast<float>(y));
+                }
+            }
+        }
+
+        // Update screen
+        SDL_RenderPresent(renderer_);
+        presented_ = true;
+    }
+
+    [[nodiscard]] keyboard::Type poll() const {
+        if (SDL_GetKeyboardFocus() != window_) {
+            return 0;
+        }
+        return keyboard::read(SDL_GetKeyboardState(NULL));
+    }
+
+    /**
+     * @brief Whether an event with this window ID is addressed to the window
+     *
+     * @param id
+     * @return bool
+     */
+    [[nodiscard]] bool owns(const SDL_WindowID id) const {
+        return SDL_GetWindowID(window_) == id;
+    }
+
+    // No audio device is opened yet, the gate is where one would start and
+    // stop the tone
+    void beep(const bool /* not used */) noexcept {}
+
+    /**
+     * @brief Whether presenting waited for the vertical blank since the last
+     * wait(), which then has nothing left to sleep off
+     *
+     * @return bool
+     */
+    [[nodiscard]] bool synced() const noexcept { return vsync_ && presented_; }
+
+    /**
+     * @brief Sleep off the rest of the frame, unless presenting already
+     * waited for the vertical blank. Static screens, e.g. a ROM waiting on
+     * Fx0A, present nothing, so they sleep too.
+     *
+     * @param duration
+     */
+    void wait(const Duration duration) {
+        if (!vsync_ || !presented_) {
+            std::this_thread::sleep_for(duration);
+        }
+        presented_ = false;
+    }
+};
+
+static_assert(Frontend<Sdl>);
+
+}  // namespace emu::frontend
+
+#endif /* CHIP_8_SDL_FRONTEND_HPP */
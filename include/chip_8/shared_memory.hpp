@@ -0,0 +1,135 @@
+#ifndef CHIP_8_SHARED_MEMORY_HPP
+#define CHIP_8_SHARED_MEMORY_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/display.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/registers.hpp"
+
+namespace emu::shared_memory {  // Live frames for other processes
+
+// "CHIP8SHM"
+constexpr std::uint64_t kMagic = 0x434849503853484DULL;
+constexpr std::uint32_t kVersion = 1;
+
+// Read attempts before giving up on a writer that keeps overtaking
+constexpr std::size_t kMaxReadAttempts = 64;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Atomics in shared memory must not need a lock");
+
+/**
+ * @brief Layout of the shared region. The payload is published under a
+ * seqlock: the sequence is odd while the writer updates it, readers retry
+ * when it was odd or moved while they copied. Payload words are relaxed
+ * atomics, so concurrent reads are torn at worst, never undefined.
+ */
+struct Region {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t size;
+
+    alignas(64) std::atomic<std::uint64_t> sequence;
+    // Frames published so far
+    std::atomic<std::uint64_t> frame;
+    // V0 to VF, eight per word
+    std::array<std::atomic<std::uint64_t>, registers::kNum / 8> registers;
+    // Program counter, index, delay and sound timers, keys
+    std::atomic<std::uint64_t> machine;
+    // Stack depth and fault status
+    std::atomic<std::uint64_t> status;
+    std::array<std::atomic<std::uint64_t>, display::kHeight> rows;
+};
+
+/**
+ * @brief Consistent copy of one published frame
+ */
+struct Snapshot {
+    std::uint64_t frame{};
+    registers::Type V{};
+    std::uint16_t program_counter{};
+    std::uint16_t index_register{};
+    std::uint8_t delay_timer{};
+    std::uint8_t sound_timer{};
+    keyboard::Type keys{};
+    std::uint8_t stack_size{};
+    fault::Status fault{};
+    display::Display display;
+};
+
+/**
+ * @brief Owns a POSIX shared-memory object and publishes frames into it.
+ * Publishing is a few dozen stores and never waits for readers.
+ */
+class Publisher {
+    std::string name_;
+    Region* region_{};
+
+   public:
+    /**
+     * @brief Create or take over a shared-memory object
+     *
+     * @param name shm_open name, e.g. "/chip-8"
+     * @throw SharedMemoryError
+     */
+    explicit Publisher(std::string name);
+
+    Publisher(const Publisher&) = delete;
+    Publisher(Publisher&&) = delete;
+    Publisher& operator=(const Publisher&) = delete;
+    Publisher& operator=(Publisher&&) = delete;
+    // Unlinks the object, mapped readers keep their view
+    ~Publisher();
+
+    void publish(const ChipState& state) noexcept;
+};
+
+/**
+ * @brief Read-only view of a publisher's region
+ */
+class Subscriber {
+    const Region* region_{};
+
+   public:
+    /**
+     * @brief Map the object of a running publisher
+     *
+     * @param name
+     * @throw SharedMemoryError if it does not exist or has another layout
+     */
+    explicit Subscriber(const std::string& name);
+
+    Subscriber(const Subscriber&) = delete;
+    Subscriber(Subscriber&&) = delete;
+    Subscriber& operator=(const Subscriber&) = delete;
+    Subscriber& operator=(Subscriber&&) = delete;
+    ~Subscriber();
+
+    /**
+     * @brief Frames published so far, cheap enough to poll for new frames
+     *
+     * @return std::uint64_t
+     */
+    [[nodiscard]] std::uint64_t frame() const noexcept {
+        return region_->frame.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Copy the latest frame
+     *
+     * @param snapshot left unchanged on failure
+     * @return false if the writer overtook every attempt
+     */
+    bool read(Snapshot& snapshot) const noexcept;
+};
+
+}  // namespace emu::shared_memory
+
+#endif /* CHIP_8_SHARED_MEMORY_HPP */
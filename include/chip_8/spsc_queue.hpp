@@ -0,0 +1,93 @@
+#ifndef CHIP_8_SPSC_QUEUE_HPP
+#define CHIP_8_SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace emu {
+
+// Typical destructive interference size, kept local for portability
+constexpr std::size_t kCacheLineSize = 64;
+
+/**
+ * @brief Bounded lock-free single-producer single-consumer queue
+ *
+ * @tparam T trivially copyable element
+ * @tparam kCapacity number of slots, must be a power of two
+ */
+template <typename T, std::size_t kCapacity>
+class SpscQueue {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(kCapacity != 0 && (kCapacity & (kCapacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+    static constexpr std::size_t kMask = kCapacity - 1;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+    alignas(kCacheLineSize) std::size_t cached_tail_{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+    alignas(kCacheLineSize) std::size_t cached_head_{0};
+    alignas(kCacheLineSize) std::array<T, kCapacity> slots_{};
+
+   public:
+    /**
+     * @brief Enqueue an element. Producer side only.
+     *
+     * @param value
+     * @return false if the queue is full
+     */
+    bool push(const T& value) noexcept {
+        const auto kHead = head_.load(std::memory_order_relaxed);
+        if (kHead - cached_tail_ == kCapacity) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (kHead - cached_tail_ == kCapacity) {
+                return false;
+            }
+        }
+
+        slots_[kHead & kMask] = value;
+        head_.store(kHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Dequeue up to output.size() elements. Consumer side only.
+     *
+     * @param output
+     * @return number of elements dequeued
+     */
+    std::size_t pop(std::span<T> output) noexcept {
+        const auto kTail = tail_.load(std::memory_order_relaxed);
+        if (cached_head_ == kTail) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (cached_head_ == kTail) {
+                return 0;
+            }
+        }
+
+        const auto kAvailable = cached_head_ - kTail;
+        const auto kCount =
+            kAvailable < output.size() ? kAvailable : output.size();
+        for (std::size_t idx = 0; idx < kCount; idx++) {
+            output[idx] = slots_[(kTail + idx) & kMask];
+        }
+
+        tail_.store(kTail + kCount, std::memory_order_release);
+        return kCount;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() noexcept { return kCapacity; }
+};
+
+}  // namespace emu
+
+#endif /* CHIP_8_SPSC_QUEUE_HPP */
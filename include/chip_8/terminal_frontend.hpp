@@ -0,0 +1,101 @@
+#ifndef CHIP_8_TERMINAL_FRONTEND_HPP
+#define CHIP_8_TERMINAL_FRONTEND_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "chip_8/display.hpp"
+#include "chip_8/frontend.hpp"
+#include "chip_8/keyboard.hpp"
+
+namespace emu::frontend {
+
+// Terminals only report presses, a key counts as held this long after its
+// last press or auto-repeat
+constexpr auto kKeyHold = std::chrono::milliseconds(250);
+
+// Unchanged cells rewritten rather than jumped over, a cursor movement
+// costs more bytes than a few cells
+constexpr std::size_t kMaxRewrittenCells = 3;
+
+/**
+ * @brief Display drawn with ANSI escape codes and half-block characters, two
+ * pixel rows per line, keys read from a terminal in raw mode. The keypad is
+ * mapped on the same keys as the SDL frontend (1234, QWER, ASDF, ZXCV).
+ *
+ * Frames are diffed against the one on screen and only changed cells are
+ * written, so a static screen costs nothing and a moving sprite a few dozen
+ * bytes, which keeps 60 fps cheap over SSH.
+ */
+class Terminal {
+    struct RawMode;
+
+    std::ostream& output_;
+    int input_;
+    // Restores the input terminal, null when it was not a terminal
+    std::unique_ptr<RawMode> raw_mode_;
+    std::array<std::chrono::steady_clock::time_point, keyboard::kNumKeys>
+        held_until_{};
+    // What the terminal shows, blank after the screen is cleared
+    display::Display shown_;
+    // Where the terminal cursor was left, in cells
+    std::size_t cursor_line_{};
+    std::size_t cursor_column_{};
+    // Reused between frames so presenting does not allocate
+    std::string frame_;
+
+    void appendCell(const display::Display& display,
+                    std::size_t line,
+                    std::size_t column);
+
+   public:
+    static constexpr bool kPaced = true;
+    static constexpr int kNoInput = -1;
+    static constexpr int kStandardInput = 0;
+
+    /**
+     * @brief Take over a terminal until destroyed
+     *
+     * @param output
+     * @param input file descriptor keys are read from, kNoInput for none
+     */
+    explicit Terminal(std::ostream& output, int input = kNoInput);
+
+    Terminal(const Terminal&) = delete;
+    Terminal(Terminal&&) = delete;
+    Terminal& operator=(const Terminal&) = delete;
+    Terminal& operator=(Terminal&&) = delete;
+    ~Terminal();
+
+    /**
+     * @brief Write the cells that differ from the screen, in one write
+     *
+     * @param display
+     */
+    void present(const display::Display& display);
+
+    [[nodiscard]] keyboard::Type poll();
+
+    // Rings the bell when the gate opens
+    void beep(bool on);
+
+    void wait(Duration duration);
+
+    /**
+     * @brief Press a key as if it was typed, e.g. for keys received from
+     * elsewhere than the input descriptor
+     *
+     * @param character
+     */
+    void type(char character);
+};
+
+static_assert(Frontend<Terminal>);
+
+}  // namespace emu::frontend
+
+#endif /* CHIP_8_TERMINAL_FRONTEND_HPP */
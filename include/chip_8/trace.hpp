@@ -0,0 +1,224 @@
+#ifndef CHIP_8_TRACE_HPP
+#define CHIP_8_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/registers.hpp"
+#include "chip_8/spsc_queue.hpp"
+
+namespace emu::trace {
+
+/**
+ * @brief State of the machine right after an instruction was executed
+ */
+struct Record {
+    // Instructions executed since the trace started, wraps at 2^32
+    std::uint32_t sequence;
+    // Location the instruction was fetched from
+    std::uint16_t address;
+    std::uint16_t bytecode;
+    std::uint16_t index_register;
+    // Bit n is set when Vn was changed by the instruction
+    std::uint16_t changed;
+    std::uint8_t delay_timer;
+    std::uint8_t sound_timer;
+    std::uint8_t stack_depth;
+    std::uint8_t reserved;
+    registers::Type V;
+};
+
+static_assert(sizeof(Record) == 32, "Trace records must stay fixed-size");
+
+/**
+ * @brief Serialize records to a trace stream. Raw traces store every record
+ * as 32 little-endian bytes, compressed traces only store the fields that
+ * differ from the previous record.
+ */
+class Writer {
+    std::ostream& output_;
+    bool compressed_;
+    Record previous_;
+    std::vector<std::uint8_t> buffer_;
+
+    void encodeRaw(const Record& record);
+    void encodeCompressed(const Record& record);
+
+   public:
+    Writer(std::ostream& output, bool compressed);
+
+    void write(std::span<const Record> records);
+};
+
+/**
+ * @brief Deserialize records from a trace stream written by Writer
+ */
+class Reader {
+    std::istream& input_;
+    bool compressed_{};
+    Record previous_;
+
+    bool decodeRaw(Record& record);
+    bool decodeCompressed(Record& record);
+
+   public:
+    /**
+     * @brief Read and validate the trace header
+     *
+     * @throw TraceFormatError if the stream is not a trace
+     */
+    explicit Reader(std::istream& input);
+
+    [[nodiscard]] bool compressed() const noexcept { return compressed_; }
+
+    /**
+     * @brief Read the next record
+     *
+     * @param record
+     * @return false at end of trace
+     * @throw TraceFormatError if the trace is truncated
+     */
+    bool next(Record& record);
+};
+
+/**
+ * @brief Records every executed instruction into a lock-free queue and
+ * streams it to a file from a background thread. If the writer falls
+ * behind, the interpreter waits up to kMaxStall for a free slot, counted in
+ * stalls(); records that still find the queue full are dropped, counted in
+ * dropped(), and the interpreter stops waiting until the writer catches up.
+ * Dropped records show up as gaps in Record::sequence.
+ */
+class Recorder {
+    // 2 MiB of records, about a second of unthrottled execution
+    static constexpr std::size_t kQueueCapacity = 1U << 16U;
+    // Three frames at 60 Hz
+    static constexpr std::chrono::milliseconds kMaxStall{50};
+
+    std::ofstream file_;
+    Writer writer_;
+    SpscQueue<Record, kQueueCapacity> queue_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+
+    registers::Type before_{};
+    std::uint32_t sequence_{};
+    std::uint64_t stalls_{};
+    std::uint64_t dropped_{};
+    // Set once a wait timed out, cleared by the next record that fits
+    bool behind_{};
+    // Set by the writer thread once the file could not be written
+    std::atomic<bool> failed_{false};
+
+    void drain();
+
+   public:
+    /**
+     * @brief Start a trace
+     *
+     * @param path destination file, truncated
+     * @param compressed delta-encode records
+     * @throw std::ios_base::failure if the file cannot be opened
+     */
+    Recorder(const std::filesystem::path& path, bool compressed);
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+    Recorder(Recorder&&) = delete;
+    Recorder& operator=(Recorder&&) = delete;
+
+    /**
+     * @brief Write the records still queued and stop the writer thread. Does
+     * nothing once stopped.
+     *
+     */
+    void finish();
+
+    /**
+     * @brief Capture the state an instruction starts from
+     *
+     * @param state
+     */
+    void begin(const ChipState& state) noexcept { before_ = state.V; }
+
+    /**
+     * @brief Enqueue the record of the instruction started with begin()
+     *
+     * @param address location the instruction was fetched from
+     * @param bytecode
+     * @param state state after the instruction
+     */
+    void end(const std::uint16_t address,
+             const std::uint16_t bytecode,
+             const ChipState& state) noexcept {
+        Record record{};
+        record.sequence = sequence_++;
+        record.address = address;
+        record.bytecode = bytecode;
+        record.index_register = state.index_register;
+        record.delay_timer = state.delay_timer;
+        record.sound_timer = state.sound_timer;
+        record.stack_depth = static_cast<std::uint8_t>(state.stack.size());
+        record.V = state.V;
+        for (std::size_t idx = 0; idx < registers::kNum; idx++) {
+            if (before_[idx] != state.V[idx]) {
+                record.changed |= static_cast<std::uint16_t>(1U << idx);
+            }
+        }
+
+        if (queue_.push(record)) {
+            behind_ = false;
+            return;
+        }
+        if (!behind_) {
+            stalls_ += 1;
+            const auto kDeadline = std::chrono::steady_clock::now() + kMaxStall;
+            do {
+                std::this_thread::yield();
+                if (queue_.push(record)) {
+                    return;
+                }
+            } while (std::chrono::steady_clock::now() < kDeadline);
+            behind_ = true;
+        }
+        dropped_ += 1;
+    }
+
+    /**
+     * @brief Number of times the interpreter waited for the writer thread
+     *
+     * @return std::uint64_t
+     */
+    [[nodiscard]] std::uint64_t stalls() const noexcept { return stalls_; }
+
+    /**
+     * @brief Number of records lost because the writer thread fell behind
+     *
+     * @return std::uint64_t
+     */
+    [[nodiscard]] std::uint64_t dropped() const noexcept { return dropped_; }
+
+    /**
+     * @brief Whether writing the file failed, records queued since are lost
+     *
+     * @return bool
+     */
+    [[nodiscard]] bool failed() const noexcept {
+        return failed_.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace emu::trace
+
+#endif /* CHIP_8_TRACE_HPP */
@@ -0,0 +1,84 @@
+#ifndef CHIP_8_WORKER_POOL_HPP
+#define CHIP_8_WORKER_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "chip_8/spsc_queue.hpp"
+
+namespace emu {
+
+/**
+ * @brief Fixed set of threads running one range-splitting job at a time.
+ * Jobs are handed over through atomics rather than a task queue, so running
+ * one neither allocates nor locks. The calling thread takes the first chunk.
+ */
+class WorkerPool {
+    using Trampoline = void (*)(void* context,
+                                std::size_t begin,
+                                std::size_t end);
+
+    // Job being run, written before generation_ is bumped
+    Trampoline task_{};
+    void* context_{};
+    std::size_t size_{};
+
+    alignas(kCacheLineSize) std::atomic<std::uint32_t> generation_{0};
+    alignas(kCacheLineSize) std::atomic<std::size_t> pending_{0};
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
+
+    void work(std::size_t chunk);
+    void runChunk(std::size_t chunk) const noexcept;
+    void dispatch() noexcept;
+
+   public:
+    /**
+     * @brief Start the workers
+     *
+     * @param threads total threads including the caller, 0 for one per
+     * hardware thread
+     */
+    explicit WorkerPool(std::size_t threads = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    /**
+     * @brief Threads sharing a job, the caller included
+     *
+     * @return std::size_t
+     */
+    [[nodiscard]] std::size_t size() const noexcept {
+        return threads_.size() + 1;
+    }
+
+    /**
+     * @brief Split [0, size) into one contiguous chunk per thread and call
+     * task(begin, end) on each, returning once all chunks are done. Not
+     * reentrant: one job at a time.
+     *
+     * @param size
+     * @param task must not throw
+     */
+    template <typename Task>
+    void run(const std::size_t size, Task& task) noexcept {
+        task_ = [](void* context, const std::size_t begin,
+                   const std::size_t end) {
+            (*static_cast<Task*>(context))(begin, end);
+        };
+        context_ = &task;
+        size_ = size;
+        dispatch();
+    }
+};
+
+}  // namespace emu
+
+#endif /* CHIP_8_WORKER_POOL_HPP */
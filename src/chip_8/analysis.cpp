@@ -0,0 +1,541 @@
+#include "chip_8/analysis.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chip_8/error.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/opcode.hpp"
+#include "chip_8/predecoder.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::analysis {
+
+namespace {
+
+using Entries = std::bitset<memory::kSize>;
+
+// Value of a tracked I register that is not a constant
+constexpr std::uint32_t kUnknownIndex = UINT32_MAX;
+
+// Whether a whole instruction can be fetched from the ROM at address
+bool contains(const Analysis& analysis, const std::uint32_t address) {
+    return address >= analysis.begin && address + 2U <= analysis.end;
+}
+
+std::uint16_t at(const Analysis& analysis, const std::uint32_t address) {
+    return predecoder::bytecodeAt(analysis.memory,
+                                  static_cast<std::uint16_t>(address));
+}
+
+/**
+ * @brief Addresses execution can reach from an instruction, other than
+ * falling through to the next one
+ *
+ * @param address
+ * @param bytecode
+ * @return targets, at most two
+ */
+std::vector<std::uint32_t> targets(const std::uint32_t address,
+                                   const std::uint16_t bytecode) {
+    switch (opcode::identify(bytecode)) {
+        case opcode::Id::k1nnn:
+            return {getAddress(bytecode)};
+        case opcode::Id::k2nnn:
+            // The return site is entered from 00EE
+            return {getAddress(bytecode), address + 2U};
+        case opcode::Id::k3xkk:
+        case opcode::Id::k4xkk:
+        case opcode::Id::k5xy0:
+        case opcode::Id::k9xy0:
+        case opcode::Id::kEx9E:
+        case opcode::Id::kExA1:
+            return {address + 2U, address + 4U};
+        case opcode::Id::kFx0A:
+            // Waiting rewinds to the instruction itself
+            return {address, address + 2U};
+        default:
+            return {};
+    }
+}
+
+/**
+ * @brief Block entry addresses, found by following every static control
+ * transfer from the start of the ROM
+ *
+ * @param analysis
+ * @return Entries
+ */
+Entries findEntries(const Analysis& analysis) {
+    Entries entries;
+    Entries visited;
+    std::vector<std::uint32_t> pending;
+
+    const auto enter = [&](const std::uint32_t address) {
+        if (contains(analysis, address) && !entries.test(address)) {
+            entries.set(address);
+            pending.push_back(address);
+        }
+    };
+    enter(analysis.begin);
+
+    while (!pending.empty()) {
+        auto address = pending.back();
+        pending.pop_back();
+
+        while (contains(analysis, address) && !visited.test(address)) {
+            visited.set(address);
+
+            const auto kBytecode = at(analysis, address);
+            for (const auto kTarget : targets(address, kBytecode)) {
+                enter(kTarget);
+            }
+            if (opcode::endsBlock(opcode::identify(kBytecode))) {
+                break;
+            }
+            address += 2U;
+        }
+    }
+
+    return entries;
+}
+
+/**
+ * @brief Mark the ROM bytes an instruction reads or writes through I, when
+ * I holds a constant
+ *
+ * @param analysis
+ * @param bytecode
+ * @param index
+ */
+void classify(Analysis& analysis,
+              const std::uint16_t bytecode,
+              std::uint32_t& index) {
+    const auto kX = static_cast<unsigned int>(getNibbleX(bytecode));
+
+    const auto mark = [&](const unsigned int size, const Byte kind) {
+        for (unsigned int offset = 0; offset < size; offset++) {
+            const auto kAddress = index + offset;
+            if (kAddress >= analysis.begin && kAddress < analysis.end &&
+                analysis.bytes[kAddress] != Byte::kCode) {
+                analysis.bytes[kAddress] = kind;
+            }
+        }
+    };
+
+    switch (opcode::identify(bytecode)) {
+        case opcode::Id::kAnnn:
+            index = getAddress(bytecode);
+            return;
+        case opcode::Id::kFx1E:
+        case opcode::Id::kFx29:
+            index = kUnknownIndex;
+            return;
+        default:
+            break;
+    }
+
+    if (index == kUnknownIndex) {
+        return;
+    }
+
+    switch (opcode::identify(bytecode)) {
+        case opcode::Id::kDxyn:
+            mark(getNibbleN(bytecode), Byte::kSprite);
+            break;
+        case opcode::Id::kFx33:
+            mark(3U, Byte::kData);
+            break;
+        case opcode::Id::kFx55:
+        case opcode::Id::kFx65:
+            mark(kX + 1U, Byte::kData);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Build the block starting at entry
+ *
+ * @param analysis
+ * @param entries
+ * @param entry
+ * @return Block
+ */
+Block scan(Analysis& analysis, const Entries& entries, const std::uint32_t entry) {
+    Block block{static_cast<std::uint16_t>(entry), 0, {}, {}, false, false,
+                false};
+
+    const auto follow = [&](const std::uint32_t target) {
+        if (entries.test(target & kAddressMask)) {
+            block.successors.push_back(static_cast<std::uint16_t>(target));
+        }
+    };
+
+    // I is only tracked within a block
+    std::uint32_t index = kUnknownIndex;
+    auto address = entry;
+    while (contains(analysis, address)) {
+        const auto kBytecode = at(analysis, address);
+        const auto kId = opcode::identify(kBytecode);
+
+        analysis.bytes[address] = Byte::kCode;
+        analysis.bytes[address + 1U] = Byte::kCode;
+        classify(analysis, kBytecode, index);
+
+        if (kId == opcode::Id::k2nnn) {
+            block.call = getAddress(kBytecode);
+            follow(address + 2U);
+        } else {
+            for (const auto kTarget : targets(address, kBytecode)) {
+                follow(kTarget);
+            }
+        }
+        block.dynamic = kId == opcode::Id::kBnnn;
+
+        address += 2U;
+        if (opcode::endsBlock(kId)) {
+            break;
+        }
+        // A block may run up to the end of memory
+        if (address < memory::kSize && entries.test(address)) {
+            follow(address);
+            break;
+        }
+    }
+
+    block.end = static_cast<std::uint16_t>(address);
+    return block;
+}
+
+/**
+ * @brief Flag loop headers and record back edges with a depth-first walk
+ * from the ROM entry
+ *
+ * @param analysis
+ */
+void findLoops(Analysis& analysis) {
+    if (analysis.blocks.empty()) {
+        return;
+    }
+
+    const auto position = [&](const std::uint16_t entry) {
+        return static_cast<std::size_t>(std::distance(
+            analysis.blocks.begin(),
+            std::ranges::lower_bound(analysis.blocks, entry, {},
+                                     &Block::entry)));
+    };
+
+    const auto edges = [&](const Block& block) {
+        auto result = block.successors;
+        if (block.call && analysis.find(*block.call) != nullptr) {
+            result.push_back(*block.call);
+        }
+        return result;
+    };
+
+    enum class Mark : std::uint8_t { kNew, kOpen, kDone };
+    std::vector<Mark> marks(analysis.blocks.size(), Mark::kNew);
+
+    // Block and index of its next edge to visit
+    std::vector<std::pair<std::size_t, std::size_t>> stack{{0, 0}};
+    marks[0] = Mark::kOpen;
+
+    while (!stack.empty()) {
+        auto& [node, next] = stack.back();
+        const auto kEdges = edges(analysis.blocks[node]);
+
+        if (next == kEdges.size()) {
+            marks[node] = Mark::kDone;
+            stack.pop_back();
+            continue;
+        }
+
+        const auto kTarget = position(kEdges[next]);
+        next += 1;
+
+        if (marks[kTarget] == Mark::kOpen) {
+            analysis.blocks[kTarget].loop_header = true;
+            analysis.back_edges.emplace_back(analysis.blocks[node].entry,
+                                             analysis.blocks[kTarget].entry);
+        } else if (marks[kTarget] == Mark::kNew) {
+            marks[kTarget] = Mark::kOpen;
+            stack.emplace_back(kTarget, 0);
+        }
+    }
+}
+
+std::string label(const Analysis& analysis, const Block& block) {
+    if (block.entry == analysis.begin) {
+        return "start";
+    }
+    if (block.subroutine) {
+        return std::format("sub_{:03X}", block.entry);
+    }
+    if (block.loop_header) {
+        return std::format("loop_{:03X}", block.entry);
+    }
+    return std::format("L_{:03X}", block.entry);
+}
+
+std::string_view describe(const Byte kind) {
+    switch (kind) {
+        case Byte::kSprite:
+            return "sprite";
+        case Byte::kData:
+            return "data";
+        default:
+            return "unreachable";
+    }
+}
+
+/**
+ * @brief List the bytes in [begin, end) that are not code, grouped by kind
+ *
+ * @param output
+ * @param analysis
+ * @param begin
+ * @param end
+ */
+void writeData(std::ostream& output,
+               const Analysis& analysis,
+               const std::uint32_t begin,
+               const std::uint32_t end) {
+    constexpr std::uint32_t kRowSize = 8;
+
+    auto address = begin;
+    while (address < end) {
+        const auto kKind = analysis.bytes[address];
+        auto row_end = address;
+        while (row_end < end && row_end - address < kRowSize &&
+               analysis.bytes[row_end] == kKind) {
+            row_end++;
+        }
+
+        std::string bytes;
+        for (auto byte = address; byte < row_end; byte++) {
+            bytes += std::format("{}{:02X}", byte == address ? "" : " ",
+                                 analysis.memory[byte]);
+        }
+        output << std::format("    0x{:03X}  {:<23}  ; {}\n", address, bytes,
+                              describe(kKind));
+        address = row_end;
+    }
+}
+
+}  // namespace
+
+const Block* Analysis::find(const std::uint16_t entry) const {
+    const auto kFound = std::ranges::lower_bound(blocks, entry, {},
+                                                 &Block::entry);
+    if (kFound == blocks.end() || kFound->entry != entry) {
+        return nullptr;
+    }
+    return &*kFound;
+}
+
+Analysis analyse(const std::span<const std::uint8_t> rom) {
+    if (rom.size() > memory::kSize - memory::kProgramSpaceOffset) {
+        throw RomSizeError(rom.size());
+    }
+
+    Analysis analysis;
+    std::ranges::copy(rom, std::next(analysis.memory.begin(),
+                                     memory::kProgramSpaceOffset));
+    analysis.end = static_cast<std::uint16_t>(analysis.begin + rom.size());
+
+    const auto kEntries = findEntries(analysis);
+    for (std::uint32_t entry = analysis.begin; entry < analysis.end; entry++) {
+        if (kEntries.test(entry)) {
+            analysis.blocks.push_back(scan(analysis, kEntries, entry));
+        }
+    }
+
+    for (const auto& block : analysis.blocks) {
+        if (block.call) {
+            const auto kSubroutine = std::ranges::lower_bound(
+                analysis.blocks, *block.call, {}, &Block::entry);
+            if (kSubroutine != analysis.blocks.end() &&
+                kSubroutine->entry == *block.call) {
+                kSubroutine->subroutine = true;
+            }
+        }
+    }
+
+    findLoops(analysis);
+    return analysis;
+}
+
+std::string disassemble(const std::uint16_t bytecode) {
+    const auto kX = getNibbleX(bytecode);
+    const auto kY = getNibbleY(bytecode);
+    const auto kByte = getLowByte(bytecode);
+    const auto kAddress = getAddress(bytecode);
+
+    switch (opcode::identify(bytecode)) {
+        case opcode::Id::k0nnn:
+            return std::format("SYS 0x{:03X}", kAddress);
+        case opcode::Id::k00E0:
+            return "CLS";
+        case opcode::Id::k00EE:
+            return "RET";
+        case opcode::Id::k1nnn:
+            return std::format("JP 0x{:03X}", kAddress);
+        case opcode::Id::k2nnn:
+            return std::format("CALL 0x{:03X}", kAddress);
+        case opcode::Id::k3xkk:
+            return std::format("SE V{:X}, 0x{:02X}", kX, kByte);
+        case opcode::Id::k4xkk:
+            return std::format("SNE V{:X}, 0x{:02X}", kX, kByte);
+        case opcode::Id::k5xy0:
+            return std::format("SE V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k6xkk:
+            return std::format("LD V{:X}, 0x{:02X}", kX, kByte);
+        case opcode::Id::k7xkk:
+            return std::format("ADD V{:X}, 0x{:02X}", kX, kByte);
+        case opcode::Id::k8xy0:
+            return std::format("LD V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k8xy1:
+            return std::format("OR V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k8xy2:
+            return std::format("AND V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k8xy3:
+            return std::format("XOR V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k8xy4:
+            return std::format("ADD V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k8xy5:
+            return std::format("SUB V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k8xy6:
+            return std::format("SHR V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k8xy7:
+            return std::format("SUBN V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k8xyE:
+            return std::format("SHL V{:X}, V{:X}", kX, kY);
+        case opcode::Id::k9xy0:
+            return std::format("SNE V{:X}, V{:X}", kX, kY);
+        case opcode::Id::kAnnn:
+            return std::format("LD I, 0x{:03X}", kAddress);
+        case opcode::Id::kBnnn:
+            return std::format("JP V0, 0x{:03X}", kAddress);
+        case opcode::Id::kCxkk:
+            return std::format("RND V{:X}, 0x{:02X}", kX, kByte);
+        case opcode::Id::kDxyn:
+            return std::format("DRW V{:X}, V{:X}, {}", kX, kY,
+                               getNibbleN(bytecode));
+        case opcode::Id::kEx9E:
+            return std::format("SKP V{:X}", kX);
+        case opcode::Id::kExA1:
+            return std::format("SKNP V{:X}", kX);
+        case opcode::Id::kFx07:
+            return std::format("LD V{:X}, DT", kX);
+        case opcode::Id::kFx0A:
+            return std::format("LD V{:X}, K", kX);
+        case opcode::Id::kFx15:
+            return std::format("LD DT, V{:X}", kX);
+        case opcode::Id::kFx18:
+            return std::format("LD ST, V{:X}", kX);
+        case opcode::Id::kFx1E:
+            return std::format("ADD I, V{:X}", kX);
+        case opcode::Id::kFx29:
+            return std::format("LD F, V{:X}", kX);
+        case opcode::Id::kFx33:
+            return std::format("LD B, V{:X}", kX);
+        case opcode::Id::kFx55:
+            return std::format("LD [I], V{:X}", kX);
+        case opcode::Id::kFx65:
+            return std::format("LD V{:X}, [I]", kX);
+        case opcode::Id::kInvalid:
+            break;
+    }
+    return std::format("DW 0x{:04X}", bytecode);
+}
+
+void writeDot(std::ostream& output, const Analysis& analysis) {
+    output << "digraph rom {\n"
+              "    node [shape=box, fontname=monospace];\n";
+
+    for (const auto& block : analysis.blocks) {
+        std::string text = label(analysis, block) + ":\\l";
+        for (std::uint32_t address = block.entry; address < block.end;
+             address += 2U) {
+            text += std::format("{:03X}  {}\\l", address,
+                                disassemble(at(analysis, address)));
+        }
+        if (block.dynamic) {
+            text += "(dynamic target)\\l";
+        }
+        output << std::format("    b{:03X} [label=\"{}\"];\n", block.entry,
+                              text);
+    }
+
+    for (const auto& block : analysis.blocks) {
+        for (const auto kSuccessor : block.successors) {
+            const bool kBack = std::ranges::find(
+                                   analysis.back_edges,
+                                   std::pair{block.entry, kSuccessor}) !=
+                               analysis.back_edges.end();
+            output << std::format("    b{:03X} -> b{:03X}{};\n", block.entry,
+                                  kSuccessor, kBack ? " [style=bold]" : "");
+        }
+        if (block.call && analysis.find(*block.call) != nullptr) {
+            output << std::format("    b{:03X} -> b{:03X} [style=dashed];\n",
+                                  block.entry, *block.call);
+        }
+    }
+
+    output << "}\n";
+}
+
+void writeListing(std::ostream& output, const Analysis& analysis) {
+    output << std::format("; ROM 0x{:03X}-0x{:03X}, {} blocks\n",
+                          analysis.begin, analysis.end, analysis.blocks.size());
+
+    std::uint32_t cursor = analysis.begin;
+    for (const auto& block : analysis.blocks) {
+        if (cursor < block.entry) {
+            writeData(output, analysis, cursor, block.entry);
+        }
+
+        output << '\n' << label(analysis, block) << ':';
+        if (block.subroutine) {
+            output << "  ; subroutine";
+        }
+        if (block.loop_header) {
+            output << "  ; loop";
+        }
+        if (block.entry < cursor) {
+            output << "  ; overlaps previous block";
+        }
+        output << '\n';
+
+        for (std::uint32_t address = block.entry; address < block.end;
+             address += 2U) {
+            const auto kBytecode = at(analysis, address);
+            output << std::format("    0x{:03X}  {:04X}  {}\n", address,
+                                  kBytecode, disassemble(kBytecode));
+        }
+        if (block.dynamic) {
+            output << "    ; dynamic jump, targets not followed\n";
+        }
+
+        cursor = std::max<std::uint32_t>(cursor, block.end);
+    }
+
+    if (cursor < analysis.end) {
+        output << '\n';
+        writeData(output, analysis, cursor, analysis.end);
+    }
+}
+
+}  // namespace emu::analysis
@@ -0,0 +1,537 @@
+#include "chip_8/assembler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "chip_8/error.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/parse.hpp"
+
+namespace emu::assembler {
+
+namespace {
+
+constexpr unsigned int kMaxAddress = 0xFFF;
+constexpr unsigned int kMaxByte = 0xFF;
+constexpr unsigned int kMaxNibble = 0xF;
+constexpr unsigned int kMaxWord = 0xFFFF;
+
+struct Statement {
+    std::size_t line;
+    std::uint16_t address;
+    // Upper case
+    std::string mnemonic;
+    std::vector<std::string> operands;
+};
+
+std::string_view trim(std::string_view text) {
+    const auto kFirst = text.find_first_not_of(" \t\r");
+    if (kFirst == std::string_view::npos) {
+        return {};
+    }
+    const auto kLast = text.find_last_not_of(" \t\r");
+    return text.substr(kFirst, kLast - kFirst + 1);
+}
+
+std::string upper(const std::string_view text) {
+    std::string result(text);
+    std::ranges::transform(result, result.begin(), [](const char character) {
+        return static_cast<char>(
+            std::toupper(static_cast<unsigned char>(character)));
+    });
+    return result;
+}
+
+bool isIdentifier(const std::string_view text) {
+    const auto isWordCharacter = [](const char character) {
+        return std::isalnum(static_cast<unsigned char>(character)) != 0 ||
+               character == '_';
+    };
+    return !text.empty() &&
+           std::isdigit(static_cast<unsigned char>(text.front())) == 0 &&
+           std::ranges::all_of(text, isWordCharacter);
+}
+
+std::vector<std::string> splitOperands(const std::string_view text) {
+    std::vector<std::string> operands;
+    if (text.empty()) {
+        return operands;
+    }
+
+    std::size_t begin = 0;
+    while (true) {
+        const auto kComma = text.find(',', begin);
+        operands.emplace_back(trim(text.substr(begin, kComma - begin)));
+        if (kComma == std::string_view::npos) {
+            break;
+        }
+        begin = kComma + 1;
+    }
+    return operands;
+}
+
+std::size_t sizeOf(const Statement& statement) {
+    if (statement.mnemonic == "DB") {
+        return statement.operands.size();
+    }
+    if (statement.mnemonic == "DW") {
+        return 2 * statement.operands.size();
+    }
+    return 2;
+}
+
+/**
+ * @brief Split the source into statements and collect label addresses
+ *
+ * @param source
+ * @param program receives the labels
+ * @return statements in source order
+ */
+std::vector<Statement> parse(const std::string_view source, Program& program) {
+    std::vector<Statement> statements;
+    std::size_t address = memory::kProgramSpaceOffset;
+    std::size_t line_number = 0;
+
+    std::size_t begin = 0;
+    while (begin <= source.size()) {
+        const auto kNewline = std::min(source.find('\n', begin), source.size());
+        auto line = source.substr(begin, kNewline - begin);
+        begin = kNewline + 1;
+        line_number += 1;
+
+        line = trim(line.substr(0, line.find(';')));
+
+        // Labels, possibly several, before the statement
+        for (auto colon = line.find(':'); colon != std::string_view::npos;
+             colon = line.find(':')) {
+            const auto kLabel = trim(line.substr(0, colon));
+            if (!isIdentifier(kLabel)) {
+                throw AssemblyError(line_number,
+                                    std::format("Invalid label '{}'", kLabel));
+            }
+            if (!program.labels
+                     .emplace(kLabel, static_cast<std::uint16_t>(address))
+                     .second) {
+                throw AssemblyError(
+                    line_number, std::format("Duplicate label '{}'", kLabel));
+            }
+            line = trim(line.substr(colon + 1));
+        }
+
+        if (line.empty()) {
+            continue;
+        }
+
+        const auto kSpace = line.find_first_of(" \t");
+        Statement statement{
+            line_number, static_cast<std::uint16_t>(address),
+            upper(line.substr(0, kSpace)),
+            splitOperands(kSpace == std::string_view::npos
+                              ? std::string_view{}
+                              : trim(line.substr(kSpace)))};
+
+        address += sizeOf(statement);
+        if (address > memory::kSize) {
+            throw AssemblyError(line_number, "Program does not fit in memory");
+        }
+        statements.push_back(std::move(statement));
+    }
+
+    return statements;
+}
+
+/**
+ * @brief Encodes one statement at a time
+ */
+class Encoder {
+    const Program& program_;
+    const Statement* statement_{};
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw AssemblyError(statement_->line, message);
+    }
+
+    [[nodiscard]] const std::string& operand(const std::size_t index) const {
+        return statement_->operands[index];
+    }
+
+    void expectOperands(const std::size_t count) const {
+        if (statement_->operands.size() != count) {
+            fail(std::format("{} expects {} operand(s), got {}",
+                             statement_->mnemonic, count,
+                             statement_->operands.size()));
+        }
+    }
+
+    // Register index of a Vx operand
+    static std::optional<unsigned int> registerOf(const std::string_view text) {
+        if (text.size() != 2 || (text[0] != 'V' && text[0] != 'v')) {
+            return std::nullopt;
+        }
+        const auto kDigit =
+            std::toupper(static_cast<unsigned char>(text[1]));
+        if (kDigit >= '0' && kDigit <= '9') {
+            return static_cast<unsigned int>(kDigit - '0');
+        }
+        if (kDigit >= 'A' && kDigit <= 'F') {
+            return static_cast<unsigned int>(kDigit - 'A' + 10);
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] bool is(const std::size_t index,
+                          const std::string_view keyword) const {
+        return upper(operand(index)) == keyword;
+    }
+
+    [[nodiscard]] bool isRegister(const std::size_t index) const {
+        return registerOf(operand(index)).has_value();
+    }
+
+    [[nodiscard]] unsigned int reg(const std::size_t index) const {
+        const auto kRegister = registerOf(operand(index));
+        if (!kRegister) {
+            fail(std::format("Expected a register, got '{}'", operand(index)));
+        }
+        return *kRegister;
+    }
+
+    [[nodiscard]] unsigned int value(const std::size_t index,
+                                     const unsigned int max) const {
+        const auto& text = operand(index);
+        auto result = parse::literal<unsigned int>(text);
+        if (!result) {
+            const auto kLabel = program_.labels.find(text);
+            if (kLabel == program_.labels.end()) {
+                fail(std::format("Unknown label or invalid number '{}'", text));
+            }
+            result = kLabel->second;
+        }
+        if (*result > max) {
+            fail(std::format("'{}' does not fit in 0x{:X}", text, max));
+        }
+        return *result;
+    }
+
+    [[nodiscard]] std::uint16_t address(const unsigned int prefix) const {
+        expectOperands(1);
+        return static_cast<std::uint16_t>(prefix | value(0, kMaxAddress));
+    }
+
+    [[nodiscard]] std::uint16_t xkk(const unsigned int prefix) const {
+        return static_cast<std::uint16_t>(prefix | (reg(0) << 8U) |
+                                          value(1, kMaxByte));
+    }
+
+    [[nodiscard]] std::uint16_t xy(const unsigned int prefix,
+                                   const unsigned int suffix) const {
+        return static_cast<std::uint16_t>(prefix | (reg(0) << 8U) |
+                                          (reg(1) << 4U) | suffix);
+    }
+
+    [[nodiscard]] std::uint16_t x(const unsigned int prefix,
+                                  const std::size_t index,
+                                  const unsigned int suffix) const {
+        return static_cast<std::uint16_t>(prefix | (reg(index) << 8U) |
+                                          suffix);
+    }
+
+    // 3xkk/5xy0 and 4xkk/9xy0 share a mnemonic
+    [[nodiscard]] std::uint16_t compare(const unsigned int immediate,
+                                        const unsigned int registers) const {
+        expectOperands(2);
+        return isRegister(1) ? xy(registers, 0x0U) : xkk(immediate);
+    }
+
+    // SHR and SHL take an optional, ignored, second register
+    [[nodiscard]] std::uint16_t shift(const unsigned int suffix) const {
+        if (statement_->operands.size() == 1) {
+            return x(0x8000U, 0, suffix);
+        }
+        expectOperands(2);
+        return xy(0x8000U, suffix);
+    }
+
+    [[nodiscard]] std::uint16_t load() const {
+        expectOperands(2);
+        if (is(0, "I")) {
+            return static_cast<std::uint16_t>(0xA000U | value(1, kMaxAddress));
+        }
+        if (is(0, "DT")) {
+            return x(0xF000U, 1, 0x15U);
+        }
+        if (is(0, "ST")) {
+            return x(0xF000U, 1, 0x18U);
+        }
+        if (is(0, "F")) {
+            return x(0xF000U, 1, 0x29U);
+        }
+        if (is(0, "B")) {
+            return x(0xF000U, 1, 0x33U);
+        }
+        if (is(0, "[I]")) {
+            return x(0xF000U, 1, 0x55U);
+        }
+        if (is(1, "DT")) {
+            return x(0xF000U, 0, 0x07U);
+        }
+        if (is(1, "K")) {
+            return x(0xF000U, 0, 0x0AU);
+        }
+        if (is(1, "[I]")) {
+            return x(0xF000U, 0, 0x65U);
+        }
+        return isRegister(1) ? xy(0x8000U, 0x0U) : xkk(0x6000U);
+    }
+
+    [[nodiscard]] std::uint16_t add() const {
+        expectOperands(2);
+        if (is(0, "I")) {
+            return x(0xF000U, 1, 0x1EU);
+        }
+        return isRegister(1) ? xy(0x8000U, 0x4U) : xkk(0x7000U);
+    }
+
+    [[nodiscard]] std::uint16_t jump() const {
+        if (statement_->operands.size() == 2) {
+            if (!is(0, "V0")) {
+                fail("Indexed jumps only use V0");
+            }
+            return static_cast<std::uint16_t>(0xB000U | value(1, kMaxAddress));
+        }
+        return address(0x1000U);
+    }
+
+    [[nodiscard]] std::uint16_t instruction() const {
+        const auto& mnemonic = statement_->mnemonic;
+
+        if (mnemonic == "CLS" || mnemonic == "RET") {
+            expectOperands(0);
+            return mnemonic == "CLS" ? 0x00E0 : 0x00EE;
+        }
+        if (mnemonic == "SYS") {
+            return address(0x0000U);
+        }
+        if (mnemonic == "JP") {
+            return jump();
+        }
+        if (mnemonic == "CALL") {
+            return address(0x2000U);
+        }
+        if (mnemonic == "SE") {
+            return compare(0x3000U, 0x5000U);
+        }
+        if (mnemonic == "SNE") {
+            return compare(0x4000U, 0x9000U);
+        }
+        if (mnemonic == "LD") {
+            return load();
+        }
+        if (mnemonic == "ADD") {
+            return add();
+        }
+
+        constexpr std::array<std::pair<std::string_view, unsigned int>, 4>
+            kLogic{{{"OR", 0x1U}, {"AND", 0x2U}, {"XOR", 0x3U}, {"SUB", 0x5U}}};
+        for (const auto& [kName, kSuffix] : kLogic) {
+            if (mnemonic == kName) {
+                expectOperands(2);
+                return xy(0x8000U, kSuffix);
+            }
+        }
+        if (mnemonic == "SUBN") {
+            expectOperands(2);
+            return xy(0x8000U, 0x7U);
+        }
+        if (mnemonic == "SHR") {
+            return shift(0x6U);
+        }
+        if (mnemonic == "SHL") {
+            return shift(0xEU);
+        }
+        if (mnemonic == "RND") {
+            expectOperands(2);
+            return xkk(0xC000U);
+        }
+        if (mnemonic == "DRW") {
+            expectOperands(3);
+            return static_cast<std::uint16_t>(xy(0xD000U, 0x0U) |
+                                              value(2, kMaxNibble));
+        }
+        if (mnemonic == "SKP" || mnemonic == "SKNP") {
+            expectOperands(1);
+            return x(0xE000U, 0, mnemonic == "SKP" ? 0x9EU : 0xA1U);
+        }
+
+        fail(std::format("Unknown mnemonic '{}'", mnemonic));
+    }
+
+   public:
+    explicit Encoder(const Program& program) : program_(program) {}
+
+    void encode(const Statement& statement, std::vector<std::uint8_t>& bytes) {
+        statement_ = &statement;
+
+        if (statement.mnemonic == "DB") {
+            for (std::size_t idx = 0; idx < statement.operands.size(); idx++) {
+                bytes.push_back(static_cast<std::uint8_t>(value(idx, kMaxByte)));
+            }
+            return;
+        }
+
+        const auto emit = [&bytes](const unsigned int word) {
+            bytes.push_back(static_cast<std::uint8_t>(word >> 8U));
+            bytes.push_back(static_cast<std::uint8_t>(word & 0xFFU));
+        };
+
+        if (statement.mnemonic == "DW") {
+            for (std::size_t idx = 0; idx < statement.operands.size(); idx++) {
+                emit(value(idx, kMaxWord));
+            }
+            return;
+        }
+
+        emit(instruction());
+    }
+};
+
+}  // namespace
+
+Program assemble(const std::string_view source) {
+    Program program;
+    const auto kStatements = parse(source, program);
+
+    Encoder encoder(program);
+    for (const auto& statement : kStatements) {
+        encoder.encode(statement, program.bytes);
+    }
+
+    return program;
+}
+
+std::string generate(const Workload workload, const std::uint8_t rounds) {
+    // V0 counts rounds, the kernels are free to use the other registers
+    constexpr std::string_view kPrologue =
+        "    LD V0, 0\n"
+        "round:\n";
+    auto epilogue = std::format(
+        "    ADD V0, 1\n"
+        "    SE V0, {}\n"
+        "    JP round\n"
+        "    LD VB, 0x0F\n"
+        "    LD VD, 0\n"
+        "    LD VE, 0\n",
+        std::max<unsigned int>(rounds, 1U));
+    // Leave the low digit of the kernel registers V1-V7 on screen, so the
+    // result shows in the framebuffer. Fx29 takes the whole byte as digit.
+    constexpr unsigned int kLastShown = 7;
+    for (unsigned int idx = 1; idx <= kLastShown; idx++) {
+        epilogue += std::format(
+            "    LD VC, V{}\n"
+            "    AND VC, VB\n"
+            "    LD F, VC\n"
+            "    DRW VD, VE, 5\n"
+            "    ADD VD, 5\n",
+            idx);
+    }
+    epilogue += std::format("{}:\n    JP {}\n", kHaltLabel, kHaltLabel);
+
+    std::string kernel;
+    switch (workload) {
+        case Workload::kDraw:
+            // 64 8x8 sprites, staggered so every row and column is hit
+            kernel =
+                "    CLS\n"
+                "    LD I, sprite\n"
+                "    LD V1, 0\n"
+                "    LD V2, 0\n"
+                "    LD V3, 0\n"
+                "draw:\n"
+                "    DRW V1, V2, 8\n"
+                "    ADD V1, 9\n"
+                "    ADD V2, 3\n"
+                "    ADD V3, 1\n"
+                "    SE V3, 64\n"
+                "    JP draw\n";
+            break;
+        case Workload::kAlu:
+            kernel =
+                "    LD V1, 0x5A\n"
+                "    LD V2, 0x33\n"
+                "    LD V3, 0\n"
+                "alu:\n"
+                "    ADD V1, V2\n"
+                "    SUB V2, V3\n"
+                "    XOR V4, V1\n"
+                "    OR V5, V2\n"
+                "    AND V6, V4\n"
+                "    SHR V1\n"
+                "    SHL V2\n"
+                "    SUBN V4, V5\n"
+                "    LD V7, V6\n"
+                "    ADD V7, 0x11\n"
+                "    ADD V3, 1\n"
+                "    SE V3, 200\n"
+                "    JP alu\n";
+            break;
+        case Workload::kCall:
+            // Three levels deep, 64 times per round
+            kernel =
+                "    LD V3, 0\n"
+                "call:\n"
+                "    CALL outer\n"
+                "    ADD V3, 1\n"
+                "    SE V3, 64\n"
+                "    JP call\n";
+            break;
+        case Workload::kTimerWait:
+            // Same shape as the delay loops of most games
+            kernel =
+                "    LD V1, 3\n"
+                "    LD DT, V1\n"
+                "wait:\n"
+                "    LD V2, DT\n"
+                "    SE V2, 0\n"
+                "    JP wait\n";
+            break;
+    }
+
+    auto source = std::string(kPrologue) + kernel + epilogue;
+
+    switch (workload) {
+        case Workload::kDraw:
+            source +=
+                "sprite:\n"
+                "    db 0xFF, 0x81, 0xBD, 0xA5, 0xA5, 0xBD, 0x81, 0xFF\n";
+            break;
+        case Workload::kCall:
+            source +=
+                "outer:\n"
+                "    ADD V4, 1\n"
+                "    CALL middle\n"
+                "    RET\n"
+                "middle:\n"
+                "    ADD V5, 1\n"
+                "    CALL inner\n"
+                "    RET\n"
+                "inner:\n"
+                "    ADD V6, 1\n"
+                "    RET\n";
+            break;
+        default:
+            break;
+    }
+
+    return source;
+}
+
+}  // namespace emu::assembler
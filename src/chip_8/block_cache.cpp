@@ -0,0 +1,141 @@
+#include "chip_8/block_cache.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/opcode.hpp"
+#include "chip_8/predecoder.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::block_cache {
+
+namespace {
+
+bool overlaps(const Block& block,
+              const std::uint32_t begin,
+              const std::uint32_t end) {
+    // A block ending past memory also covers its first bytes
+    return (block.entry < end && begin < block.end) ||
+           (block.end > memory::kSize && begin < block.end - memory::kSize);
+}
+
+}  // namespace
+
+Block translate(const memory::Type& memory, const std::uint16_t entry) {
+    Block block{entry, entry, {}};
+
+    std::uint32_t address = entry;
+    while (block.ops.size() < kMaxBlockOps && address < memory::kSize) {
+        const auto kOp =
+            predecoder::decode(memory, static_cast<std::uint16_t>(address));
+        // Fused sequences only ever start with such an instruction
+        const bool kTimed =
+            opcode::observesTime(opcode::identify(kOp.bytecodes[0]));
+        if (kTimed && !block.ops.empty()) {
+            break;
+        }
+
+        block.ops.push_back(kOp);
+        address += 2U * kOp.length;
+
+        if (kTimed || opcode::endsBlock(opcode::identify(
+                          kOp.bytecodes[kOp.length - 1U]))) {
+            break;
+        }
+    }
+
+    block.end = static_cast<std::uint16_t>(address);
+    return block;
+}
+
+Block& BlockCache::insert(Block block) {
+    const auto kEntry = block.entry;
+    auto& slot = blocks_[kEntry];
+    slot = std::make_unique<Block>(std::move(block));
+
+    // Pages past the last one are those the block wrapped around to
+    const auto kLastPage = (slot->end - 1U) / kPageSize;
+    for (auto page = kEntry / kPageSize; page <= kLastPage; page++) {
+        page_entries_[page % kPageCount].push_back(kEntry);
+        code_pages_ |= pageBit(page % kPageCount);
+    }
+
+    return *slot;
+}
+
+void BlockCache::drop(const std::uint16_t entry) {
+    auto block = std::move(blocks_[entry]);
+
+    const auto kLastPage = (block->end - 1U) / kPageSize;
+    for (auto page = entry / kPageSize; page <= kLastPage; page++) {
+        auto& entries = page_entries_[page % kPageCount];
+        std::erase(entries, entry);
+        if (entries.empty()) {
+            code_pages_ &= ~pageBit(page % kPageCount);
+        }
+    }
+
+    // The running block finishes its current op before noticing
+    if (block.get() == running_) {
+        retired_ = std::move(block);
+    }
+}
+
+void BlockCache::pretranslate(const memory::Type& memory,
+                              const analysis::Analysis& analysis) {
+    for (const auto& block : analysis.blocks) {
+        lookup(memory, block.entry);
+    }
+}
+
+void BlockCache::invalidate() {
+    for (std::uint16_t entry = 0; entry < memory::kSize; entry++) {
+        if (blocks_[entry]) {
+            drop(entry);
+        }
+    }
+}
+
+void BlockCache::invalidateCode(const std::uint16_t address,
+                                const std::uint16_t size) {
+    // Writes running past the end of memory wrap around to its start
+    constexpr auto kMemorySize = static_cast<std::uint32_t>(memory::kSize);
+    const std::uint32_t kBegin = address & kAddressMask;
+    const std::uint32_t kEnd = kBegin + size;
+    const std::uint32_t kWrapped = kEnd > kMemorySize ? kEnd - kMemorySize : 0;
+
+    std::vector<std::uint16_t> stale;
+    const auto collect = [&](const std::uint32_t begin,
+                             const std::uint32_t end) {
+        for (auto page = begin / kPageSize; page <= (end - 1U) / kPageSize;
+             page++) {
+            for (const auto kEntry : page_entries_[page]) {
+                if (overlaps(*blocks_[kEntry], begin, end)) {
+                    stale.push_back(kEntry);
+                }
+            }
+        }
+    };
+
+    collect(kBegin, std::min(kEnd, kMemorySize));
+    if (kWrapped != 0) {
+        collect(0, kWrapped);
+    }
+
+    // Blocks spanning two written pages are listed twice
+    std::ranges::sort(stale);
+    const auto [kFirst, kLast] = std::ranges::unique(stale);
+    stale.erase(kFirst, kLast);
+
+    for (const auto kEntry : stale) {
+        drop(kEntry);
+    }
+}
+
+}  // namespace emu::block_cache
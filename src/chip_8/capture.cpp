@@ -0,0 +1,288 @@
+#include "chip_8/capture.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "chip_8/display.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::capture {
+
+namespace {
+
+constexpr std::string_view kMagic{"C8VIDEO\0", 8};
+// Version 2 added gap records
+constexpr std::uint8_t kVersion = 2;
+constexpr std::uint8_t kFirstVersion = 1;
+constexpr std::size_t kHeaderSize = 12;
+
+// Frames in a writer batch
+constexpr std::size_t kBatchSize = 64;
+// Frames arrive at most every few milliseconds, polling rarely is enough
+constexpr auto kIdleWait = std::chrono::milliseconds(5);
+
+constexpr std::size_t kRowBytes = display::kWidth / kByteWidth;
+
+// Row mask of a gap record, no frame changes rows past the display
+constexpr std::uint64_t kGapMask = std::uint64_t{1} << display::kHeight;
+
+/**
+ * @brief Append an unsigned LEB128 varint
+ *
+ * @param buffer
+ * @param value
+ */
+void putVarint(std::vector<std::uint8_t>& buffer, std::uint64_t value) {
+    while (value >= 0x80U) {
+        buffer.push_back(static_cast<std::uint8_t>(value | 0x80U));
+        value >>= 7U;
+    }
+    buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::uint8_t requireU8(std::istream& input) {
+    const auto kByte = input.get();
+    if (kByte == std::istream::traits_type::eof()) {
+        throw CaptureFormatError("Truncated capture frame");
+    }
+    return static_cast<std::uint8_t>(kByte);
+}
+
+/**
+ * @brief Read an unsigned LEB128 varint
+ *
+ * @param input
+ * @param first byte already read
+ * @return std::uint64_t
+ * @throw CaptureFormatError
+ */
+std::uint64_t requireVarint(std::istream& input, std::uint8_t first) {
+    std::uint64_t value = first & 0x7FU;
+    for (unsigned int shift = 7; (first & 0x80U) != 0; shift += 7) {
+        if (shift >= 64) {
+            throw CaptureFormatError("Invalid capture varint");
+        }
+        first = requireU8(input);
+        value |= static_cast<std::uint64_t>(first & 0x7FU) << shift;
+    }
+    return value;
+}
+
+}  // namespace
+
+// ============================================================================
+// Writer
+// ============================================================================
+
+Writer::Writer(std::ostream& output) : output_(output) {
+    output_.write(kMagic.data(), static_cast<std::streamsize>(kMagic.size()));
+    const std::array<char, kHeaderSize - kMagic.size()> kFields{
+        static_cast<char>(kVersion), static_cast<char>(display::kWidth),
+        static_cast<char>(display::kHeight), 0};
+    output_.write(kFields.data(), kFields.size());
+}
+
+void Writer::encodeGap(const std::uint64_t dropped) {
+    putVarint(buffer_, 0);
+    putVarint(buffer_, kGapMask);
+    putVarint(buffer_, dropped);
+}
+
+void Writer::encode(const Frame& frame) {
+    if (frame.dropped != 0) {
+        encodeGap(frame.dropped);
+    }
+
+    putVarint(buffer_, frame.timestamp - previous_.timestamp);
+
+    std::uint32_t rows = 0;
+    for (std::size_t y = 0; y < display::kHeight; y++) {
+        if (frame.rows[y] != previous_.rows[y]) {
+            rows |= 1U << y;
+        }
+    }
+    putVarint(buffer_, rows);
+
+    for (std::size_t y = 0; y < display::kHeight; y++) {
+        const auto kDelta = frame.rows[y] ^ previous_.rows[y];
+        if (kDelta == 0) {
+            continue;
+        }
+
+        // Bit n covers byte n, counted from the leftmost pixels
+        unsigned int bytes = 0;
+        for (std::size_t n = 0; n < kRowBytes; n++) {
+            if (((kDelta >> ((kRowBytes - 1 - n) * kByteWidth)) &
+                 kLowByteMask) != 0) {
+                bytes |= 1U << n;
+            }
+        }
+        buffer_.push_back(static_cast<std::uint8_t>(bytes));
+        for (std::size_t n = 0; n < kRowBytes; n++) {
+            if ((bytes & (1U << n)) != 0) {
+                buffer_.push_back(static_cast<std::uint8_t>(
+                    kDelta >> ((kRowBytes - 1 - n) * kByteWidth)));
+            }
+        }
+    }
+
+    previous_ = frame;
+}
+
+void Writer::flush() {
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+    output_.write(reinterpret_cast<const char*>(buffer_.data()),
+                  static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+}
+
+void Writer::write(const std::span<const Frame> frames) {
+    for (const auto& frame : frames) {
+        encode(frame);
+    }
+    flush();
+}
+
+void Writer::gap(const std::uint64_t dropped) {
+    encodeGap(dropped);
+    flush();
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+Reader::Reader(std::istream& input) : input_(input) {
+    std::array<char, kHeaderSize> header{};
+    if (!input_.read(header.data(), header.size()) ||
+        std::string_view(header.data(), kMagic.size()) != kMagic) {
+        throw CaptureFormatError("Not a CHIP-8 capture");
+    }
+
+    const auto kFileVersion = static_cast<std::uint8_t>(header[kMagic.size()]);
+    if (kFileVersion < kFirstVersion || kFileVersion > kVersion) {
+        throw CaptureFormatError("Unsupported capture version");
+    }
+    if (static_cast<std::uint8_t>(header[kMagic.size() + 1]) !=
+            display::kWidth ||
+        static_cast<std::uint8_t>(header[kMagic.size() + 2]) !=
+            display::kHeight) {
+        throw CaptureFormatError("Unsupported capture resolution");
+    }
+}
+
+bool Reader::next(Frame& frame) {
+    Frame decoded = previous_;
+    decoded.dropped = 0;
+
+    std::uint64_t rows = 0;
+    while (true) {
+        const auto kFirst = input_.get();
+        if (kFirst == std::istream::traits_type::eof()) {
+            return false;
+        }
+        const auto kElapsed =
+            requireVarint(input_, static_cast<std::uint8_t>(kFirst));
+
+        rows = requireVarint(input_, requireU8(input_));
+        if (rows != kGapMask) {
+            decoded.timestamp += kElapsed;
+            break;
+        }
+        const auto kDropped = requireVarint(input_, requireU8(input_));
+        decoded.dropped += kDropped;
+        dropped_ += kDropped;
+    }
+
+    if ((rows >> display::kHeight) != 0) {
+        throw CaptureFormatError("Invalid capture row mask");
+    }
+
+    for (std::size_t y = 0; y < display::kHeight; y++) {
+        if ((rows & (std::uint64_t{1} << y)) == 0) {
+            continue;
+        }
+
+        const auto kBytes = static_cast<unsigned int>(requireU8(input_));
+        std::uint64_t delta = 0;
+        for (std::size_t n = 0; n < kRowBytes; n++) {
+            if ((kBytes & (1U << n)) != 0) {
+                delta |= static_cast<std::uint64_t>(requireU8(input_))
+                         << ((kRowBytes - 1 - n) * kByteWidth);
+            }
+        }
+        decoded.rows[y] ^= delta;
+    }
+
+    previous_ = decoded;
+    frame = decoded;
+    return true;
+}
+
+// ============================================================================
+// Recorder
+// ============================================================================
+
+Recorder::Recorder(const std::filesystem::path& path)
+    : file_(path, std::ofstream::binary | std::ofstream::trunc),
+      writer_(file_),
+      start_(std::chrono::steady_clock::now()) {
+    if (!file_.is_open()) {
+        throw std::ios_base::failure("Cannot open capture file " +
+                                     path.string());
+    }
+
+    thread_ = std::thread([this] { drain(); });
+}
+
+Recorder::~Recorder() { finish(); }
+
+void Recorder::finish() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+}
+
+void Recorder::drain() {
+    std::vector<Frame> batch(kBatchSize);
+
+    while (true) {
+        const auto kStopping = stop_.load(std::memory_order_acquire);
+        const auto kCount = queue_.pop(batch);
+
+        if (kCount != 0) {
+            // Frames are still drained after a failure, so pushing never
+            // blocks
+            if (!failed()) {
+                writer_.write(std::span<const Frame>(batch.data(), kCount));
+                failed_.store(!file_, std::memory_order_relaxed);
+            }
+        } else if (kStopping) {
+            break;
+        } else {
+            std::this_thread::sleep_for(kIdleWait);
+        }
+    }
+
+    // Pushes happened before the stop request, unmarked_ is settled
+    if (unmarked_ != 0 && !failed()) {
+        writer_.gap(unmarked_);
+    }
+    file_.flush();
+    failed_.store(!file_, std::memory_order_relaxed);
+}
+
+}  // namespace emu::capture
@@ -1,36 +1,37 @@
 #include "chip_8/chip_8.hpp"
 
-#include <fstream>
-#include <ios>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
 #include <iterator>
+#include <span>
 
+#include "chip_8/analysis.hpp"
 #include "chip_8/chip_state.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/rom.hpp"
 
 namespace emu {
 
-int Chip8::load() {
-    // Open test ROM
-    std::ifstream file("roms/snake.ch8",
-                       // NOLINTNEXTLINE (hicpp-signed-bitwise)
-                       std::ifstream::ate | std::ifstream::binary);
-    if (!file.is_open()) {
-        return -1;
-    }
-
-    // Get size of file
-    std::streamsize size = file.tellg();
-    // Set file at beggining
-    file.seekg(std::ifstream::beg);
-
-    // Load test ROM into memory at kProgramSpaceOffset
-    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
-    if (!file.read(std::next(reinterpret_cast<char*>(state_.memory.data()),
-                             memory::kProgramSpaceOffset),
-                   size)) {
-        return -1;
-    }
-
-    return 0;
+void Chip8::load(const std::span<const std::uint8_t> rom) {
+    rom::check(rom);
+
+    state_ = ChipState();
+    std::ranges::copy(rom, std::next(state_.memory.begin(),
+                                     memory::kProgramSpaceOffset));
+
+    // Translate the statically reachable blocks now, the rest on first
+    // execution
+    blocks_.invalidate();
+    blocks_.pretranslate(state_.memory, analysis::analyse(rom));
+    aot_.detach();
+    diverged_ = false;
+}
+
+void Chip8::load(const std::filesystem::path& path) {
+    // The mapping only lives until the ROM is copied into memory
+    const rom::Mapping kMapping(path);
+    load(kMapping.bytes());
 }
 
-}  // namespace emu
\ No newline at end of file
+}  // namespace emu
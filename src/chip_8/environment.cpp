@@ -0,0 +1,195 @@
+#include "chip_8/environment.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/predecoder.hpp"
+#include "chip_8/rom.hpp"
+
+namespace emu::environment {
+
+namespace {
+
+/**
+ * @brief Put a machine back on the ROM image and start an episode
+ */
+void start(const Image& image,
+           const Config& config,
+           const Hooks& hooks,
+           const std::uint32_t seed,
+           ChipState& state,
+           predecoder::Program& program,
+           Episode& episode) noexcept {
+    // Only the slots decoded from bytes the last episode stored are stale,
+    // the rest still match the image
+    program.invalidate(state.memory, image.state().memory);
+    state = image.state();
+    state.rnd.seed(seed, config.random);
+    episode = Episode{};
+    episode.score = hooks.score ? hooks.score(state) : 0.0F;
+}
+
+/**
+ * @brief Run config.frame_skip frames with keys held down
+ *
+ * @return reward and whether the episode is over
+ */
+std::pair<float, bool> advance(const Config& config,
+                               const Hooks& hooks,
+                               const keyboard::Type keys,
+                               ChipState& state,
+                               predecoder::Program& program,
+                               Episode& episode) noexcept {
+    state.keys = keys;
+
+    for (std::size_t frame = 0; frame < config.frame_skip; frame++) {
+        episode.overshoot = runFrame(state, program,
+                                     config.instructions_per_frame,
+                                     episode.overshoot);
+        episode.frames++;
+    }
+    state.display.draw = false;
+
+    float reward = 0.0F;
+    if (hooks.score) {
+        const auto kScore = hooks.score(state);
+        reward = kScore - episode.score;
+        episode.score = kScore;
+    }
+
+    const bool kDone =
+        state.fault.status != fault::Status::kNone ||
+        (config.max_frames != 0 && episode.frames >= config.max_frames) ||
+        (hooks.over && hooks.over(state));
+    return {reward, kDone};
+}
+
+}  // namespace
+
+std::size_t runFrame(ChipState& state,
+                     predecoder::Program& program,
+                     const std::size_t instructions,
+                     const std::size_t overshoot) noexcept {
+    auto executed = overshoot;
+    while (executed < instructions &&
+           state.fault.status == fault::Status::kNone) {
+        const auto kRetired = program.step(state);
+        executed += kRetired;
+        // Same timer pacing as Chip8::cycle
+        timers::tick(state, kRetired);
+    }
+    return executed - std::min(executed, instructions);
+}
+
+// ============================================================================
+// Image
+// ============================================================================
+
+Image::Image(const std::span<const std::uint8_t> rom)
+    : program_(std::make_unique<predecoder::Program>()) {
+    rom::check(rom);
+    std::ranges::copy(rom, std::next(state_.memory.begin(),
+                                     memory::kProgramSpaceOffset));
+    program_->predecode(state_.memory, analysis::analyse(rom));
+}
+
+// ============================================================================
+// Environment
+// ============================================================================
+
+Environment::Environment(const std::span<const std::uint8_t> rom,
+                         Config config,
+                         Hooks hooks)
+    : config_(config),
+      hooks_(std::move(hooks)),
+      image_(rom),
+      state_(image_.state()),
+      program_(std::make_unique<predecoder::Program>(image_.program())) {}
+
+const Frame& Environment::reset(const std::uint32_t seed) {
+    start(image_, config_, hooks_, seed, state_, *program_, episode_);
+    return state_.display.rows;
+}
+
+Step Environment::step(const keyboard::Type action_mask) {
+    const auto [kReward, kDone] = advance(config_, hooks_, action_mask, state_,
+                                          *program_, episode_);
+    return {state_.display.rows, kReward, kDone};
+}
+
+// ============================================================================
+// Batch
+// ============================================================================
+
+Batch::Batch(const std::span<const std::uint8_t> rom,
+             const std::size_t size,
+             const std::size_t threads,
+             Config config,
+             Hooks hooks)
+    : config_(config),
+      hooks_(std::move(hooks)),
+      image_(rom),
+      states_(size, image_.state()),
+      programs_(size, image_.program()),
+      episodes_(size),
+      seeds_(size),
+      frames_(size),
+      rewards_(size),
+      dones_(size),
+      pool_(threads) {}
+
+void Batch::resetOne(const std::size_t index) noexcept {
+    start(image_, config_, hooks_, seeds_[index], states_[index],
+          programs_[index], episodes_[index]);
+    seeds_[index] += static_cast<std::uint32_t>(size());
+    frames_[index] = states_[index].display.rows;
+}
+
+void Batch::reset(const std::uint32_t seed) {
+    auto task = [this, seed](const std::size_t begin, const std::size_t end) {
+        for (auto index = begin; index < end; index++) {
+            seeds_[index] = seed + static_cast<std::uint32_t>(index);
+            resetOne(index);
+            rewards_[index] = 0.0F;
+            dones_[index] = 0;
+        }
+    };
+    pool_.run(size(), task);
+}
+
+void Batch::step(const std::span<const keyboard::Type> action_masks) {
+    if (action_masks.size() != size()) {
+        throw std::invalid_argument("One action mask per environment");
+    }
+
+    auto task = [this, action_masks](const std::size_t begin,
+                                     const std::size_t end) {
+        for (auto index = begin; index < end; index++) {
+            const auto [kReward, kDone] =
+                advance(config_, hooks_, action_masks[index], states_[index],
+                        programs_[index], episodes_[index]);
+            rewards_[index] = kReward;
+            dones_[index] = kDone ? 1 : 0;
+
+            if (kDone) {
+                resetOne(index);
+            } else {
+                frames_[index] = states_[index].display.rows;
+            }
+        }
+    };
+    pool_.run(size(), task);
+}
+
+}  // namespace emu::environment
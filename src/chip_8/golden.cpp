@@ -0,0 +1,374 @@
+#include "chip_8/golden.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/assembler.hpp"
+#include "chip_8/block_cache.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/hash.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/parse.hpp"
+#include "chip_8/predecoder.hpp"
+
+namespace emu::golden {
+
+namespace {
+
+// Most instructions a single block can retire
+constexpr std::size_t kMaxBlockInstructions =
+    block_cache::kMaxBlockOps * predecoder::kMaxFusedLength;
+
+template <typename Integer>
+Integer expectInteger(const std::string_view text,
+                      const std::size_t line,
+                      const int base = 10) {
+    const auto kValue = parse::number<Integer>(text, base);
+    if (!kValue) {
+        throw GoldenFormatError(
+            std::format("line {}: invalid number '{}'", line, text));
+    }
+    return *kValue;
+}
+
+// press=K@first:last
+KeyPress parsePress(const std::string_view text, const std::size_t line) {
+    const auto kAt = text.find('@');
+    const auto kColon = text.find(':', kAt);
+    if (kAt == std::string_view::npos || kColon == std::string_view::npos) {
+        throw GoldenFormatError(
+            std::format("line {}: invalid press '{}'", line, text));
+    }
+
+    const auto kKey =
+        expectInteger<std::uint8_t>(text.substr(0, kAt), line, 16);
+    if (kKey >= keyboard::kNumKeys) {
+        throw GoldenFormatError(
+            std::format("line {}: invalid key '{}'", line, text));
+    }
+    return {kKey,
+            expectInteger<std::uint32_t>(
+                text.substr(kAt + 1, kColon - kAt - 1), line),
+            expectInteger<std::uint32_t>(text.substr(kColon + 1), line)};
+}
+
+std::string readFile(const std::filesystem::path& path,
+                     const std::ios::openmode mode) {
+    std::ifstream file(path, mode);
+    if (!file.is_open()) {
+        throw GoldenFormatError(
+            std::format("Cannot open {}", path.string()));
+    }
+    return {std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()};
+}
+
+std::optional<assembler::Workload> parseWorkload(const std::string_view name) {
+    if (name == "draw") {
+        return assembler::Workload::kDraw;
+    }
+    if (name == "alu") {
+        return assembler::Workload::kAlu;
+    }
+    if (name == "call") {
+        return assembler::Workload::kCall;
+    }
+    if (name == "timer") {
+        return assembler::Workload::kTimerWait;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Execute exactly one instruction, keeping the cache in sync with
+ * stores
+ */
+std::size_t stepSingle(ChipState& state, block_cache::BlockCache& cache) {
+    const auto kOp = predecoder::decodeSingle(
+        predecoder::bytecodeAt(state.memory, state.program_counter));
+    const auto [kWritten, kSize] = predecoder::writtenRange(kOp, state);
+
+    const auto kRetired = predecoder::execute(state, kOp);
+
+    if (kOp.writes_memory) {
+        cache.invalidate(kWritten, kSize);
+    }
+    return kRetired;
+}
+
+/**
+ * @brief Feed one byte per pixel, row by row, so hashes do not depend on how
+ * the framebuffer is packed
+ *
+ * @param fnv
+ * @param display
+ */
+void addDisplay(hash::Fnv& fnv, const display::Display& display) {
+    for (std::size_t y = 0; y < display::kHeight; y++) {
+        for (std::size_t x = 0; x < display::kWidth; x++) {
+            fnv.add(static_cast<std::uint8_t>(display::pixel(display, x, y)));
+        }
+    }
+}
+
+}  // namespace
+
+std::uint64_t hash(const display::Display& display) {
+    hash::Fnv fnv;
+    addDisplay(fnv, display);
+    return fnv.value();
+}
+
+std::uint64_t hash(const ChipState& state) {
+    hash::Fnv fnv;
+    fnv.addAll(state.memory);
+    fnv.addAll(state.V);
+    fnv.add16(state.program_counter);
+    fnv.add16(state.index_register);
+    fnv.add(state.delay_timer);
+    fnv.add(state.sound_timer);
+
+    auto stack = state.stack;
+    fnv.add16(static_cast<std::uint16_t>(stack.size()));
+    for (; !stack.empty(); stack.pop()) {
+        fnv.add16(stack.top());
+    }
+
+    addDisplay(fnv, state.display);
+    return fnv.value();
+}
+
+std::vector<Scenario> parseManifest(std::istream& input) {
+    std::vector<Scenario> scenarios;
+
+    std::string text;
+    for (std::size_t line = 1; std::getline(input, text); line++) {
+        text.erase(std::min(text.find('#'), text.size()));
+
+        std::istringstream fields(text);
+        Scenario scenario;
+        if (!(fields >> scenario.name)) {
+            continue;
+        }
+        if (!(fields >> scenario.rom)) {
+            throw GoldenFormatError(std::format("line {}: missing ROM", line));
+        }
+
+        for (std::string field; fields >> field;) {
+            const std::string_view kField = field;
+            const auto kEqual = kField.find('=');
+            const auto kKey = kField.substr(0, kEqual);
+            const auto kValue = kEqual == std::string_view::npos
+                                    ? std::string_view{}
+                                    : kField.substr(kEqual + 1);
+            if (kKey == "frames") {
+                scenario.frames = expectInteger<std::uint32_t>(kValue, line);
+            } else if (kKey == "every") {
+                scenario.every = expectInteger<std::uint32_t>(kValue, line);
+            } else if (kKey == "press") {
+                scenario.presses.push_back(parsePress(kValue, line));
+            } else {
+                throw GoldenFormatError(
+                    std::format("line {}: unknown field '{}'", line, kField));
+            }
+        }
+
+        if (scenario.frames == 0) {
+            throw GoldenFormatError(
+                std::format("line {}: frames must be positive", line));
+        }
+        scenarios.push_back(std::move(scenario));
+    }
+
+    return scenarios;
+}
+
+std::vector<std::uint8_t> loadRom(const std::string& rom,
+                                  const std::filesystem::path& directory) {
+    const std::string_view kRom = rom;
+
+    std::vector<std::uint8_t> bytes;
+    if (kRom.starts_with("workload:")) {
+        const auto kSpec = kRom.substr(kRom.find(':') + 1);
+        const auto kColon = kSpec.find(':');
+        const auto kWorkload = parseWorkload(kSpec.substr(0, kColon));
+        const auto kRounds =
+            kColon == std::string_view::npos
+                ? std::nullopt
+                : parse::number<std::uint8_t>(kSpec.substr(kColon + 1));
+        if (!kWorkload || !kRounds) {
+            throw GoldenFormatError(std::format("Invalid workload '{}'", rom));
+        }
+        bytes = assembler::assemble(assembler::generate(*kWorkload, *kRounds))
+                    .bytes;
+    } else if (kRom.starts_with("asm:")) {
+        bytes = assembler::assemble(
+                    readFile(directory / kRom.substr(4), std::ios::in))
+                    .bytes;
+    } else {
+        const auto kContents =
+            readFile(directory / kRom, std::ios::in | std::ios::binary);
+        bytes.assign(kContents.begin(), kContents.end());
+    }
+
+    if (bytes.size() > memory::kSize - memory::kProgramSpaceOffset) {
+        throw RomSizeError(bytes.size());
+    }
+    return bytes;
+}
+
+Result run(const Scenario& scenario, const std::span<const std::uint8_t> rom) {
+    if (rom.size() > memory::kSize - memory::kProgramSpaceOffset) {
+        throw RomSizeError(rom.size());
+    }
+
+    ChipState state;
+    std::ranges::copy(rom, std::next(state.memory.begin(),
+                                     memory::kProgramSpaceOffset));
+
+    block_cache::BlockCache cache;
+    cache.pretranslate(state.memory,
+                       analysis::analyse(std::span(state.memory)
+                                             .subspan(memory::kProgramSpaceOffset,
+                                                      rom.size())));
+
+    // Frames where the keys change or a checkpoint is taken. The block cache
+    // runs freely in between and single steps up to each boundary.
+    const auto isEvent = [&scenario](const std::uint32_t frame) {
+        return frame == scenario.frames ||
+               (scenario.every != 0 && frame % scenario.every == 0) ||
+               std::ranges::any_of(scenario.presses,
+                                   [frame](const KeyPress& press) {
+                                       return press.first == frame ||
+                                              press.last == frame;
+                                   });
+    };
+
+    Result result;
+    std::uint64_t executed = 0;
+    const auto kStart = std::chrono::steady_clock::now();
+
+    for (std::uint32_t frame = 0; frame < scenario.frames;) {
+        state.keys = 0;
+        for (const auto& press : scenario.presses) {
+            if (press.first <= frame && frame < press.last) {
+                state.keys |= static_cast<keyboard::Type>(1U << press.key);
+            }
+        }
+
+        do {
+            frame += 1;
+        } while (!isEvent(frame));
+        const auto kTarget =
+            static_cast<std::uint64_t>(frame) * kInstructionsPerFrame;
+
+        while (executed < kTarget) {
+            const auto kRetired =
+                executed + kMaxBlockInstructions <= kTarget
+                    ? cache.step(state)
+                    : stepSingle(state, cache);
+            executed += kRetired;
+
+            // Blocks run timer and random ops alone, so ticking after each
+            // step still ticks once per retired instruction before them
+            timers::tick(state, kRetired);
+        }
+
+        if (frame == scenario.frames ||
+            (scenario.every != 0 && frame % scenario.every == 0)) {
+            result.checkpoints.push_back(
+                {frame, hash(state.display), hash(state)});
+        }
+    }
+
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - kStart);
+    return result;
+}
+
+Goldens readGoldens(std::istream& input) {
+    Goldens goldens;
+
+    std::string text;
+    for (std::size_t line = 1; std::getline(input, text); line++) {
+        text.erase(std::min(text.find('#'), text.size()));
+
+        std::istringstream fields(text);
+        std::string name;
+        std::string frame;
+        if (!(fields >> name)) {
+            continue;
+        }
+        if (!(fields >> frame)) {
+            throw GoldenFormatError(std::format("line {}: truncated", line));
+        }
+
+        auto& golden = goldens[name];
+        if (frame == "time") {
+            std::string elapsed;
+            fields >> elapsed;
+            golden.elapsed = std::chrono::nanoseconds(
+                expectInteger<std::int64_t>(elapsed, line));
+            continue;
+        }
+
+        std::string display;
+        std::string state;
+        fields >> display >> state;
+        golden.checkpoints.push_back(
+            {expectInteger<std::uint32_t>(frame, line),
+             expectInteger<std::uint64_t>(display, line, 16),
+             expectInteger<std::uint64_t>(state, line, 16)});
+    }
+
+    return goldens;
+}
+
+void writeGoldens(std::ostream& output, const Goldens& goldens) {
+    output << "# <name> <frame> <display hash> <state hash>\n"
+              "# <name> time <nanoseconds>\n";
+    for (const auto& [name, golden] : goldens) {
+        for (const auto& checkpoint : golden.checkpoints) {
+            output << std::format("{} {} {:016x} {:016x}\n", name,
+                                  checkpoint.frame, checkpoint.display,
+                                  checkpoint.state);
+        }
+        output << std::format("{} time {}\n", name, golden.elapsed.count());
+    }
+}
+
+double machineSpeed(const Goldens& results, const Goldens& goldens) {
+    double log_sum = 0.0;
+    std::size_t count = 0;
+    for (const auto& [name, result] : results) {
+        const auto kGolden = goldens.find(name);
+        if (kGolden == goldens.end() || kGolden->second.elapsed.count() <= 0 ||
+            result.elapsed.count() <= 0) {
+            continue;
+        }
+        const auto kGoldenTime =
+            static_cast<double>(kGolden->second.elapsed.count());
+        log_sum += std::log(kGoldenTime /
+                            static_cast<double>(result.elapsed.count()));
+        count += 1;
+    }
+
+    return count == 0 ? 1.0 : std::exp(log_sum / static_cast<double>(count));
+}
+
+}  // namespace emu::golden
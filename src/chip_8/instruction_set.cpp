@@ -1,84 +1,115 @@
 #include "chip_8/instruction_set.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
-#include <cstring>
 
 #include "chip_8/display.hpp"
-#include "chip_8/error.hpp"
+#include "chip_8/fault.hpp"
 #include "chip_8/keyboard.hpp"
 #include "chip_8/utility.hpp"
 
 namespace emu::instruction_set {
 
-void op0nnn(ChipState& /* not used */, const std::uint16_t /* not used */) {}
-
-void op00E0(ChipState& state, const std::uint16_t /* not used */) {
-    std::memset(state.display.buffer.data(), 0x00, state.display.buffer.size());
+namespace {
+
+/**
+ * @brief Stop the machine on the instruction that just executed, leaving the
+ * program counter on it
+ *
+ * @param state
+ * @param status
+ * @param bytecode
+ */
+void stop(ChipState& state,
+          const fault::Status status,
+          const std::uint16_t bytecode) noexcept {
+    state.program_counter =
+        static_cast<std::uint16_t>(state.program_counter - 2U);
+    state.fault = {status,
+                   static_cast<std::uint16_t>(state.program_counter &
+                                              kAddressMask),
+                   bytecode};
+}
+
+}  // namespace
+
+void op0nnn(ChipState& /* not used */,
+            const std::uint16_t /* not used */) noexcept {}
+
+void op00E0(ChipState& state, const std::uint16_t /* not used */) noexcept {
+    state.display.rows.fill(0);
     state.display.draw = true;
 }
 
-void op00EE(ChipState& state, const std::uint16_t /* not used */) {
+void op00EE(ChipState& state, const std::uint16_t bytecode) noexcept {
     if (state.stack.empty()) {
-        throw StackUnderflowError("Stack underflow on RET");
+        stop(state, fault::Status::kStackUnderflow, bytecode);
+        return;
     }
 
     state.program_counter = state.stack.top();
     state.stack.pop();
 }
 
-void op1nnn(ChipState& state, const std::uint16_t bytecode) {
+void op1nnn(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.program_counter = getAddress(bytecode);
 }
 
-void op2nnn(ChipState& state, const std::uint16_t bytecode) {
+void op2nnn(ChipState& state, const std::uint16_t bytecode) noexcept {
+    if (state.stack.size() >= stack::kDepth) {
+        stop(state, fault::Status::kStackOverflow, bytecode);
+        return;
+    }
+
     state.stack.push(state.program_counter);
     state.program_counter = getAddress(bytecode);
 }
 
-void op3xkk(ChipState& state, const std::uint16_t bytecode) {
+void op3xkk(ChipState& state, const std::uint16_t bytecode) noexcept {
     if (state.V[getNibbleX(bytecode)] == getLowByte(bytecode)) {
         state.program_counter += 2;
     }
 }
 
-void op4xkk(ChipState& state, const std::uint16_t bytecode) {
+void op4xkk(ChipState& state, const std::uint16_t bytecode) noexcept {
     if (state.V[getNibbleX(bytecode)] != getLowByte(bytecode)) {
         state.program_counter += 2;
     }
 }
 
-void op5xy0(ChipState& state, const std::uint16_t bytecode) {
+void op5xy0(ChipState& state, const std::uint16_t bytecode) noexcept {
     if (state.V[getNibbleX(bytecode)] == state.V[getNibbleY(bytecode)]) {
         state.program_counter += 2;
     }
 }
 
-void op6xkk(ChipState& state, const std::uint16_t bytecode) {
+void op6xkk(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.V[getNibbleX(bytecode)] = getLowByte(bytecode);
 }
 
-void op7xkk(ChipState& state, const std::uint16_t bytecode) {
+void op7xkk(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.V[getNibbleX(bytecode)] += getLowByte(bytecode);
 }
 
-void op8xy0(ChipState& state, const std::uint16_t bytecode) {
+void op8xy0(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.V[getNibbleX(bytecode)] = state.V[getNibbleY(bytecode)];
 }
 
-void op8xy1(ChipState& state, const std::uint16_t bytecode) {
+void op8xy1(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.V[getNibbleX(bytecode)] |= state.V[getNibbleY(bytecode)];
 }
 
-void op8xy2(ChipState& state, const std::uint16_t bytecode) {
+void op8xy2(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.V[getNibbleX(bytecode)] &= state.V[getNibbleY(bytecode)];
 }
 
-void op8xy3(ChipState& state, const std::uint16_t bytecode) {
+void op8xy3(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.V[getNibbleX(bytecode)] ^= state.V[getNibbleY(bytecode)];
 }
 
-void op8xy4(ChipState& state, const std::uint16_t bytecode) {
+void op8xy4(ChipState& state, const std::uint16_t bytecode) noexcept {
     const auto kNibbleX = getNibbleX(bytecode);
 
     const auto kResult =
@@ -89,7 +120,7 @@ void op8xy4(ChipState& state, const std::uint16_t bytecode) {
     state.V[kNibbleX] = static_cast<std::uint8_t>(kResult);
 }
 
-void op8xy5(ChipState& state, const std::uint16_t bytecode) {
+void op8xy5(ChipState& state, const std::uint16_t bytecode) noexcept {
     const auto kNibbleX = getNibbleX(bytecode);
 
     const auto kResult =
@@ -100,7 +131,7 @@ void op8xy5(ChipState& state, const std::uint16_t bytecode) {
     state.V[kNibbleX] = static_cast<std::uint8_t>(kResult);
 }
 
-void op8xy6(ChipState& state, const std::uint16_t bytecode) {
+void op8xy6(ChipState& state, const std::uint16_t bytecode) noexcept {
     const auto kNibbleX = getNibbleX(bytecode);
 
     const auto kTemp = static_cast<unsigned int>(state.V[kNibbleX]);
@@ -109,7 +140,7 @@ void op8xy6(ChipState& state, const std::uint16_t bytecode) {
     state.V[kNibbleX] >>= 1U;
 }
 
-void op8xy7(ChipState& state, const std::uint16_t bytecode) {
+void op8xy7(ChipState& state, const std::uint16_t bytecode) noexcept {
     const auto kNibbleX = getNibbleX(bytecode);
 
     const auto kResult =
@@ -120,7 +151,7 @@ void op8xy7(ChipState& state, const std::uint16_t bytecode) {
     state.V[kNibbleX] = static_cast<std::uint8_t>(kResult);
 }
 
-void op8xyE(ChipState& state, const std::uint16_t bytecode) {
+void op8xyE(ChipState& state, const std::uint16_t bytecode) noexcept {
     const auto kNibbleX = getNibbleX(bytecode);
 
     const auto kResult = static_cast<unsigned int>(state.V[kNibbleX]) << 1U;
@@ -129,26 +160,26 @@ void op8xyE(ChipState& state, const std::uint16_t bytecode) {
     state.V[kNibbleX] = static_cast<std::uint8_t>(kResult);
 }
 
-void op9xy0(ChipState& state, const std::uint16_t bytecode) {
+void op9xy0(ChipState& state, const std::uint16_t bytecode) noexcept {
     if (state.V[getNibbleX(bytecode)] != state.V[getNibbleY(bytecode)]) {
         state.program_counter += 2U;
     }
 }
 
-void opAnnn(ChipState& state, const std::uint16_t bytecode) {
+void opAnnn(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.index_register = getAddress(bytecode);
 }
 
-void opBnnn(ChipState& state, const std::uint16_t bytecode) {
+void opBnnn(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.program_counter = getAddress(bytecode) + state.V[0];
 }
 
-void opCxkk(ChipState& state, const std::uint16_t bytecode) {
+void opCxkk(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.V[getNibbleX(bytecode)] =
-        static_cast<std::uint8_t>(state.rnd() & getAddress(bytecode));
+        static_cast<std::uint8_t>(state.rnd.next() & getLowByte(bytecode));
 }
 
-void opDxyn(ChipState& state, const std::uint16_t bytecode) {
+void opDxyn(ChipState& state, const std::uint16_t bytecode) noexcept {
     const auto kCordX =
         static_cast<std::size_t>(state.V[getNibbleX(bytecode)]) %
         display::kWidth;
@@ -156,135 +187,144 @@ void opDxyn(ChipState& state, const std::uint16_t bytecode) {
         static_cast<std::size_t>(state.V[getNibbleY(bytecode)]) %
         display::kHeight;
 
-    const auto kNibbleN = static_cast<std::size_t>(getNibbleN(bytecode));
-
-    state.V[0xF] = 0U;
-    for (std::size_t j = 0; j < kNibbleN; j++) {
-        if ((kCordY + j) == display::kHeight) {
-            break;
-        }
-
-        const auto kSprite =
-            static_cast<unsigned int>(state.memory[state.index_register + j]);
-        for (std::size_t i = 0; i < kByteWidth; i++) {
-            if ((kCordX + i) == display::kWidth) {
-                break;
-            }
-
-            auto& old_pixel =
-                state.display
-                    .buffer[(kCordX + i) + ((kCordY + j) * display::kWidth)];
-            const auto kNewPixel = (kSprite >> (kByteWidth - (i + 1U))) & 0x1U;
-
-            state.V[0xF] |= static_cast<std::uint8_t>(kNewPixel & old_pixel);
-            old_pixel ^= static_cast<std::uint8_t>(kNewPixel);
-        }
-    }
+    const auto kRows = std::min(static_cast<std::size_t>(getNibbleN(bytecode)),
+                                display::kHeight - kCordY);
 
-    state.display.draw = true;
-}
+    std::uint64_t collisions = 0;
+    for (std::size_t j = 0; j < kRows; j++) {
+        const auto kSprite = static_cast<std::uint64_t>(
+            state.memory[(state.index_register + j) & kAddressMask]);
+        // Pixels shifted past the right edge are clipped
+        const auto kBits =
+            (kSprite << (display::kWidth - kByteWidth)) >> kCordX;
 
-void opEx9E(ChipState& state, const std::uint16_t bytecode) {
-    if (state.keyboard == nullptr) {
-        return;
+        auto& row = state.display.rows[kCordY + j];
+        collisions |= row & kBits;
+        row ^= kBits;
     }
 
-    const auto kKey = state.V[getNibbleX(bytecode)];
+    state.V[0xF] = static_cast<std::uint8_t>(collisions != 0 ? 1U : 0U);
+    state.display.draw = true;
+}
 
-    if (state.keyboard[keyboard::mapping(kKey)]) {
+void opEx9E(ChipState& state, const std::uint16_t bytecode) noexcept {
+    if (keyboard::pressed(state.keys, state.V[getNibbleX(bytecode)])) {
         state.program_counter += 2U;
     }
 }
 
-void opExA1(ChipState& state, const std::uint16_t bytecode) {
-    if (state.keyboard == nullptr) {
-        return;
-    }
-
-    const auto kKey = state.V[getNibbleX(bytecode)];
-
-    if (!state.keyboard[keyboard::mapping(kKey)]) {
+void opExA1(ChipState& state, const std::uint16_t bytecode) noexcept {
+    if (!keyboard::pressed(state.keys, state.V[getNibbleX(bytecode)])) {
         state.program_counter += 2U;
     }
 }
 
-void opFx07(ChipState& state, const std::uint16_t bytecode) {
+void opFx07(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.V[getNibbleX(bytecode)] = state.delay_timer;
 }
 
-void opFx0A(ChipState& state, const std::uint16_t bytecode) {
-    if (state.keyboard == nullptr) {
-        // REVIEW: Should we throw an error here? If this is called with a null
-        // keyboard for sure an error happened
-        return;
-    }
-
-    int key_pressed = -1;
-    for (std::uint8_t key = 0;
-         key < static_cast<std::uint8_t>(keyboard::kNumKeys); key++) {
-        if (state.keyboard[keyboard::mapping(key)]) {
-            key_pressed = key;
-            break;
-        }
-    }
-
-    if (key_pressed == -1) {
+void opFx0A(ChipState& state, const std::uint16_t bytecode) noexcept {
+    if (state.keys == 0) {
         // Run this instruction again in the next cycle
         state.program_counter -= 2U;
     } else {
-        const auto kNibbleX = getNibbleX(bytecode);
-        state.V[kNibbleX] = static_cast<std::uint8_t>(key_pressed);
+        // Lowest key held down
+        state.V[getNibbleX(bytecode)] =
+            static_cast<std::uint8_t>(std::countr_zero(state.keys));
     }
 }
 
-void opFx15(ChipState& state, const std::uint16_t bytecode) {
+void opFx15(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.delay_timer = state.V[getNibbleX(bytecode)];
 }
 
-void opFx18(ChipState& state, const std::uint16_t bytecode) {
+void opFx18(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.sound_timer = state.V[getNibbleX(bytecode)];
 }
 
-void opFx1E(ChipState& state, const std::uint16_t bytecode) {
+void opFx1E(ChipState& state, const std::uint16_t bytecode) noexcept {
     state.index_register += state.V[getNibbleX(bytecode)];
 }
 
-void opFx29(ChipState& state, const std::uint16_t bytecode) {
+void opFx29(ChipState& state, const std::uint16_t bytecode) noexcept {
     const auto kDigit =
         static_cast<std::uint16_t>(state.V[getNibbleX(bytecode)]);
 
     state.index_register = font::kMemoryOffset + (kDigit * font::kSpriteSize);
 }
 
-void opFx33(ChipState& state, const std::uint16_t bytecode) {
+void opFx33(ChipState& state, const std::uint16_t bytecode) noexcept {
     auto value = static_cast<unsigned int>(state.V[getNibbleX(bytecode)]);
 
-    state.memory[state.index_register + 2] =
+    state.memory[(state.index_register + 2U) & kAddressMask] =
         static_cast<std::uint8_t>(value % 10U);
     value /= 10U;
 
-    state.memory[state.index_register + 1] =
+    state.memory[(state.index_register + 1U) & kAddressMask] =
         static_cast<std::uint8_t>(value % 10U);
     value /= 10U;
 
-    state.memory[state.index_register] = static_cast<std::uint8_t>(value % 10U);
+    state.memory[state.index_register & kAddressMask] =
+        static_cast<std::uint8_t>(value % 10U);
 }
 
-void opFx55(ChipState& state, const std::uint16_t bytecode) {
+void opFx55(ChipState& state, const std::uint16_t bytecode) noexcept {
     const auto kNibbleX = getNibbleX(bytecode);
 
-    for (int idx = state.index_register, rgs = 0; rgs <= kNibbleX;
+    for (unsigned int idx = state.index_register, rgs = 0; rgs <= kNibbleX;
          idx++, rgs++) {
-        state.memory[idx] = state.V[rgs];
+        state.memory[idx & kAddressMask] = state.V[rgs];
     }
 }
 
-void opFx65(ChipState& state, const std::uint16_t bytecode) {
+void opFx65(ChipState& state, const std::uint16_t bytecode) noexcept {
     const auto kNibbleX = getNibbleX(bytecode);
 
-    for (int idx = state.index_register, rgs = 0; rgs <= kNibbleX;
+    for (unsigned int idx = state.index_register, rgs = 0; rgs <= kNibbleX;
          idx++, rgs++) {
-        state.V[rgs] = state.memory[idx];
+        state.V[rgs] = state.memory[idx & kAddressMask];
+    }
+}
+
+void opInvalid(ChipState& state, const std::uint16_t bytecode) noexcept {
+    stop(state, fault::Status::kInvalidInstruction, bytecode);
+}
+
+void op6xkk6xkk(ChipState& state,
+                const std::uint16_t first,
+                const std::uint16_t second) noexcept {
+    state.V[getNibbleX(first)] = getLowByte(first);
+    state.V[getNibbleX(second)] = getLowByte(second);
+}
+
+void opAnnnDxyn(ChipState& state,
+                const std::uint16_t first,
+                const std::uint16_t second) noexcept {
+    state.index_register = getAddress(first);
+    opDxyn(state, second);
+}
+
+void op7xkk3xkk1nnn(ChipState& state,
+                    const std::uint16_t first,
+                    const std::uint16_t second,
+                    const std::uint16_t third) noexcept {
+    state.V[getNibbleX(first)] += getLowByte(first);
+
+    // 3xkk skips the jump when equal
+    if (state.V[getNibbleX(second)] != getLowByte(second)) {
+        state.program_counter = getAddress(third);
+    }
+}
+
+void opFx073xkk1nnn(ChipState& state,
+                    const std::uint16_t first,
+                    const std::uint16_t second,
+                    const std::uint16_t third) noexcept {
+    state.V[getNibbleX(first)] = state.delay_timer;
+
+    // 3xkk skips the jump when equal
+    if (state.V[getNibbleX(second)] != getLowByte(second)) {
+        state.program_counter = getAddress(third);
     }
 }
 
@@ -0,0 +1,194 @@
+#include "chip_8/instrumentation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <string_view>
+#include <system_error>
+
+#include "chip_8/opcode.hpp"
+
+namespace emu::instrumentation {
+
+namespace {
+
+void writeJsonLatency(std::ostream& output,
+                      const std::string_view key,
+                      const Latency& latency) {
+    output << '"' << key << "\":{\"count\":" << latency.count
+           << ",\"total\":" << latency.total_ns << ",\"max\":" << latency.max_ns
+           << ",\"mean\":" << latency.mean() << '}';
+}
+
+void writePrometheusLatency(std::ostream& output,
+                            const std::string_view metric,
+                            const std::string_view help,
+                            const Latency& latency) {
+    output << "# HELP chip8_" << metric << "_nanoseconds " << help << '\n'
+           << "# TYPE chip8_" << metric << "_nanoseconds summary\n"
+           << "chip8_" << metric << "_nanoseconds_sum " << latency.total_ns
+           << '\n'
+           << "chip8_" << metric << "_nanoseconds_count " << latency.count
+           << '\n'
+           << "# HELP chip8_" << metric << "_max_nanoseconds Maximum " << help
+           << '\n'
+           << "# TYPE chip8_" << metric << "_max_nanoseconds gauge\n"
+           << "chip8_" << metric << "_max_nanoseconds " << latency.max_ns
+           << '\n';
+}
+
+void writeJsonHistogram(std::ostream& output,
+                        const std::string_view key,
+                        const Histogram& histogram) {
+    const auto& latency = histogram.latency;
+    output << '"' << key << "\":{\"count\":" << latency.count
+           << ",\"total\":" << latency.total_ns << ",\"max\":" << latency.max_ns
+           << ",\"mean\":" << latency.mean()
+           << ",\"p50\":" << histogram.quantile(0.5)
+           << ",\"p99\":" << histogram.quantile(0.99) << ",\"buckets\":[";
+    for (std::size_t bucket = 0; bucket < kHistogramBuckets; bucket++) {
+        output << (bucket == 0 ? "" : ",") << histogram.buckets[bucket];
+    }
+    output << "]}";
+}
+
+void writePrometheusHistogram(std::ostream& output,
+                              const std::string_view metric,
+                              const std::string_view help,
+                              const Histogram& histogram) {
+    output << "# HELP chip8_" << metric << "_nanoseconds " << help << '\n'
+           << "# TYPE chip8_" << metric << "_nanoseconds histogram\n";
+    std::uint64_t cumulative = 0;
+    for (std::size_t bucket = 0; bucket + 1 < kHistogramBuckets; bucket++) {
+        cumulative += histogram.buckets[bucket];
+        output << "chip8_" << metric << "_nanoseconds_bucket{le=\""
+               << Histogram::bound(bucket) << "\"} " << cumulative << '\n';
+    }
+    output << "chip8_" << metric << "_nanoseconds_bucket{le=\"+Inf\"} "
+           << histogram.latency.count << '\n'
+           << "chip8_" << metric << "_nanoseconds_sum "
+           << histogram.latency.total_ns << '\n'
+           << "chip8_" << metric << "_nanoseconds_count "
+           << histogram.latency.count << '\n';
+}
+
+}  // namespace
+
+void writeJson(std::ostream& output, const Snapshot& snapshot) {
+    output << "{\"engine\":\"" << kEngine << "\",\"opcodes\":{";
+    bool first = true;
+    for (std::size_t idx = 0; idx < opcode::kCount; idx++) {
+        const auto kId = static_cast<opcode::Id>(idx);
+        if (snapshot.executions[idx] == 0) {
+            continue;
+        }
+        if (!first) {
+            output << ',';
+        }
+        first = false;
+        output << '"' << opcode::name(kId)
+               << "\":{\"executions\":" << snapshot.executions[idx]
+               << ",\"sampled\":" << snapshot.sampled_executions[idx]
+               << ",\"estimated_ticks\":" << snapshot.estimatedTicks(kId)
+               << '}';
+    }
+    output << "},\"dxyn\":{\"draws\":" << snapshot.draws
+           << ",\"collisions\":" << snapshot.collisions
+           << ",\"collision_rate\":" << snapshot.collisionRate() << "},";
+    writeJsonLatency(output, "draw_to_present_ns", snapshot.draw_to_present);
+    output << ',';
+    writeJsonLatency(output, "sleep_overshoot_ns", snapshot.sleep_overshoot);
+    output << ",\"input\":{";
+    writeJsonHistogram(output, "key_to_read_ns", snapshot.key_to_read);
+    output << ',';
+    writeJsonHistogram(output, "key_to_draw_ns", snapshot.key_to_draw);
+    output << ',';
+    writeJsonHistogram(output, "key_to_present_ns", snapshot.key_to_present);
+    output << ",\"expired\":" << snapshot.key_expired << "}}\n";
+}
+
+void writePrometheus(std::ostream& output, const Snapshot& snapshot) {
+    output << "# HELP chip8_engine_info Engine the costs were measured on\n"
+           << "# TYPE chip8_engine_info gauge\n"
+           << "chip8_engine_info{engine=\"" << kEngine << "\"} 1\n";
+
+    output << "# HELP chip8_opcode_executions_total Instructions executed\n"
+           << "# TYPE chip8_opcode_executions_total counter\n";
+    for (std::size_t idx = 0; idx < opcode::kCount; idx++) {
+        output << "chip8_opcode_executions_total{opcode=\""
+               << opcode::name(static_cast<opcode::Id>(idx)) << "\"} "
+               << snapshot.executions[idx] << '\n';
+    }
+
+    output << "# HELP chip8_opcode_ticks_total Estimated cycle counter ticks "
+              "spent per opcode\n"
+           << "# TYPE chip8_opcode_ticks_total counter\n";
+    for (std::size_t idx = 0; idx < opcode::kCount; idx++) {
+        const auto kId = static_cast<opcode::Id>(idx);
+        output << "chip8_opcode_ticks_total{opcode=\"" << opcode::name(kId)
+               << "\"} " << snapshot.estimatedTicks(kId) << '\n';
+    }
+
+    output << "# HELP chip8_draws_total Dxyn executions\n"
+           << "# TYPE chip8_draws_total counter\n"
+           << "chip8_draws_total " << snapshot.draws << '\n'
+           << "# HELP chip8_collisions_total Dxyn executions that set VF\n"
+           << "# TYPE chip8_collisions_total counter\n"
+           << "chip8_collisions_total " << snapshot.collisions << '\n';
+
+    writePrometheusLatency(output, "draw_to_present",
+                           "Time from display change to present",
+                           snapshot.draw_to_present);
+    writePrometheusLatency(output, "sleep_overshoot",
+                           "Time slept past the scheduler target",
+                           snapshot.sleep_overshoot);
+    writePrometheusHistogram(output, "key_to_read",
+                             "Time from key event to the instruction reading "
+                             "the keys",
+                             snapshot.key_to_read);
+    writePrometheusHistogram(output, "key_to_draw",
+                             "Time from key event to the display change "
+                             "answering it",
+                             snapshot.key_to_draw);
+    writePrometheusHistogram(output, "key_to_present",
+                             "Time from key event to the present showing "
+                             "the answer",
+                             snapshot.key_to_present);
+    output << "# HELP chip8_key_events_expired_total Key events dropped "
+              "unanswered\n"
+           << "# TYPE chip8_key_events_expired_total counter\n"
+           << "chip8_key_events_expired_total " << snapshot.key_expired
+           << '\n';
+}
+
+bool dump(const std::filesystem::path& path,
+          const Format format,
+          const Snapshot& snapshot) {
+    auto temporary = path;
+    temporary += ".tmp";
+
+    {
+        std::ofstream file(temporary, std::ofstream::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        if (format == Format::kJson) {
+            writeJson(file, snapshot);
+        } else {
+            writePrometheus(file, snapshot);
+        }
+
+        if (!file.flush()) {
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
+
+}  // namespace emu::instrumentation
@@ -0,0 +1,295 @@
+#include "chip_8/lockstep.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/hash.hpp"
+#include "chip_8/display.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/registers.hpp"
+
+namespace emu::lockstep {
+
+namespace {
+
+// Memory bytes listed in a report before eliding the rest
+constexpr std::size_t kMaxReportedBytes = 16;
+
+std::vector<std::uint16_t> stackOf(stack::Stack stack) {
+    std::vector<std::uint16_t> values;
+    for (; !stack.empty(); stack.pop()) {
+        values.push_back(stack.top());
+    }
+    return values;
+}
+
+bool same(const ChipState& expected, const ChipState& actual) {
+    return hashRegisters(expected) == hashRegisters(actual) &&
+           expected.memory == actual.memory &&
+           expected.display.rows == actual.display.rows &&
+           expected.stack == actual.stack;
+}
+
+std::string formatStack(const std::vector<std::uint16_t>& values) {
+    std::string text = "[";
+    for (const auto kValue : values) {
+        text += std::format("{}0x{:03X}", text.size() > 1 ? " " : "", kValue);
+    }
+    return text + "]";
+}
+
+}  // namespace
+
+std::size_t stepReference(ChipState& state) {
+    const auto kOp = predecoder::decodeSingle(
+        predecoder::bytecodeAt(state.memory, state.program_counter));
+    return predecoder::execute(state, kOp);
+}
+
+std::uint64_t hashRegisters(const ChipState& state) {
+    hash::Fnv fnv;
+    fnv.addAll(state.V);
+    fnv.add16(state.program_counter);
+    fnv.add16(state.index_register);
+    fnv.add(state.delay_timer);
+    fnv.add(state.sound_timer);
+    fnv.add16(static_cast<std::uint16_t>(state.stack.size()));
+    fnv.add16(state.stack.empty() ? std::uint16_t{0} : state.stack.top());
+    fnv.add(static_cast<std::uint8_t>(state.fault.status));
+    fnv.add64(state.rnd.save());
+    return fnv.value();
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+Runner::Runner(const Engine engine) : engine_(engine) {}
+
+void Runner::load(const std::span<const std::uint8_t> rom,
+                  const aot::Program* program) {
+    if (rom.size() > memory::kSize - memory::kProgramSpaceOffset) {
+        throw RomSizeError(rom.size());
+    }
+
+    state_ = ChipState();
+    std::ranges::copy(rom, std::next(state_.memory.begin(),
+                                     memory::kProgramSpaceOffset));
+
+    program_.reset();
+    blocks_.reset();
+    aot_.reset();
+
+    const auto kAnalysis = analysis::analyse(rom);
+    switch (engine_) {
+        case Engine::kReference:
+            break;
+        case Engine::kPredecoder:
+            program_ = std::make_unique<predecoder::Program>();
+            program_->predecode(state_.memory, kAnalysis);
+            break;
+        case Engine::kAot:
+            aot_ = std::make_unique<aot::Runner>();
+            if (program == nullptr || !aot_->attach(*program, state_.memory)) {
+                throw std::invalid_argument(
+                    "Recompiled program does not match the ROM");
+            }
+            [[fallthrough]];
+        case Engine::kBlockCache:
+            blocks_ = std::make_unique<block_cache::BlockCache>();
+            blocks_->pretranslate(state_.memory, kAnalysis);
+            if (aot_) {
+                aot_->setFallback(blocks_.get());
+            }
+            break;
+    }
+}
+
+void Runner::press(const std::uint16_t mask) { state_.keys = mask; }
+
+std::size_t Runner::execute() {
+    switch (engine_) {
+        case Engine::kReference:
+            return stepReference(state_);
+        case Engine::kPredecoder:
+            return program_->step(state_);
+        case Engine::kBlockCache:
+            return blocks_->step(state_);
+        case Engine::kAot:
+            if (const auto kRetired = aot_->step(state_); kRetired != 0) {
+                return kRetired;
+            }
+            return blocks_->step(
+                state_,
+                [this](const std::uint16_t address, const std::uint16_t size) {
+                    aot_->stored(address, size);
+                });
+    }
+    return 0;
+}
+
+void Runner::tick(const std::size_t retired) noexcept {
+    timers::tick(state_, retired);
+}
+
+// ============================================================================
+// Divergences
+// ============================================================================
+
+void writeReport(std::ostream& output, const Divergence& divergence) {
+    const auto& expected = divergence.expected;
+    const auto& actual = divergence.actual;
+
+    output << std::format(
+        "Divergence after {} instructions ({} steps), in the step of {} "
+        "instructions at 0x{:03X}:\n",
+        divergence.instructions, divergence.boundary, divergence.retired,
+        divergence.entry);
+    for (std::size_t i = 0; i < divergence.retired; i++) {
+        const auto kAddress =
+            static_cast<std::uint16_t>(divergence.entry + (2 * i));
+        const auto kBytecode =
+            predecoder::bytecodeAt(expected.memory, kAddress);
+        output << std::format("  0x{:03X}  {:04X}  {}\n",
+                              kAddress & kAddressMask, kBytecode,
+                              analysis::disassemble(kBytecode));
+    }
+
+    output << "Expected (reference) vs actual:\n";
+    const auto field = [&output](const std::string& name,
+                                 const unsigned int want,
+                                 const unsigned int got) {
+        if (want != got) {
+            output << std::format("  {}: 0x{:X} vs 0x{:X}\n", name, want, got);
+        }
+    };
+
+    field("PC", expected.program_counter, actual.program_counter);
+    field("I", expected.index_register, actual.index_register);
+    for (std::size_t reg = 0; reg < registers::kNum; reg++) {
+        field(std::format("V{:X}", reg), expected.V[reg], actual.V[reg]);
+    }
+    field("DT", expected.delay_timer, actual.delay_timer);
+    field("ST", expected.sound_timer, actual.sound_timer);
+    field("fault", static_cast<unsigned int>(expected.fault.status),
+          static_cast<unsigned int>(actual.fault.status));
+
+    if (expected.stack != actual.stack) {
+        output << std::format("  stack: {} vs {}\n",
+                              formatStack(stackOf(expected.stack)),
+                              formatStack(stackOf(actual.stack)));
+    }
+
+    std::size_t bytes = 0;
+    for (std::size_t address = 0; address < memory::kSize; address++) {
+        if (expected.memory[address] == actual.memory[address]) {
+            continue;
+        }
+        if (bytes++ < kMaxReportedBytes) {
+            field(std::format("memory[0x{:03X}]", address),
+                  expected.memory[address], actual.memory[address]);
+        }
+    }
+    if (bytes > kMaxReportedBytes) {
+        output << std::format("  ... {} more memory bytes\n",
+                              bytes - kMaxReportedBytes);
+    }
+
+    std::size_t pixels = 0;
+    for (std::size_t y = 0; y < display::kHeight; y++) {
+        pixels += static_cast<std::size_t>(std::popcount(
+            expected.display.rows[y] ^ actual.display.rows[y]));
+    }
+    if (pixels != 0) {
+        output << std::format("  display: {} pixels differ\n", pixels);
+    }
+}
+
+std::optional<Divergence> verify(const ChipState& before,
+                                 const std::size_t retired,
+                                 const ChipState& after) {
+    auto expected = before;
+    for (std::size_t i = 0; i < retired; i++) {
+        stepReference(expected);
+        timers::tick(expected, 1);
+    }
+
+    if (same(expected, after)) {
+        return std::nullopt;
+    }
+    return Divergence{0, 0, before.program_counter, retired,
+                      std::move(expected), after};
+}
+
+// ============================================================================
+// Checker
+// ============================================================================
+
+Checker::Checker(const Engine candidate,
+                 const std::span<const std::uint8_t> rom,
+                 const aot::Program* program,
+                 const std::size_t full_interval)
+    : candidate_(candidate), full_interval_(std::max<std::size_t>(
+                                 full_interval, 1)) {
+    reference_.load(rom);
+    candidate_.load(rom, program);
+}
+
+void Checker::press(const std::uint16_t mask) {
+    reference_.press(mask);
+    candidate_.press(mask);
+}
+
+std::optional<Divergence> Checker::step() {
+    const auto kEntry = candidate_.state().program_counter;
+
+    // The reference ticks after every instruction, so a candidate whose
+    // ops miss the ticks of the ones before them shows up
+    const auto kRetired = candidate_.step();
+    for (std::size_t i = 0; i < kRetired; i++) {
+        reference_.step();
+    }
+
+    const auto& expected = reference_.state();
+    const auto& actual = candidate_.state();
+    const auto kRegisters = hashRegisters(actual);
+    signature_.add64(kRegisters);
+
+    const bool kFull = (boundaries_ + 1) % full_interval_ == 0;
+    if (kRegisters != hashRegisters(expected) ||
+        (kFull && !same(expected, actual))) {
+        return Divergence{boundaries_, instructions_, kEntry, kRetired,
+                          expected, actual};
+    }
+
+    boundaries_ += 1;
+    instructions_ += kRetired;
+    return std::nullopt;
+}
+
+std::optional<Divergence> Checker::runUntil(const std::uint64_t instructions) {
+    while (instructions_ < instructions &&
+           candidate_.state().fault.status == fault::Status::kNone) {
+        if (auto divergence = step()) {
+            return divergence;
+        }
+    }
+    return std::nullopt;
+}
+
+}  // namespace emu::lockstep
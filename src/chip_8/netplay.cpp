@@ -0,0 +1,300 @@
+#include "chip_8/netplay.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+
+#include "chip_8/environment.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/utility.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define CHIP_8_NETPLAY 1
+#endif
+
+namespace emu::netplay {
+
+namespace {
+
+constexpr std::uint64_t kMask = kHistory - 1;
+
+// "C8NP"
+constexpr std::uint32_t kMagic = 0x504E3843U;
+
+std::string lastError() {
+    return std::generic_category().message(errno);
+}
+
+/**
+ * @brief Little-endian integer at an offset of a packet
+ */
+template <typename Integer>
+void put(const std::span<std::uint8_t> packet,
+         const std::size_t offset,
+         const Integer value) noexcept {
+    for (std::size_t n = 0; n < sizeof(Integer); n++) {
+        packet[offset + n] =
+            static_cast<std::uint8_t>(value >> (n * kByteWidth));
+    }
+}
+
+template <typename Integer>
+Integer get(const std::span<const std::uint8_t> packet,
+            const std::size_t offset) noexcept {
+    Integer value = 0;
+    for (std::size_t n = 0; n < sizeof(Integer); n++) {
+        value = static_cast<Integer>(
+            value |
+            (static_cast<Integer>(packet[offset + n]) << (n * kByteWidth)));
+    }
+    return value;
+}
+
+}  // namespace
+
+// ============================================================================
+// Session
+// ============================================================================
+
+Session::Session(const std::span<const std::uint8_t> rom, const Config config)
+    : config_(config),
+      snapshots_(std::make_unique<std::array<Snapshot, kHistory>>()) {
+    const environment::Image kImage(rom);
+    state_ = kImage.state();
+    state_.rnd.seed(config_.seed, config_.random);
+    program_ = std::make_unique<predecoder::Program>(kImage.program());
+
+    // Frames before the delay run without local keys
+    config_.input_delay = std::min(config_.input_delay, kMaxRollback);
+    local_end_ = config_.input_delay;
+}
+
+keyboard::Type Session::remoteKeys(const std::uint64_t frame) const noexcept {
+    if (frame < confirmed_) {
+        return remote_[frame & kMask];
+    }
+    // Players mostly hold keys for many frames
+    return confirmed_ == 0 ? 0 : remote_[(confirmed_ - 1) & kMask];
+}
+
+void Session::run(const std::uint64_t frame) noexcept {
+    auto& snapshot = (*snapshots_)[frame & kMask];
+    snapshot.state = state_;
+    snapshot.overshoot = overshoot_;
+
+    const auto kRemote = remoteKeys(frame);
+    used_[frame & kMask] = kRemote;
+    state_.keys = static_cast<keyboard::Type>(local_[frame & kMask] | kRemote);
+    overshoot_ = environment::runFrame(
+        state_, *program_, config_.instructions_per_frame, overshoot_);
+}
+
+void Session::restore(const Snapshot& snapshot) noexcept {
+    // Ops decoded from bytes the rolled back frames stored are stale
+    program_->invalidate(state_.memory, snapshot.state.memory);
+
+    state_ = snapshot.state;
+    overshoot_ = snapshot.overshoot;
+}
+
+void Session::synchronize() noexcept {
+    if (!rollback_) {
+        return;
+    }
+    rollback_ = false;
+
+    restore((*snapshots_)[rollback_from_ & kMask]);
+    stats_.rollbacks++;
+    for (auto frame = rollback_from_; frame < frame_; frame++) {
+        run(frame);
+        stats_.resimulated_frames++;
+    }
+}
+
+bool Session::advance(const keyboard::Type local_keys) noexcept {
+    synchronize();
+
+    if (frame_ >= confirmed_ + kMaxRollback ||
+        local_end_ - acknowledged_ >= kHistory) {
+        stats_.stalls++;
+        return false;
+    }
+
+    local_[local_end_ & kMask] = local_keys;
+    local_end_++;
+
+    run(frame_);
+    frame_++;
+    stats_.frames++;
+    return true;
+}
+
+std::size_t Session::write(Packet& packet) const noexcept {
+    const auto kCount = local_end_ - acknowledged_;
+
+    // Sessions past 2^32 frames, two years, are not supported
+    put(packet, 0, kMagic);
+    put(packet, 4, static_cast<std::uint32_t>(confirmed_));
+    put(packet, 8, static_cast<std::uint32_t>(acknowledged_));
+    put(packet, 12, static_cast<std::uint8_t>(kCount));
+    for (std::size_t n = 0; n < kCount; n++) {
+        put(packet, kPacketHeaderSize + (n * sizeof(keyboard::Type)),
+            local_[(acknowledged_ + n) & kMask]);
+    }
+    return kPacketHeaderSize + (kCount * sizeof(keyboard::Type));
+}
+
+void Session::read(const std::span<const std::uint8_t> packet) noexcept {
+    if (packet.size() < kPacketHeaderSize ||
+        get<std::uint32_t>(packet, 0) != kMagic) {
+        stats_.invalid_packets++;
+        return;
+    }
+    const std::uint64_t kAcknowledged = get<std::uint32_t>(packet, 4);
+    const std::uint64_t kStart = get<std::uint32_t>(packet, 8);
+    const std::size_t kCount = packet[12];
+    if (kCount > kHistory ||
+        packet.size() !=
+            kPacketHeaderSize + (kCount * sizeof(keyboard::Type))) {
+        stats_.invalid_packets++;
+        return;
+    }
+
+    if (kAcknowledged > acknowledged_ && kAcknowledged <= local_end_) {
+        acknowledged_ = kAcknowledged;
+    }
+
+    for (std::size_t n = 0; n < kCount; n++) {
+        const auto kFrame = kStart + n;
+        // Keys received in order only, later ones come again until
+        // acknowledged. Keys too far ahead would overwrite the rollback
+        // window.
+        if (kFrame < confirmed_) {
+            continue;
+        }
+        if (kFrame > confirmed_ || kFrame + kMaxRollback >= frame_ + kHistory) {
+            break;
+        }
+
+        const auto kKeys = get<keyboard::Type>(
+            packet, kPacketHeaderSize + (n * sizeof(keyboard::Type)));
+        remote_[kFrame & kMask] = kKeys;
+        if (kFrame < frame_ && used_[kFrame & kMask] != kKeys && !rollback_) {
+            rollback_ = true;
+            rollback_from_ = kFrame;
+        }
+        confirmed_++;
+    }
+}
+
+// ============================================================================
+// Connection
+// ============================================================================
+
+Connection::Connection(const std::uint16_t port) {
+#ifdef CHIP_8_NETPLAY
+    descriptor_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (descriptor_ < 0) {
+        throw NetplayError(lastError());
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+    if (::fcntl(descriptor_, F_SETFL, O_NONBLOCK) != 0 ||
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        ::bind(descriptor_, reinterpret_cast<const sockaddr*>(&address),
+               sizeof(address)) != 0) {
+        const auto kError = lastError();
+        ::close(descriptor_);
+        throw NetplayError(kError);
+    }
+#else
+    static_cast<void>(port);
+    throw NetplayError("UDP sockets are not supported on this platform");
+#endif
+}
+
+Connection::~Connection() {
+#ifdef CHIP_8_NETPLAY
+    ::close(descriptor_);
+#endif
+}
+
+std::uint16_t Connection::port() const {
+#ifdef CHIP_8_NETPLAY
+    sockaddr_in address{};
+    socklen_t size = sizeof(address);
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+    if (::getsockname(descriptor_, reinterpret_cast<sockaddr*>(&address),
+                      &size) != 0) {
+        throw NetplayError(lastError());
+    }
+    return ntohs(address.sin_port);
+#else
+    return 0;
+#endif
+}
+
+void Connection::connect(const std::string& host, const std::uint16_t port) {
+#ifdef CHIP_8_NETPLAY
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    const int kStatus = ::getaddrinfo(
+        host.c_str(), std::to_string(port).c_str(), &hints, &found);
+    if (kStatus != 0) {
+        throw NetplayError(host + ": " + ::gai_strerror(kStatus));
+    }
+
+    const int kConnected = ::connect(descriptor_, found->ai_addr,
+                                     found->ai_addrlen);
+    const auto kError = lastError();
+    ::freeaddrinfo(found);
+    if (kConnected != 0) {
+        throw NetplayError(host + ": " + kError);
+    }
+#else
+    static_cast<void>(host);
+    static_cast<void>(port);
+#endif
+}
+
+void Connection::exchange(Session& session) const noexcept {
+#ifdef CHIP_8_NETPLAY
+    Packet packet{};
+    while (true) {
+        // Fails once drained, or with the peer's port not open yet
+        const auto kReceived =
+            ::recv(descriptor_, packet.data(), packet.size(), 0);
+        if (kReceived < 0) {
+            break;
+        }
+        session.read(
+            std::span(packet).first(static_cast<std::size_t>(kReceived)));
+    }
+
+    const auto kSize = session.write(packet);
+    ::send(descriptor_, packet.data(), kSize, 0);
+#else
+    static_cast<void>(session);
+#endif
+}
+
+}  // namespace emu::netplay
@@ -0,0 +1,167 @@
+#include "chip_8/predecoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/instruction_set.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/opcode.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::predecoder {
+
+namespace {
+
+template <instruction_set::Instruction kInstruction>
+void single(ChipState& state, const Op& op) noexcept {
+    kInstruction(state, op.bytecodes[0]);
+}
+
+void fused6xkk6xkk(ChipState& state, const Op& op) noexcept {
+    instruction_set::op6xkk6xkk(state, op.bytecodes[0], op.bytecodes[1]);
+}
+
+void fusedAnnnDxyn(ChipState& state, const Op& op) noexcept {
+    instruction_set::opAnnnDxyn(state, op.bytecodes[0], op.bytecodes[1]);
+}
+
+void fused7xkk3xkk1nnn(ChipState& state, const Op& op) noexcept {
+    instruction_set::op7xkk3xkk1nnn(state, op.bytecodes[0], op.bytecodes[1],
+                                    op.bytecodes[2]);
+}
+
+void fusedFx073xkk1nnn(ChipState& state, const Op& op) noexcept {
+    instruction_set::opFx073xkk1nnn(state, op.bytecodes[0], op.bytecodes[1],
+                                    op.bytecodes[2]);
+}
+
+// Indexed by opcode::Id
+constexpr std::array<Handler, opcode::kCount> kHandlers{
+    single<instruction_set::op0nnn>, single<instruction_set::op00E0>,
+    single<instruction_set::op00EE>, single<instruction_set::op1nnn>,
+    single<instruction_set::op2nnn>, single<instruction_set::op3xkk>,
+    single<instruction_set::op4xkk>, single<instruction_set::op5xy0>,
+    single<instruction_set::op6xkk>, single<instruction_set::op7xkk>,
+    single<instruction_set::op8xy0>, single<instruction_set::op8xy1>,
+    single<instruction_set::op8xy2>, single<instruction_set::op8xy3>,
+    single<instruction_set::op8xy4>, single<instruction_set::op8xy5>,
+    single<instruction_set::op8xy6>, single<instruction_set::op8xy7>,
+    single<instruction_set::op8xyE>, single<instruction_set::op9xy0>,
+    single<instruction_set::opAnnn>, single<instruction_set::opBnnn>,
+    single<instruction_set::opCxkk>, single<instruction_set::opDxyn>,
+    single<instruction_set::opEx9E>, single<instruction_set::opExA1>,
+    single<instruction_set::opFx07>, single<instruction_set::opFx0A>,
+    single<instruction_set::opFx15>, single<instruction_set::opFx18>,
+    single<instruction_set::opFx1E>, single<instruction_set::opFx29>,
+    single<instruction_set::opFx33>, single<instruction_set::opFx55>,
+    single<instruction_set::opFx65>, single<instruction_set::opInvalid>,
+};
+
+}  // namespace
+
+Op decodeSingle(const std::uint16_t bytecode) {
+    const auto kId = opcode::identify(bytecode);
+
+    return {kHandlers[opcode::index(kId)],
+            {bytecode, 0, 0},
+            1,
+            kId == opcode::Id::kFx33 || kId == opcode::Id::kFx55};
+}
+
+Op decode(const memory::Type& memory, const std::uint16_t address) {
+    const auto kFirst = bytecodeAt(memory, address);
+    const auto kSecond = bytecodeAt(memory, address + 2U);
+    const auto kThird = bytecodeAt(memory, address + 4U);
+
+    const auto kFirstId = opcode::identify(kFirst);
+    const auto kSecondId = opcode::identify(kSecond);
+    const auto kThirdId = opcode::identify(kThird);
+
+    // Fused sequences never wrap around the end of memory
+    const auto kRoom = (memory::kSize - (address & kAddressMask)) / 2U;
+
+    if (kRoom >= 2) {
+        if (kFirstId == opcode::Id::k6xkk && kSecondId == opcode::Id::k6xkk) {
+            return {fused6xkk6xkk, {kFirst, kSecond, 0}, 2, false};
+        }
+        if (kFirstId == opcode::Id::kAnnn && kSecondId == opcode::Id::kDxyn) {
+            return {fusedAnnnDxyn, {kFirst, kSecond, 0}, 2, false};
+        }
+    }
+
+    // A jump to the next instruction could not be told apart from a skip
+    if (kRoom >= 3 && kSecondId == opcode::Id::k3xkk &&
+        kThirdId == opcode::Id::k1nnn &&
+        getAddress(kThird) != ((address + 6U) & kAddressMask)) {
+        if (kFirstId == opcode::Id::k7xkk) {
+            return {fused7xkk3xkk1nnn, {kFirst, kSecond, kThird}, 3, false};
+        }
+        if (kFirstId == opcode::Id::kFx07) {
+            return {fusedFx073xkk1nnn, {kFirst, kSecond, kThird}, 3, false};
+        }
+    }
+
+    return decodeSingle(kFirst);
+}
+
+void Program::predecode(const memory::Type& memory,
+                        const std::uint16_t begin,
+                        const std::uint16_t end) {
+    for (std::uint32_t address = begin; address < end; address += 2) {
+        const auto kAddress = static_cast<std::uint16_t>(address);
+        if (opcode::identify(bytecodeAt(memory, kAddress)) !=
+            opcode::Id::kInvalid) {
+            ops_[kAddress & kAddressMask] = decode(memory, kAddress);
+        }
+    }
+}
+
+void Program::predecode(const memory::Type& memory,
+                        const analysis::Analysis& analysis) {
+    for (const auto& block : analysis.blocks) {
+        for (std::uint32_t address = block.entry; address < block.end;
+             address += 2) {
+            const auto kAddress = static_cast<std::uint16_t>(address);
+            ops_[kAddress & kAddressMask] = decode(memory, kAddress);
+        }
+    }
+}
+
+void Program::invalidate() noexcept {
+    for (auto& op : ops_) {
+        op.length = 0;
+    }
+}
+
+void Program::invalidate(const std::uint16_t address,
+                         const std::uint16_t size) noexcept {
+    // Slots starting up to this many bytes before a write can cover it
+    constexpr unsigned int kReach = (2U * kMaxFusedLength) - 1U;
+
+    for (unsigned int offset = 0; offset < size + kReach; offset++) {
+        ops_[(address + memory::kSize - kReach + offset) & kAddressMask]
+            .length = 0;
+    }
+}
+
+void Program::invalidate(const memory::Type& before,
+                         const memory::Type& after) noexcept {
+    // Compared a word at a time, most of memory is usually unchanged
+    constexpr std::size_t kWord = sizeof(std::uint64_t);
+
+    const std::span kBefore(before);
+    const std::span kAfter(after);
+    for (std::size_t address = 0; address < memory::kSize; address += kWord) {
+        if (!std::ranges::equal(kBefore.subspan(address, kWord),
+                                kAfter.subspan(address, kWord))) {
+            invalidate(static_cast<std::uint16_t>(address), kWord);
+        }
+    }
+}
+
+}  // namespace emu::predecoder
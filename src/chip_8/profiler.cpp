@@ -0,0 +1,100 @@
+#include "chip_8/profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "chip_8/memory.hpp"
+
+namespace emu::profiler {
+
+namespace {
+
+// Heat map side, memory::kSize == kHeatMapSide * kHeatMapSide
+constexpr std::size_t kHeatMapSide = 64;
+constexpr unsigned int kHeatMapMaxValue = 255;
+
+}  // namespace
+
+Profiler::Profiler() {
+    reset();
+}
+
+std::uint32_t Profiler::enter(const std::uint16_t address) {
+    const auto kKey =
+        (static_cast<std::uint64_t>(current_) << 16U) | address;
+
+    const auto kFound = children_.find(kKey);
+    if (kFound != children_.end()) {
+        return kFound->second;
+    }
+
+    const auto kFrame = static_cast<std::uint32_t>(frames_.size());
+    frames_.push_back({address, current_, 0});
+    children_.emplace(kKey, kFrame);
+
+    return kFrame;
+}
+
+void Profiler::writeFolded(std::ostream& output) const {
+    std::vector<std::uint32_t> path;
+
+    for (std::size_t idx = 0; idx < frames_.size(); idx++) {
+        if (frames_[idx].samples == 0) {
+            continue;
+        }
+
+        path.clear();
+        for (auto frame = static_cast<std::uint32_t>(idx); frame != 0;
+             frame = frames_[frame].parent) {
+            path.push_back(frame);
+        }
+
+        std::string line = "main";
+        for (auto frame = path.rbegin(); frame != path.rend(); ++frame) {
+            line += std::format(";sub_{:04X}", frames_[*frame].address);
+        }
+
+        output << line << ' ' << frames_[idx].samples << '\n';
+    }
+}
+
+void Profiler::writeHeatMap(std::ostream& output) const {
+    const auto kHottest = *std::ranges::max_element(heat_);
+    const auto kScale =
+        kHottest == 0 ? 0.0 : std::log1p(static_cast<double>(kHottest));
+
+    output << "P2\n"
+           << kHeatMapSide << ' ' << kHeatMapSide << '\n'
+           << kHeatMapMaxValue << '\n';
+
+    for (std::size_t row = 0; row < kHeatMapSide; row++) {
+        for (std::size_t col = 0; col < kHeatMapSide; col++) {
+            const auto kCount = heat_[(row * kHeatMapSide) + col];
+            const auto kLevel =
+                kCount == 0
+                    ? 0U
+                    : static_cast<unsigned int>(
+                          std::lround(std::log1p(static_cast<double>(kCount)) /
+                                      kScale * kHeatMapMaxValue));
+            output << (col == 0 ? "" : " ") << kLevel;
+        }
+        output << '\n';
+    }
+}
+
+void Profiler::reset() {
+    heat_.fill(0);
+    frames_.clear();
+    children_.clear();
+    frames_.push_back({memory::kProgramSpaceOffset, 0, 0});
+    current_ = 0;
+    depth_ = 0;
+}
+
+}  // namespace emu::profiler
@@ -0,0 +1,383 @@
+#include "chip_8/recompiler.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/opcode.hpp"
+#include "chip_8/predecoder.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::recompiler {
+
+namespace {
+
+std::string hex(const std::uint32_t value) {
+    return std::format("0x{:03X}", value);
+}
+
+/**
+ * @brief Emits the body of one basic block
+ */
+class BlockWriter {
+    std::string body_;
+    std::size_t retired_{};
+    bool uses_runner_{};
+
+    void line(const std::string_view text) {
+        body_ += "    ";
+        body_ += text;
+        body_ += '\n';
+    }
+
+    void leave(const std::string& next) {
+        line(std::format("state.program_counter = {};", next));
+        line(std::format("return {};", retired_));
+    }
+
+    void skip(const std::uint32_t address, const std::string& condition) {
+        leave(std::format("({}) ? {} : {}", condition, hex(address + 4U),
+                          hex(address + 2U)));
+    }
+
+    void call(const std::string_view handler, const std::uint16_t bytecode) {
+        line(std::format("is::{}(state, 0x{:04X});", handler, bytecode));
+    }
+
+    void callAndLeave(const std::uint32_t address,
+                      const std::string_view handler,
+                      const std::uint16_t bytecode) {
+        line(std::format("state.program_counter = {};", hex(address + 2U)));
+        call(handler, bytecode);
+        line(std::format("return {};", retired_));
+    }
+
+    void store(const std::uint32_t address,
+               const std::string_view handler,
+               const std::uint16_t bytecode,
+               const unsigned int size) {
+        uses_runner_ = true;
+        line("{");
+        line("    const auto kIndex = state.index_register;");
+        line(std::format("    is::{}(state, 0x{:04X});", handler, bytecode));
+        line(std::format("    if (runner.stored(kIndex, {})) {{", size));
+        line(std::format("        state.program_counter = {};",
+                         hex(address + 2U)));
+        line(std::format("        return {};", retired_));
+        line("    }");
+        line("}");
+    }
+
+    void flagged(const unsigned int x, const std::string& result,
+                 const std::string& flag) {
+        line("{");
+        line(std::format("    const auto kResult = {};", result));
+        line(std::format("    state.V[0xF] = static_cast<std::uint8_t>({});",
+                         flag));
+        line(std::format("    state.V[0x{:X}] = static_cast<std::uint8_t>("
+                         "kResult);",
+                         x));
+        line("}");
+    }
+
+   public:
+    [[nodiscard]] const std::string& body() const noexcept { return body_; }
+    [[nodiscard]] bool usesRunner() const noexcept { return uses_runner_; }
+
+    /**
+     * @brief Emit an instruction
+     *
+     * @param address
+     * @param bytecode
+     * @return false if the instruction ends the block
+     */
+    bool add(const std::uint32_t address, const std::uint16_t bytecode) {
+        retired_ += 1;
+
+        const auto kX = static_cast<unsigned int>(getNibbleX(bytecode));
+        const auto kY = static_cast<unsigned int>(getNibbleY(bytecode));
+        const auto kByte = static_cast<unsigned int>(getLowByte(bytecode));
+        const auto kVx = std::format("state.V[0x{:X}]", kX);
+        const auto kVy = std::format("state.V[0x{:X}]", kY);
+
+        switch (opcode::identify(bytecode)) {
+            case opcode::Id::k0nnn:
+                line(std::format("// 0x{:04X} is ignored", bytecode));
+                return true;
+            case opcode::Id::k00E0:
+                call("op00E0", bytecode);
+                return true;
+            case opcode::Id::k00EE:
+                callAndLeave(address, "op00EE", bytecode);
+                return false;
+            case opcode::Id::k1nnn:
+                leave(hex(getAddress(bytecode)));
+                return false;
+            case opcode::Id::k2nnn:
+                callAndLeave(address, "op2nnn", bytecode);
+                return false;
+            case opcode::Id::k3xkk:
+                skip(address, std::format("{} == 0x{:02X}", kVx, kByte));
+                return false;
+            case opcode::Id::k4xkk:
+                skip(address, std::format("{} != 0x{:02X}", kVx, kByte));
+                return false;
+            case opcode::Id::k5xy0:
+                skip(address, std::format("{} == {}", kVx, kVy));
+                return false;
+            case opcode::Id::k6xkk:
+                line(std::format("{} = 0x{:02X};", kVx, kByte));
+                return true;
+            case opcode::Id::k7xkk:
+                line(std::format("{0} = static_cast<std::uint8_t>({0} + 0x{1:02X}U);",
+                                 kVx, kByte));
+                return true;
+            case opcode::Id::k8xy0:
+                line(std::format("{} = {};", kVx, kVy));
+                return true;
+            case opcode::Id::k8xy1:
+                line(std::format("{} |= {};", kVx, kVy));
+                return true;
+            case opcode::Id::k8xy2:
+                line(std::format("{} &= {};", kVx, kVy));
+                return true;
+            case opcode::Id::k8xy3:
+                line(std::format("{} ^= {};", kVx, kVy));
+                return true;
+            case opcode::Id::k8xy4:
+                flagged(kX,
+                        std::format("static_cast<unsigned int>({}) + {}", kVx,
+                                    kVy),
+                        "kResult >> 8U");
+                return true;
+            case opcode::Id::k8xy5:
+                flagged(kX,
+                        std::format("static_cast<unsigned int>({}) - {}", kVx,
+                                    kVy),
+                        "(~kResult & 0x100U) >> 8U");
+                return true;
+            case opcode::Id::k8xy6:
+                line(std::format(
+                    "state.V[0xF] = static_cast<std::uint8_t>({} & 0x1U);",
+                    kVx));
+                line(std::format("{0} = static_cast<std::uint8_t>({0} >> 1U);",
+                                 kVx));
+                return true;
+            case opcode::Id::k8xy7:
+                flagged(kX,
+                        std::format("static_cast<unsigned int>({}) - {}", kVy,
+                                    kVx),
+                        "(~kResult & 0x100U) >> 8U");
+                return true;
+            case opcode::Id::k8xyE:
+                flagged(kX, std::format("static_cast<unsigned int>({}) << 1U",
+                                        kVx),
+                        "(kResult & 0x100U) >> 8U");
+                return true;
+            case opcode::Id::k9xy0:
+                skip(address, std::format("{} != {}", kVx, kVy));
+                return false;
+            case opcode::Id::kAnnn:
+                line(std::format("state.index_register = {};",
+                                 hex(getAddress(bytecode))));
+                return true;
+            case opcode::Id::kBnnn:
+                // Dynamic target, dispatched by the runner or interpreted
+                leave(std::format("static_cast<std::uint16_t>({} + state.V[0x0])",
+                                  hex(getAddress(bytecode))));
+                return false;
+            case opcode::Id::kCxkk:
+                call("opCxkk", bytecode);
+                return true;
+            case opcode::Id::kDxyn:
+                call("opDxyn", bytecode);
+                return true;
+            case opcode::Id::kEx9E:
+                callAndLeave(address, "opEx9E", bytecode);
+                return false;
+            case opcode::Id::kExA1:
+                callAndLeave(address, "opExA1", bytecode);
+                return false;
+            case opcode::Id::kFx07:
+                line(std::format("{} = state.delay_timer;", kVx));
+                return true;
+            case opcode::Id::kFx0A:
+                callAndLeave(address, "opFx0A", bytecode);
+                return false;
+            case opcode::Id::kFx15:
+                line(std::format("state.delay_timer = {};", kVx));
+                return true;
+            case opcode::Id::kFx18:
+                line(std::format("state.sound_timer = {};", kVx));
+                return true;
+            case opcode::Id::kFx1E:
+                line(std::format(
+                    "state.index_register = static_cast<std::uint16_t>("
+                    "state.index_register + {});",
+                    kVx));
+                return true;
+            case opcode::Id::kFx29:
+                call("opFx29", bytecode);
+                return true;
+            case opcode::Id::kFx33:
+                store(address, "opFx33", bytecode, 3U);
+                return true;
+            case opcode::Id::kFx55:
+                store(address, "opFx55", bytecode, kX + 1U);
+                return true;
+            case opcode::Id::kFx65:
+                call("opFx65", bytecode);
+                return true;
+            case opcode::Id::kInvalid:
+                callAndLeave(address, "opInvalid", bytecode);
+                return false;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Emit the exit of a block that runs into the next one
+     *
+     * @param next
+     */
+    void fallThrough(const std::uint32_t next) { leave(hex(next)); }
+};
+
+bool isIdentifier(const std::string_view name) {
+    const auto isWordCharacter = [](const char character) {
+        return (character >= 'a' && character <= 'z') ||
+               (character >= 'A' && character <= 'Z') ||
+               (character >= '0' && character <= '9') || character == '_';
+    };
+    return !name.empty() && (name.front() < '0' || name.front() > '9') &&
+           std::ranges::all_of(name, isWordCharacter);
+}
+
+/**
+ * @brief Part of a basic block emitted as its own function
+ */
+struct Piece {
+    std::uint32_t entry;
+    std::uint32_t end;
+};
+
+/**
+ * @brief Split a basic block around the instructions that read or set the
+ * timers or the random generator. Blocks only tick them once they return,
+ * so these run alone, as in the block cache.
+ *
+ * @param analysis
+ * @param block
+ * @return pieces in address order, covering the block
+ */
+std::vector<Piece> split(const analysis::Analysis& analysis,
+                         const BasicBlock& block) {
+    std::vector<Piece> pieces{{block.entry, block.entry}};
+    for (std::uint32_t address = block.entry; address < block.end;
+         address += 2U) {
+        const auto kTimed = opcode::observesTime(
+            opcode::identify(predecoder::bytecodeAt(
+                analysis.memory, static_cast<std::uint16_t>(address))));
+        if (kTimed && pieces.back().end != pieces.back().entry) {
+            pieces.push_back({address, address});
+        }
+        pieces.back().end = address + 2U;
+        if (kTimed && address + 2U < block.end) {
+            pieces.push_back({address + 2U, address + 2U});
+        }
+    }
+    return pieces;
+}
+
+}  // namespace
+
+std::vector<BasicBlock> findBlocks(const std::span<const std::uint8_t> rom) {
+    return analysis::analyse(rom).blocks;
+}
+
+void emit(std::ostream& output,
+          const std::span<const std::uint8_t> rom,
+          const std::string_view name) {
+    if (!isIdentifier(name)) {
+        throw std::invalid_argument(
+            std::format("Not a valid identifier: {}", name));
+    }
+
+    const auto kAnalysis = analysis::analyse(rom);
+    std::vector<Piece> pieces;
+    for (const auto& block : kAnalysis.blocks) {
+        std::ranges::copy(split(kAnalysis, block), std::back_inserter(pieces));
+    }
+
+    output << "// Generated by chip-8-aot, do not edit\n\n"
+              "#include <array>\n"
+              "#include <cstddef>\n"
+              "#include <cstdint>\n\n"
+              "#include \"chip_8/aot.hpp\"\n"
+              "#include \"chip_8/chip_state.hpp\"\n"
+              "#include \"chip_8/instruction_set.hpp\"\n\n"
+              "namespace {\n\n"
+              "namespace is = emu::instruction_set;\n\n";
+
+    for (const auto& piece : pieces) {
+        BlockWriter writer;
+        auto address = piece.entry;
+        bool open = true;
+        while (open && address < piece.end) {
+            open = writer.add(
+                address, predecoder::bytecodeAt(
+                             kAnalysis.memory,
+                             static_cast<std::uint16_t>(address)));
+            address += 2U;
+        }
+        if (open) {
+            writer.fallThrough(address);
+        }
+
+        output << std::format(
+            "std::size_t block{:03X}(emu::ChipState& state, "
+            "emu::aot::Runner& {}) {{\n{}}}\n\n",
+            piece.entry, writer.usesRunner() ? "runner" : "/* not used */",
+            writer.body());
+    }
+
+    output << std::format("constexpr std::array<std::uint8_t, {}> kImage{{\n",
+                          rom.size());
+    for (std::size_t idx = 0; idx < rom.size(); idx++) {
+        output << (idx % 12 == 0 ? "    " : " ")
+               << std::format("0x{:02X},", rom[idx])
+               << (idx % 12 == 11 || idx + 1 == rom.size() ? "\n" : "");
+    }
+    output << "};\n\n";
+
+    output << std::format(
+        "constexpr std::array<emu::aot::Entry, {}> kEntries{{{{\n",
+        pieces.size());
+    for (const auto& piece : pieces) {
+        output << std::format("    {{{}, {}, block{:03X}}},\n", hex(piece.entry),
+                              hex(piece.end), piece.entry);
+    }
+    output << "}};\n\n"
+              "}  // namespace\n\n"
+              "namespace emu::aot::roms {\n\n";
+
+    output << std::format(
+        "const Program& {0}();\n\n"
+        "const Program& {0}() {{\n"
+        "    static constexpr Program kProgram{{kImage, kEntries}};\n"
+        "    return kProgram;\n"
+        "}}\n\n",
+        name);
+    output << "}  // namespace emu::aot::roms\n";
+}
+
+}  // namespace emu::recompiler
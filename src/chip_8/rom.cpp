@@ -0,0 +1,411 @@
+#include "chip_8/rom.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/hash.hpp"
+#include "chip_8/parse.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CHIP_8_ROM_MMAP 1
+#endif
+
+namespace emu::rom {
+
+namespace {
+
+constexpr std::string_view kHeader =
+    "# <hash> <size> <modified> <random> <speed> <blocks> <code bytes> "
+    "<sprite bytes> <dynamic> <path>";
+
+template <typename Integer>
+Integer expectInteger(const std::string_view text,
+                      const std::size_t line,
+                      const int base = 10) {
+    const auto kValue = parse::number<Integer>(text, base);
+    if (!kValue) {
+        throw RomIndexFormatError(
+            std::format("line {}: invalid number '{}'", line, text));
+    }
+    return *kValue;
+}
+
+std::string_view modeName(const random::Mode mode) {
+    return mode == random::Mode::kCosmacVip ? "vip" : "xorshift";
+}
+
+random::Mode parseMode(const std::string_view name, const std::size_t line) {
+    if (name == "xorshift") {
+        return random::Mode::kXorshift;
+    }
+    if (name == "vip") {
+        return random::Mode::kCosmacVip;
+    }
+    throw RomIndexFormatError(
+        std::format("line {}: unknown random mode '{}'", line, name));
+}
+
+std::int64_t modifiedTime(const std::filesystem::path& path,
+                          std::error_code& error) {
+    return static_cast<std::int64_t>(
+        std::filesystem::last_write_time(path, error)
+            .time_since_epoch()
+            .count());
+}
+
+// The same file is always indexed under the same path
+std::string normalise(const std::filesystem::path& path) {
+    std::error_code error;
+    const auto kAbsolute = std::filesystem::absolute(path, error);
+    return (error ? path : kAbsolute).lexically_normal().string();
+}
+
+}  // namespace
+
+std::int64_t modifiedTime(const std::filesystem::path& path) {
+    std::error_code error;
+    return modifiedTime(path, error);
+}
+
+// ============================================================================
+// Mapping
+// ============================================================================
+
+Mapping::Mapping(const std::filesystem::path& path) {
+#ifdef CHIP_8_ROM_MMAP
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+    const int kFile = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (kFile < 0) {
+        throw RomLoadError(path.string(),
+                           std::generic_category().message(errno));
+    }
+
+    struct stat status {};
+    if (::fstat(kFile, &status) != 0) {
+        const auto kError = errno;
+        ::close(kFile);
+        throw RomLoadError(path.string(),
+                           std::generic_category().message(kError));
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    // Empty files cannot be mapped, the span stays empty
+    if (size_ != 0) {
+        void* address =
+            ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, kFile, 0);
+        if (address == MAP_FAILED) {
+            const auto kError = errno;
+            ::close(kFile);
+            throw RomLoadError(path.string(),
+                               std::generic_category().message(kError));
+        }
+        data_ = static_cast<const std::uint8_t*>(address);
+    }
+    // The mapping outlives the descriptor
+    ::close(kFile);
+#else
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        throw RomLoadError(path.string(), "cannot open file");
+    }
+    copy_.assign(std::istreambuf_iterator<char>(file),
+                 std::istreambuf_iterator<char>());
+    data_ = copy_.data();
+    size_ = copy_.size();
+#endif
+}
+
+Mapping::Mapping(Mapping&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      copy_(std::move(other.copy_)) {}
+
+Mapping& Mapping::operator=(Mapping&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        copy_ = std::move(other.copy_);
+    }
+    return *this;
+}
+
+Mapping::~Mapping() { unmap(); }
+
+void Mapping::unmap() noexcept {
+#ifdef CHIP_8_ROM_MMAP
+    if (data_ != nullptr && copy_.empty()) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-const-cast)
+        ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+// ============================================================================
+// ROM files
+// ============================================================================
+
+void check(const std::span<const std::uint8_t> rom) {
+    if (rom.size() > kMaxSize) {
+        throw RomSizeError(rom.size());
+    }
+}
+
+std::vector<std::uint8_t> read(const std::filesystem::path& path) {
+    const Mapping kMapping(path);
+    check(kMapping.bytes());
+    return {kMapping.bytes().begin(), kMapping.bytes().end()};
+}
+
+std::uint64_t contentHash(const std::span<const std::uint8_t> rom) {
+    hash::Fnv fnv;
+    fnv.addAll(rom);
+    return fnv.value();
+}
+
+Metadata describe(const std::span<const std::uint8_t> rom) {
+    const auto kAnalysis = analysis::analyse(rom);
+
+    Metadata metadata;
+    metadata.blocks = static_cast<std::uint32_t>(kAnalysis.blocks.size());
+    for (std::size_t address = kAnalysis.begin; address < kAnalysis.end;
+         address++) {
+        switch (kAnalysis.bytes[address]) {
+            case analysis::Byte::kCode:
+                metadata.code_bytes += 1;
+                break;
+            case analysis::Byte::kSprite:
+                metadata.sprite_bytes += 1;
+                break;
+            case analysis::Byte::kUnknown:
+            case analysis::Byte::kData:
+                break;
+        }
+    }
+    metadata.dynamic = std::ranges::any_of(
+        kAnalysis.blocks,
+        [](const analysis::Block& block) { return block.dynamic; });
+    return metadata;
+}
+
+// ============================================================================
+// Index
+// ============================================================================
+
+Index Index::load(std::istream& input) {
+    Index index;
+
+    std::string text;
+    for (std::size_t line = 1; std::getline(input, text); line++) {
+        if (text.empty() || text.front() == '#') {
+            continue;
+        }
+
+        std::istringstream fields(text);
+        std::string hash;
+        std::string size;
+        std::string modified;
+        std::string mode;
+        std::string speed;
+        std::string blocks;
+        std::string code;
+        std::string sprites;
+        std::string dynamic;
+        std::string path;
+        if (!(fields >> hash >> size >> modified >> mode >> speed >> blocks >>
+              code >> sprites >> dynamic) ||
+            !std::getline(fields >> std::ws, path) || path.empty()) {
+            throw RomIndexFormatError(std::format("line {}: truncated", line));
+        }
+
+        Entry entry;
+        entry.hash = expectInteger<std::uint64_t>(hash, line, 16);
+        entry.size = expectInteger<std::uint64_t>(size, line);
+        entry.modified = expectInteger<std::int64_t>(modified, line);
+        entry.profile.random = parseMode(mode, line);
+        entry.profile.speed = expectInteger<std::uint32_t>(speed, line);
+        entry.metadata.blocks = expectInteger<std::uint32_t>(blocks, line);
+        entry.metadata.code_bytes = expectInteger<std::uint32_t>(code, line);
+        entry.metadata.sprite_bytes =
+            expectInteger<std::uint32_t>(sprites, line);
+        entry.metadata.dynamic =
+            expectInteger<std::uint8_t>(dynamic, line) != 0;
+        entry.path = std::move(path);
+
+        index.files_[entry.path] = {entry.hash, entry.size, entry.modified};
+        index.entries_[entry.hash] = std::move(entry);
+    }
+
+    return index;
+}
+
+void Index::save(std::ostream& output) const {
+    // Sorted by path so saved indexes diff well
+    std::vector<std::pair<const std::string*, const File*>> sorted;
+    sorted.reserve(files_.size());
+    for (const auto& [path, file] : files_) {
+        sorted.emplace_back(&path, &file);
+    }
+    std::ranges::sort(sorted, {}, [](const auto& item) {
+        return std::string_view(*item.first);
+    });
+
+    // One line per file, copies of a ROM repeat its profile
+    output << kHeader << '\n';
+    for (const auto& [path, file] : sorted) {
+        const auto& entry = entries_.at(file->hash);
+        output << std::format(
+            "{:016x} {} {} {} {} {} {} {} {} {}\n", entry.hash, file->size,
+            file->modified, modeName(entry.profile.random),
+            entry.profile.speed, entry.metadata.blocks,
+            entry.metadata.code_bytes, entry.metadata.sprite_bytes,
+            entry.metadata.dynamic ? 1 : 0, *path);
+    }
+}
+
+const Entry* Index::find(const std::uint64_t hash) const {
+    const auto kEntry = entries_.find(hash);
+    return kEntry == entries_.end() ? nullptr : &kEntry->second;
+}
+
+Entry& Index::add(const std::filesystem::path& path,
+                  const std::span<const std::uint8_t> rom,
+                  const std::int64_t modified) {
+    check(rom);
+
+    const auto kHash = contentHash(rom);
+    const auto kPath = normalise(path);
+
+    // The file at path may have held another ROM before
+    const auto kPrevious = files_.find(kPath);
+    if (kPrevious != files_.end() && kPrevious->second.hash != kHash) {
+        forget(kPath);
+    }
+
+    auto [entry, inserted] = entries_.try_emplace(kHash);
+    if (inserted) {
+        entry->second.hash = kHash;
+        entry->second.size = rom.size();
+        entry->second.metadata = describe(rom);
+    }
+
+    entry->second.path = kPath;
+    entry->second.modified = modified;
+    files_[kPath] = {kHash, rom.size(), modified};
+    return entry->second;
+}
+
+void Index::forget(const std::string& path) {
+    const auto kFile = files_.find(path);
+    if (kFile == files_.end()) {
+        return;
+    }
+    const auto kHash = kFile->second.hash;
+    files_.erase(kFile);
+
+    // The entry moves to another copy of the ROM, if any is left
+    const auto kCopy =
+        std::ranges::find_if(files_, [kHash](const auto& item) {
+            return item.second.hash == kHash;
+        });
+    if (kCopy == files_.end()) {
+        entries_.erase(kHash);
+        return;
+    }
+    auto& entry = entries_.at(kHash);
+    if (entry.path == path) {
+        entry.path = kCopy->first;
+        entry.modified = kCopy->second.modified;
+    }
+}
+
+bool Index::setProfile(const std::uint64_t hash, const Profile& profile) {
+    const auto kEntry = entries_.find(hash);
+    if (kEntry == entries_.end()) {
+        return false;
+    }
+    kEntry->second.profile = profile;
+    return true;
+}
+
+std::size_t Index::scan(const std::filesystem::path& directory) {
+    std::size_t read = 0;
+    std::vector<std::string> seen;
+
+    std::error_code error;
+    for (std::filesystem::recursive_directory_iterator it(directory, error),
+         end;
+         !error && it != end; it.increment(error)) {
+        if (!it->is_regular_file(error) || it->path().extension() != ".ch8") {
+            continue;
+        }
+
+        const auto kPath = normalise(it->path());
+        const auto kSize = it->file_size(error);
+        const auto kModified = modifiedTime(it->path(), error);
+        if (error) {
+            error.clear();
+            continue;
+        }
+        if (kSize > kMaxSize) {
+            // Not a ROM (any more)
+            forget(kPath);
+            continue;
+        }
+        seen.push_back(kPath);
+
+        const auto kKnown = files_.find(kPath);
+        if (kKnown != files_.end() && kKnown->second.size == kSize &&
+            kKnown->second.modified == kModified) {
+            continue;
+        }
+
+        try {
+            const Mapping kMapping(it->path());
+            add(it->path(), kMapping.bytes(), kModified);
+            read += 1;
+        } catch (const RomLoadError&) {
+            // Unreadable files are left out, as if they were not there
+        } catch (const RomSizeError&) {
+            // Grew past kMaxSize since it was listed
+        }
+    }
+
+    // Drop files that are gone, and ROMs no file holds any more
+    std::ranges::sort(seen);
+    std::vector<std::string> gone;
+    for (const auto& [path, file] : files_) {
+        if (!std::ranges::binary_search(seen, path) &&
+            !std::filesystem::exists(path)) {
+            gone.push_back(path);
+        }
+    }
+    for (const auto& path : gone) {
+        forget(path);
+    }
+
+    return read;
+}
+
+}  // namespace emu::rom
@@ -0,0 +1,195 @@
+#include "chip_8/shared_memory.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/error.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define CHIP_8_SHARED_MEMORY 1
+#endif
+
+namespace emu::shared_memory {
+
+namespace {
+
+std::string lastError() {
+    return std::generic_category().message(errno);
+}
+
+std::uint64_t packRegisters(const registers::Type& V,
+                            const std::size_t word) noexcept {
+    std::uint64_t packed = 0;
+    for (std::size_t i = 0; i < 8; i++) {
+        packed |= static_cast<std::uint64_t>(V[(word * 8) + i]) << (8 * i);
+    }
+    return packed;
+}
+
+#ifdef CHIP_8_SHARED_MEMORY
+/**
+ * @brief Map a shared-memory object
+ *
+ * @return mapped address
+ * @throw SharedMemoryError
+ */
+void* map(const std::string& name, const int flags, const int protection) {
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+    const int kObject = ::shm_open(name.c_str(), flags, 0644);
+    if (kObject < 0) {
+        throw SharedMemoryError(name, lastError());
+    }
+
+    if ((flags & O_CREAT) != 0 && ::ftruncate(kObject, sizeof(Region)) != 0) {
+        const auto kError = lastError();
+        ::close(kObject);
+        throw SharedMemoryError(name, kError);
+    }
+
+    void* address = ::mmap(nullptr, sizeof(Region), protection, MAP_SHARED,
+                           kObject, 0);
+    const auto kError = lastError();
+    ::close(kObject);
+    if (address == MAP_FAILED) {
+        throw SharedMemoryError(name, kError);
+    }
+    return address;
+}
+#endif
+
+}  // namespace
+
+// ============================================================================
+// Publisher
+// ============================================================================
+
+Publisher::Publisher(std::string name) : name_(std::move(name)) {
+#ifdef CHIP_8_SHARED_MEMORY
+    void* address = map(name_, O_CREAT | O_RDWR, PROT_READ | PROT_WRITE);
+    region_ = ::new (address) Region{};
+    region_->magic = kMagic;
+    region_->version = kVersion;
+    region_->size = sizeof(Region);
+#else
+    throw SharedMemoryError(name_, "not supported on this platform");
+#endif
+}
+
+Publisher::~Publisher() {
+#ifdef CHIP_8_SHARED_MEMORY
+    ::munmap(region_, sizeof(Region));
+    ::shm_unlink(name_.c_str());
+#endif
+}
+
+void Publisher::publish(const ChipState& state) noexcept {
+    auto& region = *region_;
+    const auto kSequence = region.sequence.load(std::memory_order_relaxed);
+
+    // Odd while writing, payload stores may not move above this
+    region.sequence.store(kSequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    region.frame.store(region.frame.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+    for (std::size_t word = 0; word < region.registers.size(); word++) {
+        region.registers[word].store(packRegisters(state.V, word),
+                                     std::memory_order_relaxed);
+    }
+    region.machine.store(
+        static_cast<std::uint64_t>(state.program_counter) |
+            (static_cast<std::uint64_t>(state.index_register) << 16U) |
+            (static_cast<std::uint64_t>(state.delay_timer) << 32U) |
+            (static_cast<std::uint64_t>(state.sound_timer) << 40U) |
+            (static_cast<std::uint64_t>(state.keys) << 48U),
+        std::memory_order_relaxed);
+    region.status.store(
+        static_cast<std::uint64_t>(state.stack.size()) |
+            (static_cast<std::uint64_t>(state.fault.status) << 8U),
+        std::memory_order_relaxed);
+    for (std::size_t y = 0; y < display::kHeight; y++) {
+        region.rows[y].store(state.display.rows[y],
+                             std::memory_order_relaxed);
+    }
+
+    region.sequence.store(kSequence + 2, std::memory_order_release);
+}
+
+// ============================================================================
+// Subscriber
+// ============================================================================
+
+Subscriber::Subscriber(const std::string& name) {
+#ifdef CHIP_8_SHARED_MEMORY
+    region_ = static_cast<const Region*>(map(name, O_RDONLY, PROT_READ));
+    if (region_->magic != kMagic || region_->version != kVersion ||
+        region_->size != sizeof(Region)) {
+        ::munmap(const_cast<Region*>(region_),  // NOLINT
+                 sizeof(Region));
+        throw SharedMemoryError(name, "unknown layout");
+    }
+#else
+    throw SharedMemoryError(name, "not supported on this platform");
+#endif
+}
+
+Subscriber::~Subscriber() {
+#ifdef CHIP_8_SHARED_MEMORY
+    ::munmap(const_cast<Region*>(region_), sizeof(Region));  // NOLINT
+#endif
+}
+
+bool Subscriber::read(Snapshot& snapshot) const noexcept {
+    const auto& region = *region_;
+
+    for (std::size_t attempt = 0; attempt < kMaxReadAttempts; attempt++) {
+        const auto kBefore = region.sequence.load(std::memory_order_acquire);
+        if ((kBefore & 1U) != 0) {
+            continue;
+        }
+
+        Snapshot copy;
+        copy.frame = region.frame.load(std::memory_order_relaxed);
+        for (std::size_t word = 0; word < region.registers.size(); word++) {
+            const auto kPacked =
+                region.registers[word].load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < 8; i++) {
+                copy.V[(word * 8) + i] =
+                    static_cast<std::uint8_t>(kPacked >> (8 * i));
+            }
+        }
+        const auto kMachine = region.machine.load(std::memory_order_relaxed);
+        copy.program_counter = static_cast<std::uint16_t>(kMachine);
+        copy.index_register = static_cast<std::uint16_t>(kMachine >> 16U);
+        copy.delay_timer = static_cast<std::uint8_t>(kMachine >> 32U);
+        copy.sound_timer = static_cast<std::uint8_t>(kMachine >> 40U);
+        copy.keys = static_cast<keyboard::Type>(kMachine >> 48U);
+        const auto kStatus = region.status.load(std::memory_order_relaxed);
+        copy.stack_size = static_cast<std::uint8_t>(kStatus);
+        copy.fault = static_cast<fault::Status>(kStatus >> 8U);
+        for (std::size_t y = 0; y < display::kHeight; y++) {
+            copy.display.rows[y] =
+                region.rows[y].load(std::memory_order_relaxed);
+        }
+
+        // Payload loads may not move below the second sequence load
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (region.sequence.load(std::memory_order_relaxed) == kBefore) {
+            snapshot = copy;
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace emu::shared_memory
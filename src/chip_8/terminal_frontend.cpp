@@ -0,0 +1,175 @@
+#include "chip_8/terminal_frontend.hpp"
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <thread>
+
+#include "chip_8/display.hpp"
+#include "chip_8/keyboard.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <termios.h>
+#include <unistd.h>
+#define CHIP_8_TERMINAL_INPUT 1
+#endif
+
+namespace emu::frontend {
+
+namespace {
+
+// Character typed for each key, indexed by key
+constexpr std::string_view kLayout = "x123qweasdzc4rfv";
+
+constexpr std::string_view kHideCursor = "\x1b[?25l";
+constexpr std::string_view kShowCursor = "\x1b[?25h";
+constexpr std::string_view kClearScreen = "\x1b[2J";
+constexpr std::string_view kHome = "\x1b[H";
+
+// Indexed by top pixel | bottom pixel << 1
+constexpr std::array<std::string_view, 4> kCells = {" ", "▀", "▄",
+                                                     "█"};
+
+}  // namespace
+
+#ifdef CHIP_8_TERMINAL_INPUT
+struct Terminal::RawMode {
+    int input;
+    termios saved;
+
+    ~RawMode() { ::tcsetattr(input, TCSANOW, &saved); }
+};
+#else
+struct Terminal::RawMode {};
+#endif
+
+Terminal::Terminal(std::ostream& output, const int input)
+    : output_(output), input_(input) {
+#ifdef CHIP_8_TERMINAL_INPUT
+    termios settings{};
+    if (input_ != kNoInput && ::isatty(input_) != 0 &&
+        ::tcgetattr(input_, &settings) == 0) {
+        raw_mode_ = std::make_unique<RawMode>(RawMode{input_, settings});
+
+        // Unbuffered and silent, reads return at once. Signals still work,
+        // so Ctrl-C quits.
+        // NOLINTNEXTLINE (hicpp-signed-bitwise)
+        settings.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+        settings.c_cc[VMIN] = 0;
+        settings.c_cc[VTIME] = 0;
+        ::tcsetattr(input_, TCSANOW, &settings);
+    }
+#endif
+
+    // The cleared screen matches the blank shown_
+    output_ << kHideCursor << kClearScreen << kHome << std::flush;
+}
+
+Terminal::~Terminal() {
+    // Leave the prompt below the display
+    output_ << std::format("\x1b[{};1H", (display::kHeight / 2) + 1)
+            << kShowCursor << std::flush;
+}
+
+void Terminal::appendCell(const display::Display& display,
+                          const std::size_t line,
+                          const std::size_t column) {
+    const auto kTop = display::pixel(display, column, 2 * line) ? 1U : 0U;
+    const auto kBottom =
+        display::pixel(display, column, (2 * line) + 1) ? 2U : 0U;
+    frame_ += kCells[kTop | kBottom];
+}
+
+void Terminal::present(const display::Display& display) {
+    frame_.clear();
+
+    for (std::size_t line = 0; line < display::kHeight / 2; line++) {
+        const auto kTop = 2 * line;
+        auto changed = (display.rows[kTop] ^ shown_.rows[kTop]) |
+                       (display.rows[kTop + 1] ^ shown_.rows[kTop + 1]);
+
+        while (changed != 0) {
+            // Column 0 is the most significant bit
+            const auto kColumn =
+                static_cast<std::size_t>(std::countl_zero(changed));
+            changed &= ~(std::uint64_t{1} << (display::kWidth - 1 - kColumn));
+
+            if (line == cursor_line_ && kColumn >= cursor_column_ &&
+                kColumn - cursor_column_ <= kMaxRewrittenCells) {
+                for (; cursor_column_ < kColumn; cursor_column_++) {
+                    appendCell(display, line, cursor_column_);
+                }
+            } else {
+                // Short enough for the small string buffer, no allocation
+                frame_ += std::format("\x1b[{};{}H", line + 1, kColumn + 1);
+            }
+
+            appendCell(display, line, kColumn);
+            cursor_line_ = line;
+            cursor_column_ = kColumn + 1;
+        }
+    }
+
+    shown_ = display;
+    if (frame_.empty()) {
+        return;
+    }
+
+    // One write per frame
+    output_.write(frame_.data(), static_cast<std::streamsize>(frame_.size()));
+    output_.flush();
+}
+
+keyboard::Type Terminal::poll() {
+#ifdef CHIP_8_TERMINAL_INPUT
+    if (input_ != kNoInput) {
+        std::array<char, 64> buffer{};
+        for (;;) {
+            const auto kRead = ::read(input_, buffer.data(), buffer.size());
+            if (kRead <= 0) {
+                break;
+            }
+            for (std::size_t i = 0; i < static_cast<std::size_t>(kRead); i++) {
+                type(buffer[i]);
+            }
+        }
+    }
+#endif
+
+    const auto kNow = std::chrono::steady_clock::now();
+    keyboard::Type keys = 0;
+    for (std::size_t key = 0; key < keyboard::kNumKeys; key++) {
+        if (held_until_[key] > kNow) {
+            keys |= static_cast<keyboard::Type>(1U << key);
+        }
+    }
+    return keys;
+}
+
+void Terminal::type(const char character) {
+    const auto kLower = character >= 'A' && character <= 'Z'
+                            ? static_cast<char>(character - 'A' + 'a')
+                            : character;
+    const auto kKey = kLayout.find(kLower);
+    if (kKey != std::string_view::npos) {
+        held_until_[kKey] = std::chrono::steady_clock::now() + kKeyHold;
+    }
+}
+
+void Terminal::beep(const bool on) {
+    if (on) {
+        output_ << '\a' << std::flush;
+    }
+}
+
+void Terminal::wait(const Duration duration) {
+    std::this_thread::sleep_for(duration);
+}
+
+}  // namespace emu::frontend
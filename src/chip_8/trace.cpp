@@ -0,0 +1,356 @@
+#include "chip_8/trace.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "chip_8/error.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/registers.hpp"
+#include "chip_8/utility.hpp"
+
+namespace emu::trace {
+
+namespace {
+
+constexpr std::string_view kMagic{"C8TRACE\0", 8};
+constexpr std::uint8_t kVersion = 1;
+constexpr std::uint8_t kCompressedFlag = 0x01;
+constexpr std::size_t kHeaderSize = 12;
+constexpr std::size_t kRawRecordSize = 32;
+
+// Compressed record flags, a set bit means the field is stored
+constexpr unsigned int kExplicitAddress = 1U << 0U;
+constexpr unsigned int kSequenceGap = 1U << 1U;
+constexpr unsigned int kIndexRegister = 1U << 2U;
+constexpr unsigned int kTimers = 1U << 3U;
+constexpr unsigned int kStackDepth = 1U << 4U;
+constexpr unsigned int kRegisters = 1U << 5U;
+constexpr unsigned int kChangedMask = 1U << 6U;
+
+// Records in a writer batch
+constexpr std::size_t kBatchSize = 1024;
+constexpr auto kIdleWait = std::chrono::microseconds(200);
+
+/**
+ * @brief Record every stream starts its delta encoding from
+ *
+ * @return Record
+ */
+Record initialRecord() {
+    Record record{};
+    record.sequence = UINT32_MAX;
+    record.address = memory::kProgramSpaceOffset - 2;
+    return record;
+}
+
+void putU8(std::vector<std::uint8_t>& buffer, const unsigned int value) {
+    buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+void putU16(std::vector<std::uint8_t>& buffer, const unsigned int value) {
+    putU8(buffer, value & kLowByteMask);
+    putU8(buffer, (value >> kByteWidth) & kLowByteMask);
+}
+
+void putU32(std::vector<std::uint8_t>& buffer, const std::uint32_t value) {
+    putU16(buffer, value & 0xFFFFU);
+    putU16(buffer, value >> 16U);
+}
+
+bool getU8(std::istream& input, std::uint8_t& value) {
+    const auto kByte = input.get();
+    if (kByte == std::istream::traits_type::eof()) {
+        return false;
+    }
+    value = static_cast<std::uint8_t>(kByte);
+    return true;
+}
+
+std::uint8_t requireU8(std::istream& input) {
+    std::uint8_t value{};
+    if (!getU8(input, value)) {
+        throw TraceFormatError("Truncated trace record");
+    }
+    return value;
+}
+
+std::uint16_t requireU16(std::istream& input) {
+    const auto kLow = static_cast<unsigned int>(requireU8(input));
+    const auto kHigh = static_cast<unsigned int>(requireU8(input));
+    return static_cast<std::uint16_t>(kLow | (kHigh << kByteWidth));
+}
+
+std::uint32_t requireU32(std::istream& input) {
+    const auto kLow = static_cast<std::uint32_t>(requireU16(input));
+    const auto kHigh = static_cast<std::uint32_t>(requireU16(input));
+    return kLow | (kHigh << 16U);
+}
+
+std::uint16_t registerDiff(const registers::Type& from,
+                           const registers::Type& to) {
+    unsigned int mask = 0;
+    for (std::size_t idx = 0; idx < registers::kNum; idx++) {
+        if (from[idx] != to[idx]) {
+            mask |= 1U << idx;
+        }
+    }
+    return static_cast<std::uint16_t>(mask);
+}
+
+}  // namespace
+
+Writer::Writer(std::ostream& output, const bool compressed)
+    : output_(output), compressed_(compressed), previous_(initialRecord()) {
+    output_.write(kMagic.data(), static_cast<std::streamsize>(kMagic.size()));
+    const std::array<char, kHeaderSize - kMagic.size()> kFields{
+        static_cast<char>(kVersion),
+        static_cast<char>(compressed ? kCompressedFlag : 0), 0, 0};
+    output_.write(kFields.data(), kFields.size());
+}
+
+void Writer::encodeRaw(const Record& record) {
+    putU32(buffer_, record.sequence);
+    putU16(buffer_, record.address);
+    putU16(buffer_, record.bytecode);
+    putU16(buffer_, record.index_register);
+    putU16(buffer_, record.changed);
+    putU8(buffer_, record.delay_timer);
+    putU8(buffer_, record.sound_timer);
+    putU8(buffer_, record.stack_depth);
+    putU8(buffer_, record.reserved);
+    buffer_.insert(buffer_.end(), record.V.begin(), record.V.end());
+}
+
+void Writer::encodeCompressed(const Record& record) {
+    const auto kDiff = registerDiff(previous_.V, record.V);
+
+    unsigned int flags = 0;
+    if (record.address != static_cast<std::uint16_t>(previous_.address + 2)) {
+        flags |= kExplicitAddress;
+    }
+    if (record.sequence != previous_.sequence + 1) {
+        flags |= kSequenceGap;
+    }
+    if (record.index_register != previous_.index_register) {
+        flags |= kIndexRegister;
+    }
+    if (record.delay_timer != previous_.delay_timer ||
+        record.sound_timer != previous_.sound_timer) {
+        flags |= kTimers;
+    }
+    if (record.stack_depth != previous_.stack_depth) {
+        flags |= kStackDepth;
+    }
+    if (kDiff != 0) {
+        flags |= kRegisters;
+    }
+    if (record.changed != kDiff) {
+        flags |= kChangedMask;
+    }
+
+    putU8(buffer_, flags);
+    putU16(buffer_, record.bytecode);
+    if ((flags & kExplicitAddress) != 0) {
+        putU16(buffer_, record.address);
+    }
+    if ((flags & kSequenceGap) != 0) {
+        putU32(buffer_, record.sequence);
+    }
+    if ((flags & kIndexRegister) != 0) {
+        putU16(buffer_, record.index_register);
+    }
+    if ((flags & kTimers) != 0) {
+        putU8(buffer_, record.delay_timer);
+        putU8(buffer_, record.sound_timer);
+    }
+    if ((flags & kStackDepth) != 0) {
+        putU8(buffer_, record.stack_depth);
+    }
+    if ((flags & kRegisters) != 0) {
+        putU16(buffer_, kDiff);
+        for (std::size_t idx = 0; idx < registers::kNum; idx++) {
+            if ((kDiff & (1U << idx)) != 0) {
+                putU8(buffer_, record.V[idx]);
+            }
+        }
+    }
+    if ((flags & kChangedMask) != 0) {
+        putU16(buffer_, record.changed);
+    }
+
+    previous_ = record;
+}
+
+void Writer::write(const std::span<const Record> records) {
+    buffer_.clear();
+    for (const auto& record : records) {
+        if (compressed_) {
+            encodeCompressed(record);
+        } else {
+            encodeRaw(record);
+        }
+    }
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+    output_.write(reinterpret_cast<const char*>(buffer_.data()),
+                  static_cast<std::streamsize>(buffer_.size()));
+}
+
+Reader::Reader(std::istream& input)
+    : input_(input), previous_(initialRecord()) {
+    std::array<char, kHeaderSize> header{};
+    if (!input_.read(header.data(), header.size()) ||
+        std::string_view(header.data(), kMagic.size()) != kMagic) {
+        throw TraceFormatError("Not a CHIP-8 trace");
+    }
+
+    if (static_cast<std::uint8_t>(header[kMagic.size()]) != kVersion) {
+        throw TraceFormatError("Unsupported trace version");
+    }
+
+    compressed_ =
+        (static_cast<std::uint8_t>(header[kMagic.size() + 1]) &
+         kCompressedFlag) != 0;
+}
+
+bool Reader::decodeRaw(Record& record) {
+    std::array<char, kRawRecordSize> raw{};
+    if (!input_.read(raw.data(), raw.size())) {
+        if (input_.gcount() != 0) {
+            throw TraceFormatError("Truncated trace record");
+        }
+        return false;
+    }
+
+    const auto kByte = [&raw](const std::size_t idx) {
+        return static_cast<unsigned int>(static_cast<std::uint8_t>(raw[idx]));
+    };
+    const auto kWord = [&kByte](const std::size_t idx) {
+        return static_cast<std::uint16_t>(kByte(idx) |
+                                          (kByte(idx + 1) << kByteWidth));
+    };
+
+    record.sequence = static_cast<std::uint32_t>(kWord(0)) |
+                      (static_cast<std::uint32_t>(kWord(2)) << 16U);
+    record.address = kWord(4);
+    record.bytecode = kWord(6);
+    record.index_register = kWord(8);
+    record.changed = kWord(10);
+    record.delay_timer = static_cast<std::uint8_t>(kByte(12));
+    record.sound_timer = static_cast<std::uint8_t>(kByte(13));
+    record.stack_depth = static_cast<std::uint8_t>(kByte(14));
+    record.reserved = static_cast<std::uint8_t>(kByte(15));
+    for (std::size_t idx = 0; idx < registers::kNum; idx++) {
+        record.V[idx] = static_cast<std::uint8_t>(kByte(16 + idx));
+    }
+
+    return true;
+}
+
+bool Reader::decodeCompressed(Record& record) {
+    std::uint8_t flags{};
+    if (!getU8(input_, flags)) {
+        return false;
+    }
+
+    record = previous_;
+    record.sequence = previous_.sequence + 1;
+    record.address = static_cast<std::uint16_t>(previous_.address + 2);
+    record.bytecode = requireU16(input_);
+
+    if ((flags & kExplicitAddress) != 0) {
+        record.address = requireU16(input_);
+    }
+    if ((flags & kSequenceGap) != 0) {
+        record.sequence = requireU32(input_);
+    }
+    if ((flags & kIndexRegister) != 0) {
+        record.index_register = requireU16(input_);
+    }
+    if ((flags & kTimers) != 0) {
+        record.delay_timer = requireU8(input_);
+        record.sound_timer = requireU8(input_);
+    }
+    if ((flags & kStackDepth) != 0) {
+        record.stack_depth = requireU8(input_);
+    }
+
+    std::uint16_t diff = 0;
+    if ((flags & kRegisters) != 0) {
+        diff = requireU16(input_);
+        for (std::size_t idx = 0; idx < registers::kNum; idx++) {
+            if ((diff & (1U << idx)) != 0) {
+                record.V[idx] = requireU8(input_);
+            }
+        }
+    }
+    record.changed = diff;
+    if ((flags & kChangedMask) != 0) {
+        record.changed = requireU16(input_);
+    }
+
+    previous_ = record;
+    return true;
+}
+
+bool Reader::next(Record& record) {
+    return compressed_ ? decodeCompressed(record) : decodeRaw(record);
+}
+
+Recorder::Recorder(const std::filesystem::path& path, const bool compressed)
+    : file_(path, std::ofstream::binary | std::ofstream::trunc),
+      writer_(file_, compressed) {
+    if (!file_.is_open()) {
+        throw std::ios_base::failure("Cannot open trace file " +
+                                     path.string());
+    }
+
+    thread_ = std::thread([this] { drain(); });
+}
+
+Recorder::~Recorder() { finish(); }
+
+void Recorder::finish() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+}
+
+void Recorder::drain() {
+    std::vector<Record> batch(kBatchSize);
+
+    while (true) {
+        const auto kStopping = stop_.load(std::memory_order_acquire);
+        const auto kCount = queue_.pop(batch);
+
+        if (kCount != 0) {
+            // Records are still drained after a failure, so the interpreter
+            // never waits on a dead file
+            if (!failed()) {
+                writer_.write(std::span<const Record>(batch.data(), kCount));
+                failed_.store(!file_, std::memory_order_relaxed);
+            }
+        } else if (kStopping) {
+            break;
+        } else {
+            std::this_thread::sleep_for(kIdleWait);
+        }
+    }
+
+    file_.flush();
+    failed_.store(!file_, std::memory_order_relaxed);
+}
+
+}  // namespace emu::trace
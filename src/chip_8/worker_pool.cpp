@@ -0,0 +1,78 @@
+#include "chip_8/worker_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace emu {
+
+WorkerPool::WorkerPool(const std::size_t threads) {
+    const auto kThreads =
+        threads != 0
+            ? threads
+            : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+    threads_.reserve(kThreads - 1);
+    for (std::size_t chunk = 1; chunk < kThreads; chunk++) {
+        threads_.emplace_back([this, chunk] { work(chunk); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    stop_.store(true, std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkerPool::runChunk(const std::size_t chunk) const noexcept {
+    // Chunk sizes differ by at most one
+    const auto kChunks = threads_.size() + 1;
+    const auto kBegin = (size_ * chunk) / kChunks;
+    const auto kEnd = (size_ * (chunk + 1)) / kChunks;
+    if (kBegin != kEnd) {
+        task_(context_, kBegin, kEnd);
+    }
+}
+
+void WorkerPool::work(const std::size_t chunk) {
+    // Workers may start after the first job was dispatched
+    std::uint32_t seen = 0;
+    for (;;) {
+        generation_.wait(seen, std::memory_order_acquire);
+        seen = generation_.load(std::memory_order_acquire);
+        if (stop_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        runChunk(chunk);
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pending_.notify_one();
+        }
+    }
+}
+
+void WorkerPool::dispatch() noexcept {
+    if (threads_.empty()) {
+        runChunk(0);
+        return;
+    }
+
+    pending_.store(threads_.size(), std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+
+    runChunk(0);
+
+    for (auto pending = pending_.load(std::memory_order_acquire); pending != 0;
+         pending = pending_.load(std::memory_order_acquire)) {
+        pending_.wait(pending, std::memory_order_acquire);
+    }
+}
+
+}  // namespace emu
@@ -1,7 +1,38 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
 
 #include "chip_8/chip_8.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/frontend.hpp"
+#include "chip_8/instrumentation.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/netplay.hpp"
+#include "chip_8/pacing.hpp"
+#include "chip_8/parse.hpp"
+#include "chip_8/random.hpp"
+#include "chip_8/rom.hpp"
+#include "chip_8/sdl_frontend.hpp"
+#include "chip_8/terminal_frontend.hpp"
+#include "chip_8/worker_pool.hpp"
 
 #define SDL_MAIN_USE_CALLBACKS 1
 #include "SDL3/SDL.h" // IWYU pragma: keep
@@ -10,50 +41,710 @@
 #include "SDL3/SDL_log.h"
 #include "SDL3/SDL_main.h"
 
-static emu::Chip8 g_interpreter;
+/* Picked at startup, the core is compiled once per frontend */
+using Frontend = std::variant<emu::frontend::Null, emu::frontend::Sdl,
+                              emu::frontend::Terminal>;
+
+/* One emulator and where its frames go */
+struct Instance {
+    emu::Chip8 interpreter;
+    Frontend frontend;
+    // Windows may only be drawn from the main thread, so instances with one
+    // are emulated into this target and presented afterwards
+    emu::frontend::Offscreen target;
+    bool beeping{};
+    bool running{true};
+    emu::fault::Status status{emu::fault::Status::kNone};
+    // Host error from the last frame, e.g. a failed trace write
+    std::string error;
+    // Appended to output paths when several instances run
+    std::string suffix;
+    // Two-player session replacing the interpreter, when configured
+    std::unique_ptr<emu::netplay::Session> session;
+    std::unique_ptr<emu::netplay::Connection> connection;
+};
+
+/* State shared by the SDL callbacks through appstate */
+struct App {
+    std::vector<std::unique_ptr<Instance>> instances;
+    std::unique_ptr<emu::WorkerPool> pool;
+};
+
+#ifdef CHIP_8_ENABLE_AOT
+namespace emu::aot::roms {
+// Generated from CHIP_8_AOT_ROM by chip-8-aot
+const Program& builtin();
+}  // namespace emu::aot::roms
+#endif
+
+/* ROM run when none is given on the command line */
+constexpr const char* kDefaultRom = "roms/snake.ch8";
+
+/* Instructions between two metrics dumps, roughly ten seconds of emulation */
+constexpr std::uint64_t kMetricsDumpInterval = 7000;
+
+/* Highest UDP port, netplay peers need a port in 1-kMaxPort */
+constexpr std::uint16_t kMaxPort = 0xFFFF;
+
+/* Settings applying to the interpreter, which netplay replaces with its own
+ * session */
+constexpr std::array<const char*, 8> kInterpreterSettings = {
+    "CHIP_8_SPEED",       "CHIP_8_SELF_CHECK_INTERVAL", "CHIP_8_ROM_INDEX",
+    "CHIP_8_PROFILE_PATH", "CHIP_8_METRICS_PATH",       "CHIP_8_TRACE_PATH",
+    "CHIP_8_CAPTURE_PATH", "CHIP_8_EXPORT"};
+
+/* Value of a setting naming a file or shared-memory object, suffixed so
+ * that several instances do not share one. */
+static std::optional<std::string> outputSetting(const char* variable,
+                                                const Instance& instance) {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* value = std::getenv(variable);
+    if (value == nullptr) {
+        return std::nullopt;
+    }
+    return value + instance.suffix;
+}
+
+/* Dump instrumentation counters to CHIP_8_METRICS_PATH when compiled in. */
+static void configureMetrics(Instance& instance) {
+    if constexpr (emu::instrumentation::kEnabled) {
+        const auto kPath = outputSetting("CHIP_8_METRICS_PATH", instance);
+        if (!kPath) {
+            return;
+        }
+
+        // NOLINTNEXTLINE (concurrency-mt-unsafe)
+        const char* format = std::getenv("CHIP_8_METRICS_FORMAT");
+        const auto kFormat =
+            (format != nullptr && std::string_view(format) == "prometheus")
+                ? emu::instrumentation::Format::kPrometheus
+                : emu::instrumentation::Format::kJson;
+
+        instance.interpreter.instrumentation().setDumpTarget(
+            *kPath, kFormat, kMetricsDumpInterval);
+    }
+}
+
+/* Profile the ROM when CHIP_8_PROFILE_PATH is set. */
+static void configureProfiler(emu::Chip8& interpreter) {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    if (std::getenv("CHIP_8_PROFILE_PATH") != nullptr) {
+        interpreter.enableProfiler();
+    }
+}
+
+/* Trace every instruction to CHIP_8_TRACE_PATH when set. */
+static void configureTrace(Instance& instance) {
+    const auto kPath = outputSetting("CHIP_8_TRACE_PATH", instance);
+    if (!kPath) {
+        return;
+    }
+
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* compress = std::getenv("CHIP_8_TRACE_COMPRESS");
+    instance.interpreter.startTrace(
+        *kPath, compress != nullptr && std::string_view(compress) != "0");
+}
+
+/* Record presented frames to CHIP_8_CAPTURE_PATH when set. */
+static void configureCapture(Instance& instance) {
+    if (const auto kPath = outputSetting("CHIP_8_CAPTURE_PATH", instance)) {
+        instance.interpreter.startCapture(*kPath);
+    }
+}
+
+/* Set the speed from CHIP_8_SPEED, a multiplier or "unlimited". */
+static void configureSpeed(emu::Chip8& interpreter) {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* speed = std::getenv("CHIP_8_SPEED");
+    if (speed == nullptr) {
+        return;
+    }
+
+    const std::string_view kSpeed = speed;
+    if (kSpeed == "unlimited") {
+        interpreter.pacing().setUnlimited(true);
+        return;
+    }
+
+    const auto kMultiplier = emu::parse::number<double>(kSpeed);
+    if (!kMultiplier || *kMultiplier <= 0.0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                     "Ignoring CHIP_8_SPEED=%s: expected a positive "
+                     "multiplier or \"unlimited\"",
+                     speed);
+        return;
+    }
+    interpreter.pacing().setMultiplier(*kMultiplier);
+}
+
+/* Fast-forward while Tab is held, F2 and F3 halve and double the speed, F4
+ * restores it. */
+static void handleSpeedKey(emu::Chip8& interpreter,
+                           const SDL_KeyboardEvent& key) {
+    auto& pacing = interpreter.pacing();
+    if (key.scancode == SDL_SCANCODE_TAB) {
+        pacing.setUnlimited(key.down);
+        return;
+    }
+    if (!key.down || key.repeat) {
+        return;
+    }
+
+    switch (key.scancode) {
+        case SDL_SCANCODE_F2:
+            pacing.setMultiplier(pacing.multiplier() / 2.0);
+            break;
+        case SDL_SCANCODE_F3:
+            pacing.setMultiplier(pacing.multiplier() * 2.0);
+            break;
+        case SDL_SCANCODE_F4:
+            pacing.setMultiplier(1.0);
+            break;
+        default:
+            return;
+    }
+    SDL_Log("Speed %gx", pacing.multiplier());
+}
+
+/* Cxkk seed from CHIP_8_SEED, decimal or 0x hexadecimal. */
+static std::uint32_t seedSetting() {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* seed = std::getenv("CHIP_8_SEED");
+    if (seed == nullptr) {
+        return emu::random::kDefaultSeed;
+    }
+    const auto kSeed = emu::parse::literal<std::uint32_t>(seed);
+    if (!kSeed) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                     "Ignoring CHIP_8_SEED=%s: expected a 32-bit number",
+                     seed);
+        return emu::random::kDefaultSeed;
+    }
+    return *kSeed;
+}
+
+/* Cxkk generator, CHIP_8_RANDOM=vip selects the VIP one. */
+static emu::random::Mode randomSetting() {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* mode = std::getenv("CHIP_8_RANDOM");
+    return mode != nullptr && std::string_view(mode) == "vip"
+               ? emu::random::Mode::kCosmacVip
+               : emu::random::Mode::kXorshift;
+}
+
+/* Seed Cxkk from CHIP_8_SEED and CHIP_8_RANDOM. */
+static void configureRandom(emu::Chip8& interpreter) {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    if (std::getenv("CHIP_8_SEED") == nullptr &&
+        // NOLINTNEXTLINE (concurrency-mt-unsafe)
+        std::getenv("CHIP_8_RANDOM") == nullptr) {
+        return;
+    }
+    interpreter.seed(seedSetting(), randomSetting());
+}
+
+/* Replay one in CHIP_8_SELF_CHECK_INTERVAL steps on the reference path. */
+static void configureSelfCheck(emu::Chip8& interpreter) {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* interval = std::getenv("CHIP_8_SELF_CHECK_INTERVAL");
+    if (interval == nullptr) {
+        return;
+    }
+    const auto kInterval = emu::parse::number<std::uint32_t>(interval);
+    if (!kInterval) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                     "Ignoring CHIP_8_SELF_CHECK_INTERVAL=%s: expected a "
+                     "32-bit number",
+                     interval);
+        return;
+    }
+    interpreter.enableSelfCheck(*kInterval);
+}
+
+/* Publish frames to the shared-memory object named by CHIP_8_EXPORT. */
+static void configureExport(Instance& instance) {
+    const auto kName = outputSetting("CHIP_8_EXPORT", instance);
+    if (!kName) {
+        return;
+    }
+
+    try {
+        instance.interpreter.enableExport(*kName);
+    } catch (const std::exception& error) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s", error.what());
+    }
+}
+
+/* Play the ROM with the cabinet at CHIP_8_NETPLAY_PEER=host:port, from
+ * CHIP_8_NETPLAY_PORT. Both run the same ROM, seed and input delay. */
+static void configureNetplay(Instance& instance,
+                             const std::span<const std::uint8_t> rom) {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* peer = std::getenv("CHIP_8_NETPLAY_PEER");
+    if (peer == nullptr) {
+        return;
+    }
+    const std::string_view kPeer = peer;
+    const auto kColon = kPeer.rfind(':');
+    const auto kPeerPort =
+        kColon == std::string_view::npos
+            ? std::nullopt
+            : emu::parse::bounded<std::uint16_t>(kPeer.substr(kColon + 1), 1,
+                                                 kMaxPort);
+    if (!kPeerPort) {
+        throw emu::NetplayError(
+            "CHIP_8_NETPLAY_PEER is not host:port with a port in 1-65535");
+    }
+
+    emu::netplay::Config config;
+    config.seed = seedSetting();
+    config.random = randomSetting();
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    if (const char* delay = std::getenv("CHIP_8_NETPLAY_DELAY")) {
+        const auto kDelay = emu::parse::bounded<std::size_t>(
+            delay, 0, emu::netplay::kMaxRollback);
+        if (!kDelay) {
+            throw emu::NetplayError(
+                "CHIP_8_NETPLAY_DELAY is not a number of frames in 0-8");
+        }
+        config.input_delay = *kDelay;
+    }
+
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* port = std::getenv("CHIP_8_NETPLAY_PORT");
+    const auto kPort = port == nullptr
+                           ? std::optional<std::uint16_t>(0)
+                           : emu::parse::number<std::uint16_t>(port);
+    if (!kPort) {
+        throw emu::NetplayError("CHIP_8_NETPLAY_PORT is not a port in 0-65535");
+    }
+
+    instance.session = std::make_unique<emu::netplay::Session>(rom, config);
+    instance.connection = std::make_unique<emu::netplay::Connection>(*kPort);
+    instance.connection->connect(std::string(kPeer.substr(0, kColon)),
+                                 *kPeerPort);
+}
+
+/* Run the ROM with its profile from the CHIP_8_ROM_INDEX index, if any. */
+static void configureProfile(emu::Chip8& interpreter,
+                             const std::span<const std::uint8_t> rom) {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* path = std::getenv("CHIP_8_ROM_INDEX");
+    if (path == nullptr) {
+        return;
+    }
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return;
+    }
+
+    try {
+        const auto kIndex = emu::rom::Index::load(file);
+        if (const auto* entry = kIndex.find(emu::rom::contentHash(rom))) {
+            interpreter.configure(entry->profile);
+        }
+    } catch (const std::exception& error) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Ignoring %s: %s", path,
+                    error.what());
+    }
+}
+
+/* Report the instruction that stopped the machine. */
+static void logFault(const emu::fault::Fault& fault) {
+    const auto kDescription = emu::fault::describe(fault.status);
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%.*s: 0x%04X at 0x%03X",
+                 static_cast<int>(kDescription.size()), kDescription.data(),
+                 fault.bytecode, fault.address);
+}
+
+/* Write <path>.folded and <path>.pgm from the running profile. */
+static void saveProfile(const Instance& instance) {
+    const auto kPath = outputSetting("CHIP_8_PROFILE_PATH", instance);
+    const auto* profiler = instance.interpreter.profiler();
+    if (!kPath || profiler == nullptr) {
+        return;
+    }
+
+    std::ofstream folded(*kPath + ".folded");
+    profiler->writeFolded(folded);
+
+    std::ofstream heat_map(*kPath + ".pgm");
+    profiler->writeHeatMap(heat_map);
+}
+
+/* Log the input-to-photon latency percentiles when compiled in. */
+template <typename Recorder>
+static void logInputLatency(const Recorder& recorder) {
+    if constexpr (emu::instrumentation::kEnabled) {
+        const auto& snapshot = recorder.snapshot();
+        if (snapshot.key_to_present.latency.count == 0) {
+            return;
+        }
+
+        constexpr double kMilliseconds = 1e6;
+        const auto kMs = [](const emu::instrumentation::Histogram& histogram,
+                            const double quantile) {
+            return static_cast<double>(histogram.quantile(quantile)) /
+                   kMilliseconds;
+        };
+        SDL_Log(
+            "Input latency over %llu key events on the %s interpreter "
+            "(p50/p99 ms): read %.2f/%.2f, draw %.2f/%.2f, present %.2f/%.2f",
+            emu::instrumentation::kEngine,
+            static_cast<unsigned long long>(
+                snapshot.key_to_present.latency.count),
+            kMs(snapshot.key_to_read, 0.5), kMs(snapshot.key_to_read, 0.99),
+            kMs(snapshot.key_to_draw, 0.5), kMs(snapshot.key_to_draw, 0.99),
+            kMs(snapshot.key_to_present, 0.5),
+            kMs(snapshot.key_to_present, 0.99));
+    }
+}
+
+/* Frontend names from CHIP_8_FRONTEND, a comma-separated list of
+ * sdl|terminal|null with one entry per instance, the last one repeating. */
+static std::vector<std::string_view> frontendNames(const std::size_t count) {
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    const char* list = std::getenv("CHIP_8_FRONTEND");
+    std::string_view rest = list == nullptr ? "sdl" : list;
+
+    std::vector<std::string_view> names;
+    while (names.size() < count) {
+        const auto kComma = rest.find(',');
+        names.push_back(rest.substr(0, kComma));
+        if (kComma != std::string_view::npos) {
+            rest.remove_prefix(kComma + 1);
+        }
+    }
+    return names;
+}
+
+/* Create a frontend by name, only the last window syncs to the display so
+ * presenting several in a row waits for one vertical blank. */
+static bool configureFrontend(Frontend& frontend,
+                              const std::string_view name,
+                              const bool vsync) {
+    if (name == "null") {
+        frontend.emplace<emu::frontend::Null>();
+        return true;
+    }
+    if (name == "terminal") {
+        frontend.emplace<emu::frontend::Terminal>(
+            std::cout, emu::frontend::Terminal::kStandardInput);
+        return true;
+    }
+    if (name != "sdl") {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unknown frontend %.*s",
+                     static_cast<int>(name.size()), name.data());
+        return false;
+    }
+    return frontend.emplace<emu::frontend::Sdl>().init(vsync);
+}
+
+/* Load a ROM into an instance and apply the CHIP_8_* settings to it. */
+static bool configureInstance(Instance& instance, const char* path) {
+    auto& interpreter = instance.interpreter;
+    std::vector<std::uint8_t> rom;
+    try {
+        rom = emu::rom::read(path);
+        interpreter.load(rom);
+    } catch (const std::exception& error) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s", error.what());
+        return false;
+    }
+
+#ifdef CHIP_8_ENABLE_AOT
+    if (!interpreter.attach(emu::aot::roms::builtin())) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                    "Loaded ROM differs from CHIP_8_AOT_ROM, interpreting it");
+    }
+#endif
+
+    // NOLINTNEXTLINE (concurrency-mt-unsafe)
+    if (std::getenv("CHIP_8_NETPLAY_PEER") != nullptr) {
+        for (const char* setting : kInterpreterSettings) {
+            // NOLINTNEXTLINE (concurrency-mt-unsafe)
+            if (std::getenv(setting) != nullptr) {
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION,
+                            "Ignoring %s, netplay runs its own session",
+                            setting);
+            }
+        }
+
+        try {
+            configureNetplay(instance, rom);
+        } catch (const std::exception& error) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s", error.what());
+            return false;
+        }
+        return true;
+    }
+
+    configureProfile(interpreter, rom);
+    configureMetrics(instance);
+    configureProfiler(interpreter);
+    configureSelfCheck(interpreter);
+    configureRandom(interpreter);
+    configureSpeed(interpreter);
+    configureExport(instance);
+
+    try {
+        configureTrace(instance);
+        configureCapture(instance);
+    } catch (const std::exception& error) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Recording failed: %s",
+                     error.what());
+        return false;
+    }
+
+    return true;
+}
 
 /* This function runs once at startup. */
-SDL_AppResult SDL_AppInit(void** /*appstate*/, int /*argc*/, char* /*argv*/[]) {
-    if (!SDL_Init(SDL_INIT_VIDEO)) {
-        return SDL_APP_FAILURE;
+SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[]) {
+    // Released by SDL_AppQuit, which also runs when initialization fails
+    auto* app = new App();  // NOLINT (cppcoreguidelines-owning-memory)
+    *appstate = app;
+
+    // One instance per ROM on the command line
+    std::vector<const char*> roms;
+    for (int arg = 1; arg < argc; arg++) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        roms.push_back(argv[arg]);
+    }
+    if (roms.empty()) {
+        roms.push_back(kDefaultRom);
     }
 
-    if (!g_interpreter.init()) {
+    const auto kNames = frontendNames(roms.size());
+    if (std::count(kNames.begin(), kNames.end(), "terminal") > 1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION,
+                     "Only one instance can use the terminal");
         return SDL_APP_FAILURE;
     }
-
-    if (g_interpreter.load() != 0) {
+    // Instances up to and including the last window, which syncs
+    const auto kSynced = static_cast<std::size_t>(
+        kNames.rend() - std::find(kNames.rbegin(), kNames.rend(), "sdl"));
+    if (!SDL_Init(kSynced == 0 ? SDL_INIT_EVENTS : SDL_INIT_VIDEO)) {
         return SDL_APP_FAILURE;
     }
 
+    for (std::size_t index = 0; index < roms.size(); index++) {
+        auto& instance =
+            *app->instances.emplace_back(std::make_unique<Instance>());
+        if (roms.size() > 1) {
+            instance.suffix = "." + std::to_string(index);
+        }
+
+        if (!configureFrontend(instance.frontend, kNames[index],
+                               index + 1 == kSynced) ||
+            !configureInstance(instance, roms[index])) {
+            return SDL_APP_FAILURE;
+        }
+    }
+
+    app->pool = std::make_unique<emu::WorkerPool>(std::min<std::size_t>(
+        roms.size(),
+        std::max<std::size_t>(std::thread::hardware_concurrency(), 1)));
+
     return SDL_APP_CONTINUE;
 }
 
+/* Whether an event from a window is meant for an instance, instances
+ * without a window take every event. */
+static bool addressed(const Instance& instance, const SDL_WindowID window) {
+    const auto* sdl = std::get_if<emu::frontend::Sdl>(&instance.frontend);
+    return sdl == nullptr || sdl->owns(window);
+}
+
 /* This function runs when a new event (mouse input, keypresses, etc) occurs. */
-SDL_AppResult SDL_AppEvent(void* /*appstate*/, SDL_Event* event) {
-    if (event->type == SDL_EVENT_QUIT) {
+SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
+    if (event->type == SDL_EVENT_QUIT ||
+        event->type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) {
         return SDL_APP_SUCCESS; /* end the program, reporting success to the OS.
                                  */
     }
+    if (event->type == SDL_EVENT_KEY_DOWN || event->type == SDL_EVENT_KEY_UP) {
+        const auto kScancode = static_cast<std::size_t>(event->key.scancode);
+        for (auto& instance : static_cast<App*>(appstate)->instances) {
+            if (!addressed(*instance, event->key.windowID)) {
+                continue;
+            }
+            handleSpeedKey(instance->interpreter, event->key);
+            // Start of the input-to-photon latency measurement
+            if (!event->key.repeat && emu::keyboard::mapped(kScancode)) {
+                instance->interpreter.instrumentation().keyEvent();
+            }
+        }
+    }
     return SDL_APP_CONTINUE;
 }
 
-/* This function runs once per frame, and is the heart of the program. */
-SDL_AppResult SDL_AppIterate(void* /*appstate*/) {
+/* Run one netplay frame: take in the peer's keys, run the next frame with
+ * ours unless too far ahead of the peer, and send them right away. */
+template <emu::frontend::Frontend Output>
+static emu::fault::Status play(Instance& instance, Output& output) {
+    auto& session = *instance.session;
+    instance.connection->exchange(session);
+    if (session.advance(output.poll())) {
+        output.present(session.display());
+    }
+    instance.connection->exchange(session);
+
+    return session.state().fault.status;
+}
+
+/* Run one frame of an instance, on any thread. Instances with a window draw
+ * into their offscreen target. */
+static void emulate(Instance& instance) noexcept {
+    if (!instance.running) {
+        return;
+    }
+
+    const auto kFrame = [&instance](auto& output) {
+        return instance.session ? play(instance, output)
+                                : instance.interpreter.frame(output);
+    };
+
     try {
-        g_interpreter.cycle();
+        instance.status = std::visit(
+            [&instance, &kFrame]<typename Output>(Output& frontend) {
+                if constexpr (std::is_same_v<Output, emu::frontend::Sdl>) {
+                    return kFrame(instance.target);
+                } else {
+                    return kFrame(frontend);
+                }
+            },
+            instance.frontend);
     } catch (const std::exception& error) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Chip8::cycle failed: %s",
-                     error.what());
+        // Emulated faults are not exceptions, only host errors such as
+        // failed trace writes get here
+        instance.error = error.what();
+    }
+}
+
+/* Show the frame an instance drew on its window, on the main thread, and
+ * report why it stopped, if it did. */
+static void finish(Instance& instance) {
+    if (!instance.running) {
+        return;
+    }
+
+    if (auto* sdl = std::get_if<emu::frontend::Sdl>(&instance.frontend)) {
+        if (const auto* display = instance.target.take()) {
+            sdl->present(*display);
+            instance.interpreter.instrumentation().framePresented();
+        }
+        if (instance.target.beeping() != instance.beeping) {
+            instance.beeping = !instance.beeping;
+            sdl->beep(instance.beeping);
+        }
+    }
+
+    if (!instance.error.empty()) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Chip8::frame failed: %s",
+                     instance.error.c_str());
+        instance.running = false;
+    } else if (instance.status != emu::fault::Status::kNone) {
+        logFault(instance.session ? instance.session->state().fault
+                                  : instance.interpreter.fault());
+        instance.running = false;
+    }
+}
+
+/* Wait off the rest of the frame on the last paced frontend. A window with
+ * vsync returns at once if it presented, presenting already waited. Either
+ * way the overshoot is how far past the end of the frame the wait ended. */
+static void waitFrame(App& app, const emu::pacing::Clock::time_point start) {
+    for (auto it = app.instances.rbegin(); it != app.instances.rend(); it++) {
+        auto& instance = **it;
+        const bool kPaced = std::visit(
+            [&instance, start]<typename Output>(Output& frontend) {
+                if constexpr (Output::kPaced) {
+                    bool synced = false;
+                    if constexpr (std::is_same_v<Output,
+                                                 emu::frontend::Sdl>) {
+                        synced = frontend.synced();
+                    }
+                    const emu::frontend::Duration kElapsed =
+                        emu::pacing::Clock::now() - start;
+                    if (kElapsed >= emu::pacing::kFrameInterval && !synced) {
+                        return true;
+                    }
+
+                    frontend.wait(
+                        std::max(emu::pacing::kFrameInterval - kElapsed,
+                                 emu::frontend::Duration::zero()));
+
+                    if constexpr (emu::instrumentation::kEnabled) {
+                        instance.interpreter.instrumentation().slept(
+                            std::chrono::duration_cast<
+                                std::chrono::nanoseconds>(
+                                emu::pacing::kFrameInterval),
+                            std::chrono::duration_cast<
+                                std::chrono::nanoseconds>(
+                                emu::pacing::Clock::now() - start));
+                    }
+                    return true;
+                } else {
+                    return false;
+                }
+            },
+            instance.frontend);
+        if (kPaced) {
+            return;
+        }
+    }
+}
+
+/* This function runs once per frame, and is the heart of the program. The
+ * instances run the instructions owed since the last frame on the worker
+ * pool, then this thread presents them. */
+SDL_AppResult SDL_AppIterate(void* appstate) {
+    auto& app = *static_cast<App*>(appstate);
+    const auto kStart = emu::pacing::Clock::now();
+
+    for (auto& instance : app.instances) {
+        if (const auto* sdl =
+                std::get_if<emu::frontend::Sdl>(&instance->frontend)) {
+            instance->target.hold(sdl->poll());
+        }
+    }
+
+    auto run = [&app](const std::size_t begin, const std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            emulate(*app.instances[index]);
+        }
+    };
+    app.pool->run(app.instances.size(), run);
+
+    bool running = false;
+    for (auto& instance : app.instances) {
+        finish(*instance);
+        running = running || instance->running;
+    }
+    if (!running) {
         return SDL_APP_FAILURE;
     }
 
+    waitFrame(app, kStart);
     return SDL_APP_CONTINUE;
 }
 
 /* This function runs once at shutdown. */
-void SDL_AppQuit(void* /*appstate*/, SDL_AppResult /*result*/) {
-    g_interpreter.shutdown();
+void SDL_AppQuit(void* appstate, SDL_AppResult /*result*/) {
+    // NOLINTNEXTLINE (cppcoreguidelines-owning-memory)
+    std::unique_ptr<App> app(static_cast<App*>(appstate));
+    if (app) {
+        for (const auto& instance : app->instances) {
+            saveProfile(*instance);
+            logInputLatency(instance->interpreter.instrumentation());
+            instance->interpreter.shutdown();
+        }
+    }
 
+    // Frontends release their SDL resources before SDL_Quit
+    app.reset();
     SDL_Quit();
 }
@@ -0,0 +1,18 @@
+; Shows the digit of each key pressed and counts presses, so scripted input
+; ends up in the golden hashes
+start:
+    CLS
+    LD V0, K          ; stalls until a key is down
+    LD F, V0
+    LD V1, 28
+    LD V2, 12
+    DRW V1, V2, 5
+release:
+    SKNP V0
+    JP release
+    ADD V3, 1
+    LD I, presses
+    LD B, V3
+    JP start
+presses:
+    db 0, 0, 0
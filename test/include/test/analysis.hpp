@@ -0,0 +1,135 @@
+#ifndef TEST_ANALYSIS_HPP
+#define TEST_ANALYSIS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/block_cache.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/memory.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::analysis::test {
+
+inline std::vector<std::uint8_t> rom(
+    const std::initializer_list<std::uint16_t> bytecodes) {
+    std::vector<std::uint8_t> bytes;
+    for (const auto kBytecode : bytecodes) {
+        bytes.push_back(static_cast<std::uint8_t>(kBytecode >> 8U));
+        bytes.push_back(static_cast<std::uint8_t>(kBytecode & 0xFFU));
+    }
+    return bytes;
+}
+
+// 200: LD I, 0x20E
+// 202: CALL 0x20A
+// 204: ADD V0, 1      <- loop
+// 206: JP 0x204
+// 208: 0000           unreachable
+// 20A: DRW V0, V1, 2  <- subroutine
+// 20C: RET
+// 20E: F0 90          sprite
+inline std::vector<std::uint8_t> sample() {
+    return rom({0xA20E, 0x220A, 0x7001, 0x1204, 0x0000, 0xD012, 0x00EE,
+                0xF090});
+}
+
+// ============================================================================
+// Analysis
+// ============================================================================
+
+TEST(AnalysisTest, FindsSubroutinesAndLoops) {
+    const auto kAnalysis = analyse(sample());
+
+    ASSERT_EQ(kAnalysis.blocks.size(), 3U);
+    const auto* start = kAnalysis.find(0x200);
+    const auto* loop = kAnalysis.find(0x204);
+    const auto* subroutine = kAnalysis.find(0x20A);
+    ASSERT_NE(start, nullptr);
+    ASSERT_NE(loop, nullptr);
+    ASSERT_NE(subroutine, nullptr);
+
+    EXPECT_EQ(start->call, 0x20A);
+    EXPECT_EQ(start->successors, std::vector<std::uint16_t>{0x204});
+    EXPECT_TRUE(subroutine->subroutine);
+    EXPECT_TRUE(loop->loop_header);
+    EXPECT_FALSE(start->loop_header);
+}
+
+TEST(AnalysisTest, SeparatesCodeFromData) {
+    const auto kAnalysis = analyse(sample());
+
+    EXPECT_EQ(kAnalysis.bytes[0x200], Byte::kCode);
+    EXPECT_EQ(kAnalysis.bytes[0x208], Byte::kUnknown);
+    EXPECT_EQ(kAnalysis.bytes[0x20C], Byte::kCode);
+    // I is only tracked within a block, the draw is in the subroutine
+    EXPECT_EQ(kAnalysis.bytes[0x20E], Byte::kUnknown);
+}
+
+TEST(AnalysisTest, BlockMayRunToEndOfMemory) {
+    // Straight-line code filling all of program space
+    const std::vector<std::uint8_t> kRom(
+        memory::kSize - memory::kProgramSpaceOffset, 0x60);
+
+    const auto kAnalysis = analyse(kRom);
+    ASSERT_FALSE(kAnalysis.blocks.empty());
+    EXPECT_EQ(kAnalysis.blocks.back().end, memory::kSize);
+}
+
+TEST(AnalysisTest, MarksSpritesDrawnWithConstantIndex) {
+    // LD I, 0x206; DRW V0, V0, 2; JP 0x200; sprite
+    const auto kAnalysis = analyse(rom({0xA206, 0xD002, 0x1200, 0xF090}));
+
+    EXPECT_EQ(kAnalysis.bytes[0x206], Byte::kSprite);
+    EXPECT_EQ(kAnalysis.bytes[0x207], Byte::kSprite);
+}
+
+TEST(AnalysisTest, WritesListingAndDot) {
+    const auto kAnalysis = analyse(sample());
+
+    std::stringstream listing;
+    writeListing(listing, kAnalysis);
+    EXPECT_NE(listing.str().find("sub_20A:  ; subroutine"), std::string::npos);
+    EXPECT_NE(listing.str().find("0x20A  D012  DRW V0, V1, 2"),
+              std::string::npos);
+
+    std::stringstream dot;
+    writeDot(dot, kAnalysis);
+    EXPECT_NE(dot.str().find("b200 -> b20A [style=dashed];"),
+              std::string::npos);
+    EXPECT_NE(dot.str().find("b204 -> b204 [style=bold];"), std::string::npos);
+}
+
+TEST(AnalysisTest, DisassemblesEveryGroup) {
+    EXPECT_EQ(disassemble(0x00E0), "CLS");
+    EXPECT_EQ(disassemble(0x8AB4), "ADD VA, VB");
+    EXPECT_EQ(disassemble(0xB300), "JP V0, 0x300");
+    EXPECT_EQ(disassemble(0xE19E), "SKP V1");
+    EXPECT_EQ(disassemble(0xF265), "LD V2, [I]");
+    EXPECT_EQ(disassemble(0x8008), "DW 0x8008");
+}
+
+TEST(AnalysisTest, BlockCachePretranslatesBlocks) {
+    emu::ChipState state;
+    const auto kRom = sample();
+    std::ranges::copy(kRom, std::next(state.memory.begin(), 0x200));
+
+    emu::block_cache::BlockCache cache;
+    cache.pretranslate(state.memory, analyse(kRom));
+
+    EXPECT_NE(cache.find(0x200), nullptr);
+    EXPECT_NE(cache.find(0x204), nullptr);
+    EXPECT_NE(cache.find(0x20A), nullptr);
+    EXPECT_EQ(cache.find(0x208), nullptr);
+}
+
+}  // namespace emu::analysis::test
+
+#endif /* TEST_ANALYSIS_HPP */
@@ -0,0 +1,137 @@
+#ifndef TEST_ASSEMBLER_HPP
+#define TEST_ASSEMBLER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+#include "chip_8/assembler.hpp"
+#include "chip_8/block_cache.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/opcode.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::assembler::test {
+
+/**
+ * @brief Run an assembled program on the block cache until it reaches the
+ * halt label
+ *
+ * @param program
+ * @param max_blocks gives up after that many blocks
+ * @return final state
+ */
+inline emu::ChipState runToHalt(const Program& program,
+                                const std::size_t max_blocks = 1'000'000) {
+    emu::ChipState state;
+    std::ranges::copy(program.bytes, std::next(state.memory.begin(), 0x200));
+
+    const auto kHalt = program.labels.find(kHaltLabel)->second;
+    emu::block_cache::BlockCache cache;
+    for (std::size_t block = 0;
+         block < max_blocks && state.program_counter != kHalt; ++block) {
+        // Timers tick once per retired instruction, as in Chip8::cycle()
+        const auto kRetired = cache.step(state);
+        state.delay_timer = static_cast<std::uint8_t>(
+            state.delay_timer - std::min<std::size_t>(kRetired, state.delay_timer));
+    }
+    return state;
+}
+
+// ============================================================================
+// Assembly
+// ============================================================================
+
+TEST(AssemblerTest, RoundTripsEveryInstruction) {
+    for (std::uint32_t bytecode = 0; bytecode <= 0xFFFF; ++bytecode) {
+        const auto kBytecode = static_cast<std::uint16_t>(bytecode);
+        if (opcode::identify(kBytecode) == opcode::Id::kInvalid) {
+            continue;
+        }
+
+        // Bits the instruction ignores are lost, so compare the text
+        const auto kSource = analysis::disassemble(kBytecode);
+        const auto kProgram = assemble(kSource);
+        ASSERT_EQ(kProgram.bytes.size(), 2U) << kSource;
+        EXPECT_EQ(analysis::disassemble(static_cast<std::uint16_t>(
+                      (kProgram.bytes[0] << 8U) | kProgram.bytes[1])),
+                  kSource);
+    }
+}
+
+TEST(AssemblerTest, ResolvesLabelsAndData) {
+    const auto kProgram = assemble(
+        "start:  ld i, sprite   ; forward reference\n"
+        "        DRW V0, V1, 2\n"
+        "loop:   jp loop\n"
+        "sprite: db 0xF0, 0b10010000\n"
+        "        dw 1234\n");
+
+    EXPECT_EQ(kProgram.labels.at("start"), 0x200);
+    EXPECT_EQ(kProgram.labels.at("loop"), 0x204);
+    EXPECT_EQ(kProgram.labels.at("sprite"), 0x206);
+    EXPECT_EQ(kProgram.bytes, (std::vector<std::uint8_t>{0xA2, 0x06, 0xD0,
+                                                         0x12, 0x12, 0x04,
+                                                         0xF0, 0x90, 0x04,
+                                                         0xD2}));
+}
+
+TEST(AssemblerTest, ReportsErrorsWithLine) {
+    EXPECT_THROW(assemble("CLS\nFOO V0"), AssemblyError);
+    EXPECT_THROW(assemble("JP nowhere"), AssemblyError);
+    EXPECT_THROW(assemble("LD V0, 256"), AssemblyError);
+    EXPECT_THROW(assemble("DRW V0, V1, 16"), AssemblyError);
+    EXPECT_THROW(assemble("a: CLS\na: RET"), AssemblyError);
+    EXPECT_THROW(assemble("ADD V0"), AssemblyError);
+
+    try {
+        assemble("CLS\n\nLD VG, 1");
+        FAIL();
+    } catch (const AssemblyError& error) {
+        EXPECT_EQ(std::string(error.what()).rfind("line 3:", 0), 0U);
+    }
+}
+
+// ============================================================================
+// Workloads
+// ============================================================================
+
+TEST(AssemblerTest, WorkloadsAreDeterministic) {
+    EXPECT_EQ(generate(Workload::kDraw, 4), generate(Workload::kDraw, 4));
+    EXPECT_NE(generate(Workload::kDraw, 4), generate(Workload::kDraw, 5));
+}
+
+TEST(AssemblerTest, WorkloadsRunToHalt) {
+    constexpr std::uint8_t kRounds = 3;
+
+    const auto kAlu = runToHalt(assemble(generate(Workload::kAlu, kRounds)));
+    EXPECT_EQ(kAlu.V[0], kRounds);
+    // The result is drawn before halting
+    EXPECT_TRUE(std::ranges::any_of(kAlu.display.rows,
+                                    [](const auto kRow) { return kRow != 0; }));
+
+    const auto kCall = runToHalt(assemble(generate(Workload::kCall, kRounds)));
+    EXPECT_EQ(kCall.V[0], kRounds);
+    EXPECT_EQ(kCall.V[6], (kRounds * 64U) & 0xFFU);
+    EXPECT_TRUE(kCall.stack.empty());
+
+    const auto kTimer =
+        runToHalt(assemble(generate(Workload::kTimerWait, kRounds)));
+    EXPECT_EQ(kTimer.V[0], kRounds);
+    EXPECT_EQ(kTimer.delay_timer, 0U);
+
+    const auto kDraw = runToHalt(assemble(generate(Workload::kDraw, kRounds)));
+    EXPECT_EQ(kDraw.V[0], kRounds);
+    EXPECT_TRUE(std::ranges::any_of(kDraw.display.rows,
+                                    [](const auto kRow) { return kRow != 0; }));
+}
+
+}  // namespace emu::assembler::test
+
+#endif /* TEST_ASSEMBLER_HPP */
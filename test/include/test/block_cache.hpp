@@ -0,0 +1,150 @@
+#ifndef TEST_BLOCK_CACHE_HPP
+#define TEST_BLOCK_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "chip_8/block_cache.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/lockstep.hpp"
+#include "chip_8/memory.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::block_cache::test {
+
+class BlockCacheTest : public ::testing::Test {
+   protected:
+    emu::ChipState state_;
+    BlockCache cache_;
+
+    void SetUp() override { state_ = emu::ChipState(); }
+
+    void load(const std::uint16_t address,
+              const std::initializer_list<std::uint16_t> bytecodes) {
+        auto target = address;
+        for (const auto kBytecode : bytecodes) {
+            state_.memory[target] = static_cast<std::uint8_t>(kBytecode >> 8U);
+            state_.memory[target + 1U] =
+                static_cast<std::uint8_t>(kBytecode & 0xFFU);
+            target += 2;
+        }
+    }
+};
+
+// ============================================================================
+// Translation
+// ============================================================================
+
+TEST_F(BlockCacheTest, BlockEndsAtControlFlow) {
+    // LD V0, 1; ADD V0, 1; SE V0, 2; CLS
+    load(0x200, {0x6001, 0x7001, 0x3002, 0x00E0});
+
+    const auto kBlock = translate(state_.memory, 0x200);
+    EXPECT_EQ(kBlock.entry, 0x200);
+    EXPECT_EQ(kBlock.end, 0x206);
+    EXPECT_EQ(kBlock.ops.size(), 3U);
+}
+
+TEST_F(BlockCacheTest, StepRunsWholeBlock) {
+    load(0x200, {0x6001, 0x7001, 0x3002, 0x00E0, 0x1200});
+
+    // The skip is taken, so CLS is not part of the block
+    EXPECT_EQ(cache_.step(state_), 3U);
+    EXPECT_EQ(state_.V[0], 2U);
+    EXPECT_EQ(state_.program_counter, 0x208);
+}
+
+TEST_F(BlockCacheTest, TimedOpsSeeTimersTickedPerInstruction) {
+    // LD V0, 5; LD DT, V0; LD V1, DT; LD V2, DT; JP 0x208
+    load(0x200, {0x6005, 0xF015, 0xF107, 0xF207, 0x1208});
+
+    auto reference = state_;
+    for (std::size_t i = 0; i < 5; i++) {
+        lockstep::stepReference(reference);
+        timers::tick(reference, 1);
+    }
+
+    for (std::size_t retired = 0; retired < 5;) {
+        const auto kRetired = cache_.step(state_);
+        timers::tick(state_, kRetired);
+        retired += kRetired;
+    }
+    EXPECT_EQ(reference.V[1], 4U);
+    EXPECT_EQ(state_.V[1], reference.V[1]);
+    EXPECT_EQ(state_.V[2], reference.V[2]);
+    EXPECT_EQ(state_.delay_timer, reference.delay_timer);
+}
+
+TEST_F(BlockCacheTest, TracksCodePages) {
+    load(0x200, {0x6001, 0x1200});
+    load(0x7C0, {0x6002, 0x1200});
+
+    cache_.lookup(state_.memory, 0x200);
+    cache_.lookup(state_.memory, 0x7C0);
+
+    EXPECT_EQ(cache_.codePages(), (1ULL << 8U) | (1ULL << 31U));
+
+    cache_.invalidate();
+    EXPECT_EQ(cache_.codePages(), 0U);
+    EXPECT_EQ(cache_.find(0x200), nullptr);
+}
+
+// ============================================================================
+// Self-modifying code
+// ============================================================================
+
+TEST_F(BlockCacheTest, DataWritesKeepBlocks) {
+    load(0x200, {0x6001, 0x1200});
+    cache_.lookup(state_.memory, 0x200);
+
+    cache_.invalidate(0x800, 16);
+    EXPECT_NE(cache_.find(0x200), nullptr);
+}
+
+TEST_F(BlockCacheTest, CodeWritesDropOnlyOverlappingBlocks) {
+    load(0x200, {0x6001, 0x1210});
+    load(0x210, {0x6002, 0x1200});
+    cache_.lookup(state_.memory, 0x200);
+    cache_.lookup(state_.memory, 0x210);
+
+    cache_.invalidate(0x212, 1);
+    EXPECT_NE(cache_.find(0x200), nullptr);
+    EXPECT_EQ(cache_.find(0x210), nullptr);
+}
+
+TEST_F(BlockCacheTest, WrappedBlockIsDroppedByWritesToTheStart) {
+    // LD V0, 1 split across the last and the first byte of memory
+    state_.memory[0xFFF] = 0x60;
+    state_.memory[0x000] = 0x01;
+
+    const auto& block = cache_.lookup(state_.memory, 0xFFF);
+    EXPECT_EQ(block.end, memory::kSize + 1U);
+    EXPECT_EQ(cache_.codePages(), (1ULL << 63U) | 1ULL);
+
+    cache_.invalidate(0x000, 1);
+    EXPECT_EQ(cache_.find(0xFFF), nullptr);
+    EXPECT_EQ(cache_.codePages(), 0U);
+}
+
+TEST_F(BlockCacheTest, SelfModifyingBlockIsRetranslated) {
+    // LD I, 0x207; LD [I], V0; LD VA, 1; LD VB, 1; JP 0x200
+    load(0x200, {0xA207, 0xF055, 0x6A01, 0x6B01, 0x1200});
+    state_.V[0] = 0x02;
+
+    // The block stops right after overwriting its own tail
+    EXPECT_EQ(cache_.step(state_), 2U);
+    EXPECT_EQ(state_.program_counter, 0x204);
+    EXPECT_EQ(cache_.find(0x200), nullptr);
+
+    // 0x206 now reads 6B02
+    EXPECT_EQ(cache_.step(state_), 3U);
+    EXPECT_EQ(state_.V[0xA], 0x01);
+    EXPECT_EQ(state_.V[0xB], 0x02);
+    EXPECT_EQ(state_.program_counter, 0x200);
+}
+
+}  // namespace emu::block_cache::test
+
+#endif /* TEST_BLOCK_CACHE_HPP */
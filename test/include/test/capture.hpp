@@ -0,0 +1,128 @@
+#ifndef TEST_CAPTURE_HPP
+#define TEST_CAPTURE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "chip_8/capture.hpp"
+#include "chip_8/display.hpp"
+#include "chip_8/error.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::capture::test {
+
+TEST(CaptureTest, RoundTripsFramesAsDeltas) {
+    std::vector<Frame> frames(3, Frame{});
+    frames[0].timestamp = 16667;
+    frames[0].rows[0] = 0xF000000000000001ULL;
+    frames[0].rows[31] = 0x00FF000000000000ULL;
+    // Unchanged picture
+    frames[1] = frames[0];
+    frames[1].timestamp = 33333;
+    // Sprite moved one row down
+    frames[2] = frames[1];
+    frames[2].timestamp = 50000;
+    frames[2].rows[1] = frames[2].rows[0];
+    frames[2].rows[0] = 0;
+
+    std::stringstream stream;
+    Writer writer(stream);
+    writer.write(frames);
+    constexpr std::size_t kHeader = 12;
+    // Time, row mask, per row byte mask and changed bytes
+    EXPECT_EQ(stream.str().size(), kHeader + (3 + 5 + 1 + 2 + 1 + 1) +
+                                       (3 + 1) + (3 + 1 + 1 + 2 + 1 + 2));
+
+    Reader reader(stream);
+    Frame frame{};
+    for (const auto& expected : frames) {
+        ASSERT_TRUE(reader.next(frame));
+        EXPECT_EQ(frame.timestamp, expected.timestamp);
+        EXPECT_EQ(frame.rows, expected.rows);
+    }
+    EXPECT_FALSE(reader.next(frame));
+
+    std::stringstream truncated(stream.str().substr(0, kHeader + 4));
+    Reader truncated_reader(truncated);
+    EXPECT_THROW(truncated_reader.next(frame), CaptureFormatError);
+
+    std::stringstream other(std::string("C8TRACE\0\1\0\0\0", 12));
+    EXPECT_THROW(Reader{other}, CaptureFormatError);
+}
+
+TEST(CaptureTest, MarksDroppedFrames) {
+    std::vector<Frame> frames(2, Frame{});
+    frames[1].timestamp = 50000;
+    frames[1].rows[3] = 1;
+    frames[1].dropped = 2;
+
+    std::stringstream stream;
+    Writer writer(stream);
+    writer.write(frames);
+    writer.gap(3);
+
+    Reader reader(stream);
+    Frame frame{};
+    ASSERT_TRUE(reader.next(frame));
+    EXPECT_EQ(frame.dropped, 0U);
+    ASSERT_TRUE(reader.next(frame));
+    EXPECT_EQ(frame.dropped, 2U);
+    EXPECT_EQ(frame.timestamp, 50000U);
+    EXPECT_EQ(frame.rows, frames[1].rows);
+    EXPECT_FALSE(reader.next(frame));
+    EXPECT_EQ(reader.dropped(), 5U);
+}
+
+TEST(CaptureTest, RecorderReportsWriteFailures) {
+    // Every write to /dev/full fails for lack of space
+    if (!std::filesystem::exists("/dev/full")) {
+        GTEST_SKIP();
+    }
+
+    Recorder recorder("/dev/full");
+    recorder.push(display::Display{});
+    recorder.finish();
+    EXPECT_TRUE(recorder.failed());
+}
+
+TEST(CaptureTest, RecorderWritesQueuedFrames) {
+    const auto kPath =
+        std::filesystem::temp_directory_path() / "chip-8-test.c8v";
+
+    display::Display display;
+    {
+        Recorder recorder(kPath);
+        for (std::size_t x = 0; x < 100; x++) {
+            display::setPixel(display, x % display::kWidth, x / 4, true);
+            recorder.push(display);
+        }
+        recorder.finish();
+        EXPECT_EQ(recorder.dropped(), 0U);
+        EXPECT_FALSE(recorder.failed());
+    }
+
+    std::ifstream file(kPath, std::ios::binary);
+    Reader reader(file);
+    Frame frame{};
+    std::size_t frames = 0;
+    std::uint64_t timestamp = 0;
+    for (; reader.next(frame); frames++) {
+        EXPECT_GE(frame.timestamp, timestamp);
+        timestamp = frame.timestamp;
+    }
+    EXPECT_EQ(frames, 100U);
+    EXPECT_EQ(frame.rows, display.rows);
+    EXPECT_EQ(reader.dropped(), 0U);
+
+    std::filesystem::remove(kPath);
+}
+
+}  // namespace emu::capture::test
+
+#endif /* TEST_CAPTURE_HPP */
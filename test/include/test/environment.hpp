@@ -0,0 +1,127 @@
+#ifndef TEST_ENVIRONMENT_HPP
+#define TEST_ENVIRONMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/environment.hpp"
+#include "chip_8/keyboard.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::environment::test {
+
+// Draws the 0 glyph at a random position, forever
+const std::vector<std::uint8_t> kRandomDraw{
+    0xC0, 0x3F,  // LD V0, rnd & 0x3F
+    0xC1, 0x1F,  // LD V1, rnd & 0x1F
+    0xA0, 0x00,  // LD I, 0
+    0xD0, 0x15,  // DRW V0, V1, 5
+    0x12, 0x00,  // JP 0x200
+};
+
+// Counts in V2, six increments per frame
+const std::vector<std::uint8_t> kCounter{
+    0x72, 0x01,  // ADD V2, 1
+    0x12, 0x00,  // JP 0x200
+};
+
+TEST(EnvironmentTest, BatchMatchesSingleEnvironments) {
+    constexpr std::size_t kSize = 5;
+    constexpr std::uint32_t kSeed = 100;
+
+    Config config;
+    config.frame_skip = 2;
+    Batch batch(kRandomDraw, kSize, 3, config);
+    batch.reset(kSeed);
+
+    std::vector<keyboard::Type> actions(kSize, 0);
+    for (std::size_t index = 0; index < kSize; index++) {
+        Environment single(kRandomDraw, config);
+        EXPECT_EQ(single.reset(kSeed + static_cast<std::uint32_t>(index)),
+                  batch.frames()[index]);
+    }
+
+    std::vector<Environment> singles;
+    singles.reserve(kSize);
+    for (std::size_t index = 0; index < kSize; index++) {
+        singles.emplace_back(kRandomDraw, config);
+        singles.back().reset(kSeed + static_cast<std::uint32_t>(index));
+    }
+
+    for (std::size_t step = 0; step < 20; step++) {
+        batch.step(actions);
+        for (std::size_t index = 0; index < kSize; index++) {
+            const auto kStep = singles[index].step(0);
+            ASSERT_EQ(kStep.frame, batch.frames()[index]) << step;
+            EXPECT_FALSE(kStep.done);
+        }
+    }
+    // Seeds differ, so do the pictures
+    EXPECT_NE(batch.frames()[0], batch.frames()[1]);
+}
+
+TEST(EnvironmentTest, RewardsScoreGainsAndResetsFinishedEpisodes) {
+    Config config;
+    config.frame_skip = 2;
+    config.max_frames = 6;
+    Hooks hooks;
+    hooks.score = [](const ChipState& state) {
+        return static_cast<float>(state.V[2]);
+    };
+    Batch batch(kCounter, 2, 1, config, hooks);
+    batch.reset(1);
+
+    const std::vector<keyboard::Type> kActions(2, 0);
+    for (std::size_t episode = 0; episode < 2; episode++) {
+        for (std::size_t step = 1; step <= 3; step++) {
+            batch.step(kActions);
+            EXPECT_EQ(batch.rewards()[0], 12.0F);
+            EXPECT_EQ(batch.dones()[0], step == 3 ? 1 : 0);
+        }
+        // Already on the next episode
+        EXPECT_EQ(batch.state(0).V[2], 0);
+    }
+}
+
+TEST(EnvironmentTest, ResetUndoesSelfModifiedCode) {
+    // Turns its first instruction into ADD V3, 1
+    const std::vector<std::uint8_t> kRewrite{
+        0x72, 0x01,  // ADD V2, 1
+        0xA2, 0x00,  // LD I, 0x200
+        0x60, 0x73,  // LD V0, 0x73
+        0xF0, 0x55,  // LD [I], V0
+        0x12, 0x00,  // JP 0x200
+    };
+
+    Environment environment(kRewrite);
+    environment.reset(1);
+    environment.step(0);
+    EXPECT_NE(environment.state().V[3], 0);
+
+    Environment fresh(kRewrite);
+    fresh.reset(1);
+    environment.reset(1);
+    fresh.step(0);
+    environment.step(0);
+    EXPECT_EQ(environment.state().V, fresh.state().V);
+    EXPECT_EQ(environment.state().V[2], 1);
+}
+
+TEST(EnvironmentTest, FaultsEndEpisodes) {
+    const std::vector<std::uint8_t> kInvalid{0xFF, 0xFF};
+    Environment environment(kInvalid);
+    environment.reset(1);
+    EXPECT_TRUE(environment.step(0).done);
+
+    Batch batch(kCounter, 2, 1);
+    const std::vector<keyboard::Type> kTooFew(1, 0);
+    EXPECT_THROW(batch.step(kTooFew), std::invalid_argument);
+}
+
+}  // namespace emu::environment::test
+
+#endif /* TEST_ENVIRONMENT_HPP */
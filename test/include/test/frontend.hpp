@@ -0,0 +1,194 @@
+#ifndef TEST_FRONTEND_HPP
+#define TEST_FRONTEND_HPP
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "chip_8/assembler.hpp"
+#include "chip_8/chip_8.hpp"
+#include "chip_8/display.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/frontend.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/shared_memory.hpp"
+#include "chip_8/terminal_frontend.hpp"
+#include "chip_8/worker_pool.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::frontend::test {
+
+/**
+ * @brief Unpaced frontend recording every hook call
+ */
+struct Recording {
+    static constexpr bool kPaced = false;
+
+    std::vector<display::Display> frames;
+    std::vector<bool> beeps;
+    keyboard::Type keys{};
+
+    void present(const display::Display& display) {
+        frames.push_back(display);
+    }
+    [[nodiscard]] keyboard::Type poll() const { return keys; }
+    void beep(const bool on) { beeps.push_back(on); }
+    void wait(const Duration /* not used */) {
+        ADD_FAILURE() << "Unpaced frontends are never asked to wait";
+    }
+};
+
+static_assert(Frontend<Recording>);
+
+TEST(FrontendTest, CycleDrivesTheFrontend) {
+    const auto kProgram = assembler::assemble(
+        "LD V0, 10\n"
+        "LD ST, V0\n"
+        "LD V1, 5\n"
+        "wait: SKP V1\n"
+        "JP wait\n"
+        "LD F, V1\n"
+        "DRW V2, V2, 5\n"
+        "halt: JP halt\n");
+
+    Chip8 chip8;
+    chip8.load(kProgram.bytes);
+
+    Recording frontend;
+    for (std::size_t cycle = 0; cycle < 100; cycle++) {
+        ASSERT_EQ(chip8.cycle(frontend), fault::Status::kNone);
+    }
+    // Waiting for key 5, the sound timer ran out meanwhile
+    EXPECT_TRUE(frontend.frames.empty());
+    EXPECT_EQ(frontend.beeps, (std::vector<bool>{true, false}));
+
+    frontend.keys = 1U << 5U;
+    for (std::size_t cycle = 0; cycle < 20; cycle++) {
+        ASSERT_EQ(chip8.cycle(frontend), fault::Status::kNone);
+    }
+    ASSERT_EQ(frontend.frames.size(), 1U);
+    EXPECT_TRUE(display::pixel(frontend.frames[0], 0, 0));
+}
+
+TEST(FrontendTest, FramePresentsOnce) {
+    // Redraws forever, every instruction pair changes the picture
+    const auto kProgram = assembler::assemble(
+        "LD F, V0\n"
+        "loop: DRW V0, V0, 5\n"
+        "JP loop\n");
+
+    Chip8 chip8;
+    chip8.load(kProgram.bytes);
+
+    Recording frontend;
+    for (std::size_t frame = 0; frame < 3; frame++) {
+        ASSERT_EQ(chip8.frame(frontend), fault::Status::kNone);
+    }
+    EXPECT_EQ(frontend.frames.size(), 3U);
+}
+
+TEST(FrontendTest, FramePublishesUnchangedScreens) {
+    // Sets V0, then spins without ever drawing
+    const auto kProgram = assembler::assemble(
+        "LD V0, 0x2A\n"
+        "loop: JP loop\n");
+
+    Chip8 chip8;
+    chip8.load(kProgram.bytes);
+    const auto kName = "/chip-8-test-export-" + std::to_string(::getpid());
+    chip8.enableExport(kName);
+    const shared_memory::Subscriber kSubscriber(kName);
+
+    Recording frontend;
+    for (std::size_t frame = 0; frame < 3; frame++) {
+        ASSERT_EQ(chip8.frame(frontend), fault::Status::kNone);
+    }
+    EXPECT_TRUE(frontend.frames.empty());
+
+    // Once when enabled, then once per frame
+    shared_memory::Snapshot snapshot;
+    ASSERT_TRUE(kSubscriber.read(snapshot));
+    EXPECT_EQ(snapshot.frame, 4U);
+    EXPECT_EQ(snapshot.V[0], 0x2A);
+}
+
+TEST(FrontendTest, InstancesRunOnWorkerPool) {
+    constexpr std::size_t kInstances = 4;
+
+    // Every instance draws its own digit
+    std::vector<std::unique_ptr<Chip8>> instances;
+    std::vector<Offscreen> targets(kInstances);
+    std::vector<Offscreen> expected(kInstances);
+    for (std::size_t index = 0; index < kInstances; index++) {
+        const auto kProgram = assembler::assemble(
+            "LD V0, " + std::to_string(index) +
+            "\n"
+            "LD F, V0\n"
+            "DRW V1, V1, 5\n"
+            "halt: JP halt\n");
+
+        Chip8 reference;
+        reference.load(kProgram.bytes);
+        for (std::size_t cycle = 0; cycle < 4; cycle++) {
+            reference.cycle(expected[index]);
+        }
+
+        instances.push_back(std::make_unique<Chip8>());
+        instances.back()->load(kProgram.bytes);
+        instances.back()->pacing().setUnlimited(true);
+    }
+
+    WorkerPool pool(kInstances);
+    auto run = [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t index = begin; index < end; index++) {
+            instances[index]->frame(targets[index]);
+        }
+    };
+    pool.run(kInstances, run);
+
+    for (std::size_t index = 0; index < kInstances; index++) {
+        const auto* frame = targets[index].take();
+        ASSERT_NE(frame, nullptr);
+        EXPECT_EQ(frame->rows, expected[index].take()->rows);
+        EXPECT_EQ(targets[index].take(), nullptr);
+    }
+}
+
+TEST(FrontendTest, TerminalOnlyWritesChangedCells) {
+    display::Display display;
+    display::setPixel(display, 0, 0, true);
+    display::setPixel(display, 1, 1, true);
+    display::setPixel(display, 2, 0, true);
+    display::setPixel(display, 2, 1, true);
+
+    std::ostringstream output;
+    Terminal terminal(output);
+    terminal.type('V');
+    EXPECT_EQ(terminal.poll(), 1U << 0xFU);
+
+    // Two pixel rows per line, the cursor starts in the top left corner
+    output.str("");
+    terminal.present(display);
+    EXPECT_EQ(output.str(), "▀▄█");
+
+    output.str("");
+    terminal.present(display);
+    EXPECT_TRUE(output.str().empty());
+
+    // Nearby cells are rewritten instead of moving the cursor
+    display::setPixel(display, 0, 0, false);
+    display::setPixel(display, 4, 0, true);
+    display::setPixel(display, 40, 31, true);
+    output.str("");
+    terminal.present(display);
+    EXPECT_EQ(output.str(), "\x1b[1;1H ▄█ ▀\x1b[16;41H▄");
+}
+
+}  // namespace emu::frontend::test
+
+#endif /* TEST_FRONTEND_HPP */
@@ -0,0 +1,141 @@
+#ifndef TEST_GOLDEN_HPP
+#define TEST_GOLDEN_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+#include "chip_8/assembler.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/display.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/golden.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::golden::test {
+
+// Draws the digit of the first key pressed, then spins
+inline std::vector<std::uint8_t> keypad() {
+    return assembler::assemble(
+               "    LD V0, K\n"
+               "    LD F, V0\n"
+               "    DRW V1, V1, 5\n"
+               "halt: JP halt\n")
+        .bytes;
+}
+
+// ============================================================================
+// Hashing
+// ============================================================================
+
+TEST(GoldenTest, StateHashCoversDisplay) {
+    emu::ChipState state;
+    const auto kDisplay = hash(state.display);
+    const auto kState = hash(state);
+
+    state.V[3] = 1;
+    EXPECT_EQ(hash(state.display), kDisplay);
+    EXPECT_NE(hash(state), kState);
+
+    const auto kRegisters = hash(state);
+    display::setPixel(state.display, 36, 1, true);
+    EXPECT_NE(hash(state.display), kDisplay);
+    EXPECT_NE(hash(state), kRegisters);
+}
+
+// ============================================================================
+// Manifest
+// ============================================================================
+
+TEST(GoldenTest, ParsesManifest) {
+    std::istringstream manifest(
+        "# comment\n"
+        "\n"
+        "pong  pong.ch8  frames=600 every=60 press=A@10:20  # trailing\n"
+        "alu   workload:alu:8  frames=100\n");
+
+    const auto kScenarios = parseManifest(manifest);
+    ASSERT_EQ(kScenarios.size(), 2U);
+    EXPECT_EQ(kScenarios[0].name, "pong");
+    EXPECT_EQ(kScenarios[0].rom, "pong.ch8");
+    EXPECT_EQ(kScenarios[0].frames, 600U);
+    EXPECT_EQ(kScenarios[0].every, 60U);
+    ASSERT_EQ(kScenarios[0].presses.size(), 1U);
+    EXPECT_EQ(kScenarios[0].presses[0].key, 0xA);
+    EXPECT_EQ(kScenarios[0].presses[0].first, 10U);
+    EXPECT_EQ(kScenarios[0].presses[0].last, 20U);
+    EXPECT_EQ(kScenarios[1].every, 0U);
+
+    std::istringstream invalid("pong pong.ch8 frames=10 speed=2\n");
+    EXPECT_THROW(parseManifest(invalid), GoldenFormatError);
+}
+
+TEST(GoldenTest, GoldensRoundTrip) {
+    Goldens goldens;
+    goldens["alu"] = {{{10, 0x0123456789ABCDEF, 0xFEDCBA9876543210},
+                       {20, 1, 2}},
+                      std::chrono::nanoseconds(1234)};
+
+    std::stringstream file;
+    writeGoldens(file, goldens);
+    const auto kRead = readGoldens(file);
+
+    ASSERT_EQ(kRead.size(), 1U);
+    EXPECT_EQ(kRead.at("alu").checkpoints, goldens["alu"].checkpoints);
+    EXPECT_EQ(kRead.at("alu").elapsed, goldens["alu"].elapsed);
+}
+
+TEST(GoldenTest, MachineSpeedIsTheMeanSpeedup) {
+    Goldens goldens;
+    goldens["alu"].elapsed = std::chrono::nanoseconds(800);
+    goldens["call"].elapsed = std::chrono::nanoseconds(200);
+    goldens["draw"].elapsed = std::chrono::nanoseconds(100);
+
+    // Twice and eight times as fast, draw was not run
+    Goldens results;
+    results["alu"].elapsed = std::chrono::nanoseconds(400);
+    results["call"].elapsed = std::chrono::nanoseconds(25);
+    results["timer"].elapsed = std::chrono::nanoseconds(1000);
+
+    EXPECT_DOUBLE_EQ(machineSpeed(results, goldens), 4.0);
+    EXPECT_DOUBLE_EQ(machineSpeed(results, {}), 1.0);
+}
+
+// ============================================================================
+// Runs
+// ============================================================================
+
+TEST(GoldenTest, CheckpointsDoNotDependOnSpacing) {
+    const auto kRom = assembler::assemble(
+                          assembler::generate(assembler::Workload::kAlu, 4))
+                          .bytes;
+
+    const auto kDense = run({"dense", "", 50, 1, {}}, kRom);
+    const auto kSparse = run({"sparse", "", 50, 25, {}}, kRom);
+
+    ASSERT_EQ(kDense.checkpoints.size(), 50U);
+    ASSERT_EQ(kSparse.checkpoints.size(), 2U);
+    EXPECT_EQ(kSparse.checkpoints[0], kDense.checkpoints[24]);
+    EXPECT_EQ(kSparse.checkpoints[1], kDense.checkpoints[49]);
+}
+
+TEST(GoldenTest, ScriptedInputReachesRom) {
+    const auto kRom = keypad();
+
+    const auto kIdle = run({"idle", "", 10, 0, {}}, kRom);
+    const auto kFive = run({"five", "", 10, 0, {{5, 2, 4}}}, kRom);
+    const auto kSix = run({"six", "", 10, 0, {{6, 2, 4}}}, kRom);
+
+    EXPECT_NE(kIdle.checkpoints.back().display,
+              kFive.checkpoints.back().display);
+    EXPECT_NE(kFive.checkpoints.back().display,
+              kSix.checkpoints.back().display);
+    EXPECT_EQ(kFive.checkpoints, run({"five", "", 10, 0, {{5, 2, 4}}}, kRom)
+                                     .checkpoints);
+}
+
+}  // namespace emu::golden::test
+
+#endif /* TEST_GOLDEN_HPP */
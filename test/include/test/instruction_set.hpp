@@ -2,13 +2,14 @@
 #define TEST_INTRUCTION_SET_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 
 #include "chip_8/chip_state.hpp"
-#include "chip_8/error.hpp"
+#include "chip_8/fault.hpp"
 #include "chip_8/instruction_set.hpp"
-#include "chip_8/keyboard.hpp"
+#include "chip_8/display.hpp"
 
-#include "SDL3/SDL_scancode.h"
 #include "gtest/gtest.h"
 
 namespace emu::instruction_set::test {
@@ -32,29 +33,27 @@ TEST_F(Chip8OpcodeTest, Op0nnn_DoesNothing) {
     emu::instruction_set::op0nnn(state_, 0x0123);
     // Verify state unchanged (excluding random engine)
     EXPECT_EQ(state_.memory, initial_state.memory);
-    EXPECT_EQ(state_.display.buffer, initial_state.display.buffer);
+    EXPECT_EQ(state_.display.rows, initial_state.display.rows);
     EXPECT_EQ(state_.display.draw, initial_state.display.draw);
     EXPECT_EQ(state_.V, initial_state.V);
     EXPECT_EQ(state_.program_counter, initial_state.program_counter);
     EXPECT_EQ(state_.index_register, initial_state.index_register);
     EXPECT_EQ(state_.delay_timer, initial_state.delay_timer);
     EXPECT_EQ(state_.sound_timer, initial_state.sound_timer);
-    EXPECT_EQ(state_.keyboard, initial_state.keyboard);
+    EXPECT_EQ(state_.keys, initial_state.keys);
     EXPECT_EQ(state_.stack, initial_state.stack);
 }
 
 TEST_F(Chip8OpcodeTest, Op00E0_ClearsDisplay) {
-    // Fill display buffer with non-zero values
-    std::ranges::fill(state_.display.buffer.begin(),
-                      state_.display.buffer.end(), 0xFF);
+    // Light every pixel
+    state_.display.rows.fill(~std::uint64_t{0});
     state_.display.draw = false;
 
     emu::instruction_set::op00E0(state_, 0x00E0);
 
     // Verify all pixels are cleared
     EXPECT_TRUE(std::ranges::all_of(
-        state_.display.buffer.cbegin(), state_.display.buffer.cend(),
-        [](std::uint8_t var) { return var == 0x00; }));
+        state_.display.rows, [](std::uint64_t row) { return row == 0; }));
     EXPECT_TRUE(state_.display.draw);
 }
 
@@ -68,9 +67,27 @@ TEST_F(Chip8OpcodeTest, Op00EE_ReturnsFromSubroutine) {
     EXPECT_TRUE(state_.stack.empty());
 }
 
-TEST_F(Chip8OpcodeTest, Op00EE_ThrowsOnEmptyStack) {
-    EXPECT_THROW(emu::instruction_set::op00EE(state_, 0x00EE),
-                 emu::StackUnderflowError);
+TEST(StackTest, ComparesOnlyLiveEntries) {
+    emu::stack::Stack first;
+    emu::stack::Stack second;
+    first.push(0x300);
+    first.pop();
+
+    EXPECT_EQ(first, second);
+    first.push(0x400);
+    EXPECT_NE(first, second);
+}
+
+TEST_F(Chip8OpcodeTest, Op00EE_FaultsOnEmptyStack) {
+    // The program counter already points past the instruction
+    state_.program_counter = 0x402;
+
+    emu::instruction_set::op00EE(state_, 0x00EE);
+
+    EXPECT_EQ(state_.fault.status, emu::fault::Status::kStackUnderflow);
+    EXPECT_EQ(state_.fault.address, 0x400);
+    EXPECT_EQ(state_.fault.bytecode, 0x00EE);
+    EXPECT_EQ(state_.program_counter, 0x400);
 }
 
 // ============================================================================
@@ -101,6 +118,21 @@ TEST_F(Chip8OpcodeTest, Op2nnn_CallsSubroutine) {
     EXPECT_EQ(state_.program_counter, 0x400);
 }
 
+TEST_F(Chip8OpcodeTest, Op2nnn_FaultsPastStackDepth) {
+    for (std::size_t depth = 0; depth < emu::stack::kDepth; depth++) {
+        emu::instruction_set::op2nnn(state_, 0x2400);
+    }
+    EXPECT_EQ(state_.fault.status, emu::fault::Status::kNone);
+
+    state_.program_counter = 0x402;
+    emu::instruction_set::op2nnn(state_, 0x2400);
+
+    EXPECT_EQ(state_.fault.status, emu::fault::Status::kStackOverflow);
+    EXPECT_EQ(state_.fault.address, 0x400);
+    EXPECT_EQ(state_.stack.size(), emu::stack::kDepth);
+    EXPECT_EQ(state_.program_counter, 0x400);
+}
+
 // ============================================================================
 // Skip Instructions (3xkk, 4xkk, 5xy0, 9xy0)
 // ============================================================================
@@ -372,23 +404,35 @@ TEST_F(Chip8OpcodeTest, OpDxyn_DetectsCollision) {
     state_.memory[0x300] = 0xFF;
 
     // Set a pixel that will collide
-    state_.display.buffer[0] = 1;
+    emu::display::setPixel(state_.display, 0, 0, true);
 
     emu::instruction_set::opDxyn(state_, 0xD121);
 
     EXPECT_EQ(state_.V[0xF], 0x01);
 }
 
+TEST_F(Chip8OpcodeTest, OpDxyn_ClipsAtRightAndBottomEdges) {
+    state_.V[1] = 60;
+    state_.V[2] = 31;
+    state_.index_register = 0x300;
+    state_.memory[0x300] = 0xFF;
+    state_.memory[0x301] = 0xFF;
+
+    emu::instruction_set::opDxyn(state_, 0xD122);
+
+    // Only the first row and the first four columns land on screen
+    EXPECT_EQ(state_.display.rows[31], 0xFU);
+    EXPECT_EQ(state_.display.rows[0], 0U);
+    EXPECT_EQ(state_.V[0xF], 0x00);
+}
+
 // ============================================================================
 // Keyboard Instructions (Ex9E, ExA1)
 // ============================================================================
 
 TEST_F(Chip8OpcodeTest, OpEx9E_SkipsIfKeyPressed) {
-    std::array<bool, SDL_SCANCODE_COUNT> dummy_keyboard{};
-    dummy_keyboard[emu::keyboard::mapping(0x3)] = true;
-
     state_.V[5] = 0x3;
-    state_.keyboard = dummy_keyboard.data();
+    state_.keys = 1U << 0x3U;
     state_.program_counter = 0x200;
 
     emu::instruction_set::opEx9E(state_, 0xE59E);
@@ -397,10 +441,8 @@ TEST_F(Chip8OpcodeTest, OpEx9E_SkipsIfKeyPressed) {
 }
 
 TEST_F(Chip8OpcodeTest, OpEx9E_DoesNotSkipIfKeyNotPressed) {
-    std::array<bool, SDL_SCANCODE_COUNT> dummy_keyboard{};
-
     state_.V[5] = 0x3;
-    state_.keyboard = dummy_keyboard.data();
+    state_.keys = 0;
     state_.program_counter = 0x200;
 
     emu::instruction_set::opEx9E(state_, 0xE59E);
@@ -409,10 +451,8 @@ TEST_F(Chip8OpcodeTest, OpEx9E_DoesNotSkipIfKeyNotPressed) {
 }
 
 TEST_F(Chip8OpcodeTest, OpExA1_SkipsIfKeyNotPressed) {
-    std::array<bool, SDL_SCANCODE_COUNT> dummy_keyboard{};
-
     state_.V[5] = 0x3;
-    state_.keyboard = dummy_keyboard.data();
+    state_.keys = 0;
     state_.program_counter = 0x200;
 
     emu::instruction_set::opExA1(state_, 0xE5A1);
@@ -421,11 +461,8 @@ TEST_F(Chip8OpcodeTest, OpExA1_SkipsIfKeyNotPressed) {
 }
 
 TEST_F(Chip8OpcodeTest, OpExA1_DoesNotSkipIfKeyPressed) {
-    std::array<bool, SDL_SCANCODE_COUNT> dummy_keyboard{};
-    dummy_keyboard[emu::keyboard::mapping(0x3)] = true;
-
     state_.V[5] = 0x3;
-    state_.keyboard = dummy_keyboard.data();
+    state_.keys = 1U << 0x3U;
     state_.program_counter = 0x200;
 
     emu::instruction_set::opExA1(state_, 0xE5A1);
@@ -466,9 +503,7 @@ TEST_F(Chip8OpcodeTest, OpFx18_SetsSoundTimer) {
 // ============================================================================
 
 TEST_F(Chip8OpcodeTest, OpFx0A_WaitsForKeyPress) {
-    std::array<bool, SDL_SCANCODE_COUNT> dummy_keyboard{};
-
-    state_.keyboard = dummy_keyboard.data();
+    state_.keys = 0;
     state_.program_counter = 0x202;
 
     emu::instruction_set::opFx0A(state_, 0xF50A);
@@ -477,10 +512,7 @@ TEST_F(Chip8OpcodeTest, OpFx0A_WaitsForKeyPress) {
 }
 
 TEST_F(Chip8OpcodeTest, OpFx0A_StoresKeyWhenPressed) {
-    std::array<bool, SDL_SCANCODE_COUNT> dummy_keyboard{};
-    dummy_keyboard[emu::keyboard::mapping(0x5)] = true;
-
-    state_.keyboard = dummy_keyboard.data();
+    state_.keys = 1U << 0x5U;
     state_.program_counter = 0x200;
 
     emu::instruction_set::opFx0A(state_, 0xF30A);
@@ -568,6 +600,19 @@ TEST_F(Chip8OpcodeTest, OpFx65_LoadsRegistersFromMemory) {
     }
 }
 
+TEST_F(Chip8OpcodeTest, OpFx55_WrapsAroundEndOfMemory) {
+    state_.index_register = 0xFFE;
+    state_.V[0] = 1;
+    state_.V[1] = 2;
+    state_.V[2] = 3;
+
+    emu::instruction_set::opFx55(state_, 0xF255);
+
+    EXPECT_EQ(state_.memory[0xFFE], 1);
+    EXPECT_EQ(state_.memory[0xFFF], 2);
+    EXPECT_EQ(state_.memory[0x000], 3);
+}
+
 }  // namespace emu::instruction_set::test
 
 #endif /* TEST_INTRUCTION_SET_HPP */
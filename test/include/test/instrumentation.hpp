@@ -0,0 +1,231 @@
+#ifndef TEST_INSTRUMENTATION_HPP
+#define TEST_INSTRUMENTATION_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/instruction_set.hpp"
+#include "chip_8/instrumentation.hpp"
+#include "chip_8/opcode.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::instrumentation::test {
+
+// ============================================================================
+// Opcode identification
+// ============================================================================
+
+TEST(OpcodeTest, IdentifiesEveryGroup) {
+    EXPECT_EQ(opcode::identify(0x00E0), opcode::Id::k00E0);
+    EXPECT_EQ(opcode::identify(0x00EE), opcode::Id::k00EE);
+    EXPECT_EQ(opcode::identify(0x0123), opcode::Id::k0nnn);
+    EXPECT_EQ(opcode::identify(0x8AB4), opcode::Id::k8xy4);
+    EXPECT_EQ(opcode::identify(0x8ABE), opcode::Id::k8xyE);
+    EXPECT_EQ(opcode::identify(0xD123), opcode::Id::kDxyn);
+    EXPECT_EQ(opcode::identify(0xE3A1), opcode::Id::kExA1);
+    EXPECT_EQ(opcode::identify(0xF165), opcode::Id::kFx65);
+}
+
+TEST(OpcodeTest, FlagsInvalidBytecodes) {
+    EXPECT_EQ(opcode::identify(0x8AB8), opcode::Id::kInvalid);
+    EXPECT_EQ(opcode::identify(0xE3FF), opcode::Id::kInvalid);
+    EXPECT_EQ(opcode::identify(0xF1FF), opcode::Id::kInvalid);
+}
+
+TEST(OpcodeTest, NamesMatchPatterns) {
+    EXPECT_EQ(opcode::name(opcode::Id::kDxyn), "Dxyn");
+    EXPECT_EQ(opcode::name(opcode::Id::kFx0A), "Fx0A");
+    EXPECT_EQ(opcode::name(opcode::Id::kInvalid), "invalid");
+}
+
+// ============================================================================
+// Recorder
+// ============================================================================
+
+TEST(RecorderTest, DisabledRecorderIsEmpty) {
+    EXPECT_TRUE(std::is_empty_v<Recorder<false>>);
+}
+
+TEST(RecorderTest, CountsExecutionsPerOpcode) {
+    Recorder<true> recorder;
+    emu::ChipState state;
+
+    for (int i = 0; i < 3; i++) {
+        const auto kToken = recorder.beginInstruction(0x6142);
+        emu::instruction_set::op6xkk(state, 0x6142);
+        recorder.endInstruction(kToken, state);
+    }
+
+    const auto& snapshot = recorder.snapshot();
+    EXPECT_EQ(snapshot.executions[opcode::index(opcode::Id::k6xkk)], 3U);
+    // First instruction is always sampled
+    EXPECT_EQ(snapshot.sampled_executions[opcode::index(opcode::Id::k6xkk)],
+              1U);
+}
+
+TEST(RecorderTest, TracksDrawCollisions) {
+    Recorder<true> recorder;
+    emu::ChipState state;
+    state.index_register = 0x300;
+    state.memory[0x300] = 0xFF;
+
+    for (int i = 0; i < 2; i++) {
+        const auto kToken = recorder.beginInstruction(0xD011);
+        emu::instruction_set::opDxyn(state, 0xD011);
+        recorder.endInstruction(kToken, state);
+    }
+
+    // First draw sets pixels, second erases them and collides
+    EXPECT_EQ(recorder.snapshot().draws, 2U);
+    EXPECT_EQ(recorder.snapshot().collisions, 1U);
+    EXPECT_DOUBLE_EQ(recorder.snapshot().collisionRate(), 0.5);
+}
+
+TEST(RecorderTest, MeasuresDrawToPresent) {
+    Recorder<true> recorder;
+    emu::ChipState state;
+
+    recorder.framePresented();
+    EXPECT_EQ(recorder.snapshot().draw_to_present.count, 0U);
+
+    const auto kToken = recorder.beginInstruction(0x00E0);
+    emu::instruction_set::op00E0(state, 0x00E0);
+    recorder.endInstruction(kToken, state);
+    recorder.framePresented();
+
+    EXPECT_EQ(recorder.snapshot().draw_to_present.count, 1U);
+}
+
+TEST(RecorderTest, RecordsSleepOvershoot) {
+    Recorder<true> recorder;
+    using std::chrono::nanoseconds;
+
+    recorder.slept(nanoseconds(1000), nanoseconds(1500));
+    recorder.slept(nanoseconds(1000), nanoseconds(900));
+
+    const auto& overshoot = recorder.snapshot().sleep_overshoot;
+    EXPECT_EQ(overshoot.count, 2U);
+    EXPECT_EQ(overshoot.total_ns, 500U);
+    EXPECT_EQ(overshoot.max_ns, 500U);
+}
+
+TEST(RecorderTest, FollowsKeyEventsToPresent) {
+    Recorder<true> recorder;
+    emu::ChipState state;
+    const auto kRun = [&](const std::uint16_t bytecode) {
+        const auto kToken = recorder.beginInstruction(bytecode);
+        recorder.endInstruction(kToken, state);
+    };
+
+    // Draws before any instruction read the key do not answer it
+    recorder.keyEvent();
+    kRun(0xD011);
+    kRun(0xE09E);
+    // The second event is followed on its own, the next draw only answers
+    // the first one
+    recorder.keyEvent();
+    kRun(0xD011);
+    recorder.framePresented();
+
+    const auto& snapshot = recorder.snapshot();
+    EXPECT_EQ(snapshot.key_to_read.latency.count, 1U);
+    EXPECT_EQ(snapshot.key_to_draw.latency.count, 1U);
+    EXPECT_EQ(snapshot.key_to_present.latency.count, 1U);
+    EXPECT_GE(snapshot.key_to_present.latency.max_ns,
+              snapshot.key_to_read.latency.max_ns);
+
+    kRun(0xE0A1);
+    kRun(0x00E0);
+    recorder.framePresented();
+    recorder.framePresented();
+    EXPECT_EQ(snapshot.key_to_read.latency.count, 2U);
+    EXPECT_EQ(snapshot.key_to_draw.latency.count, 2U);
+    EXPECT_EQ(snapshot.key_to_present.latency.count, 2U);
+    EXPECT_EQ(snapshot.key_expired, 0U);
+}
+
+TEST(RecorderTest, ExpiresUnansweredKeyEvents) {
+    Recorder<true> recorder;
+    emu::ChipState state;
+    const auto kRun = [&](const std::uint16_t bytecode) {
+        const auto kToken = recorder.beginInstruction(bytecode);
+        recorder.endInstruction(kToken, state);
+    };
+
+    // Past kMaxKeyEvents the oldest events are dropped
+    for (std::size_t i = 0; i < kMaxKeyEvents + 2; i++) {
+        recorder.keyEvent();
+    }
+    EXPECT_EQ(recorder.snapshot().key_expired, 2U);
+
+    // A ROM reading the keys long after did not answer them
+    std::this_thread::sleep_for(kInputTimeout);
+    kRun(0xE09E);
+    EXPECT_EQ(recorder.snapshot().key_to_read.latency.count, 0U);
+    EXPECT_EQ(recorder.snapshot().key_expired, kMaxKeyEvents + 2);
+}
+
+TEST(RecorderTest, BucketsLatencies) {
+    Histogram histogram;
+    histogram.record(500);
+    histogram.record(3000);
+    histogram.record(4000);
+    histogram.record(std::uint64_t{10} * 1000 * 1000 * 1000);
+
+    EXPECT_EQ(histogram.buckets[0], 1U);
+    EXPECT_EQ(histogram.buckets[2], 2U);
+    EXPECT_EQ(histogram.buckets[kHistogramBuckets - 1], 1U);
+    EXPECT_EQ(histogram.quantile(0.5), Histogram::bound(2));
+    EXPECT_EQ(histogram.quantile(1.0), histogram.latency.max_ns);
+}
+
+// ============================================================================
+// Exporters
+// ============================================================================
+
+TEST(ExportTest, WritesJson) {
+    Snapshot snapshot;
+    snapshot.executions[opcode::index(opcode::Id::kAnnn)] = 7;
+    snapshot.draws = 4;
+    snapshot.collisions = 1;
+
+    std::ostringstream output;
+    writeJson(output, snapshot);
+
+    const auto kText = output.str();
+    EXPECT_NE(kText.find("\"engine\":\"reference\""), std::string::npos);
+    EXPECT_NE(kText.find("\"Annn\":{\"executions\":7"), std::string::npos);
+    EXPECT_NE(kText.find("\"collision_rate\":0.25"), std::string::npos);
+    // Opcodes that never ran are omitted
+    EXPECT_EQ(kText.find("\"Bnnn\""), std::string::npos);
+}
+
+TEST(ExportTest, WritesPrometheus) {
+    Snapshot snapshot;
+    snapshot.executions[opcode::index(opcode::Id::kAnnn)] = 7;
+
+    std::ostringstream output;
+    writePrometheus(output, snapshot);
+
+    const auto kText = output.str();
+    EXPECT_NE(kText.find("chip8_opcode_executions_total{opcode=\"Annn\"} 7"),
+              std::string::npos);
+    EXPECT_NE(kText.find("chip8_engine_info{engine=\"reference\"} 1"),
+              std::string::npos);
+    EXPECT_NE(kText.find("# TYPE chip8_draws_total counter"),
+              std::string::npos);
+    EXPECT_NE(kText.find("chip8_key_to_present_nanoseconds_bucket"
+                         "{le=\"+Inf\"} 0"),
+              std::string::npos);
+}
+
+}  // namespace emu::instrumentation::test
+
+#endif /* TEST_INSTRUMENTATION_HPP */
@@ -0,0 +1,152 @@
+#ifndef TEST_LOCKSTEP_HPP
+#define TEST_LOCKSTEP_HPP
+
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "chip_8/assembler.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/lockstep.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::lockstep::test {
+
+constexpr std::array kCandidates{Engine::kPredecoder, Engine::kBlockCache};
+
+// ============================================================================
+// Checker
+// ============================================================================
+
+TEST(LockstepTest, EnginesAgreeOnWorkloads) {
+    for (const auto kWorkload :
+         {assembler::Workload::kDraw, assembler::Workload::kAlu,
+          assembler::Workload::kCall, assembler::Workload::kTimerWait}) {
+        const auto kRom =
+            assembler::assemble(assembler::generate(kWorkload, 4)).bytes;
+        for (const auto kEngine : kCandidates) {
+            Checker checker(kEngine, kRom, nullptr, 1);
+            const auto kDivergence = checker.runUntil(20000);
+            EXPECT_FALSE(kDivergence.has_value());
+            EXPECT_GE(checker.instructions(), 20000U);
+        }
+    }
+}
+
+TEST(LockstepTest, SignatureIsIndependentOfEngineWhenStepsMatch) {
+    // Straight-line ops, one per step on the predecoder and the reference
+    const auto kRom = assembler::assemble(
+                          "loop: ADD V0, 1\n"
+                          "    SE V0, 0\n"
+                          "    JP loop\n"
+                          "halt: JP halt\n")
+                          .bytes;
+
+    Checker first(Engine::kPredecoder, kRom);
+    Checker second(Engine::kPredecoder, kRom);
+    ASSERT_FALSE(first.runUntil(3000).has_value());
+    ASSERT_FALSE(second.runUntil(3000).has_value());
+    EXPECT_EQ(first.signature(), second.signature());
+
+    Checker longer(Engine::kPredecoder, kRom);
+    ASSERT_FALSE(longer.runUntil(3001).has_value());
+    EXPECT_NE(longer.signature(), first.signature());
+}
+
+TEST(LockstepTest, ReferenceTicksTimersPerInstruction) {
+    const auto kRom = assembler::assemble(
+                          "    LD V0, 5\n"
+                          "    LD DT, V0\n"
+                          "    LD V1, DT\n"
+                          "halt: JP halt\n")
+                          .bytes;
+
+    for (const auto kEngine : kCandidates) {
+        Checker checker(kEngine, kRom, nullptr, 1);
+        EXPECT_FALSE(checker.runUntil(100).has_value());
+    }
+
+    // A block that ticks only once it exits reads DT too early
+    Runner runner(Engine::kReference);
+    runner.load(kRom);
+    const ChipState kBefore = runner.state();
+    auto stale = kBefore;
+    for (int i = 0; i < 3; i++) {
+        stepReference(stale);
+    }
+    timers::tick(stale, 3);
+    ASSERT_EQ(stale.V[1], 5U);
+
+    const auto kDivergence = verify(kBefore, 3, stale);
+    ASSERT_TRUE(kDivergence.has_value());
+    EXPECT_EQ(kDivergence->expected.V[1], 4U);
+}
+
+TEST(LockstepTest, EnginesStopOnTheSameFault) {
+    const auto kRom = assembler::assemble(
+                          "    LD V0, 1\n"
+                          "    CALL sub\n"
+                          "    RET\n"
+                          "sub: RET\n")
+                          .bytes;
+
+    for (const auto kEngine : kCandidates) {
+        Checker checker(kEngine, kRom);
+        EXPECT_FALSE(checker.runUntil(1000).has_value());
+        EXPECT_EQ(checker.fault().status, fault::Status::kStackUnderflow);
+        EXPECT_EQ(checker.fault().address, 0x204);
+        EXPECT_LT(checker.instructions(), 1000U);
+    }
+}
+
+// ============================================================================
+// Self-check
+// ============================================================================
+
+TEST(LockstepTest, VerifyReportsTamperedState) {
+    const auto kRom = assembler::assemble(
+                          "    LD V3, 0x42\n"
+                          "    LD I, 0x300\n"
+                          "halt: JP halt\n")
+                          .bytes;
+
+    Runner runner(Engine::kBlockCache);
+    runner.load(kRom);
+    const ChipState kBefore = runner.state();
+    const auto kRetired = runner.step();
+    ASSERT_EQ(kRetired, 3U);
+    EXPECT_FALSE(verify(kBefore, kRetired, runner.state()).has_value());
+
+    auto tampered = runner.state();
+    tampered.V[3] = 0x41;
+    const auto kDivergence = verify(kBefore, kRetired, tampered);
+    ASSERT_TRUE(kDivergence.has_value());
+    EXPECT_EQ(kDivergence->entry, 0x200);
+
+    std::ostringstream report;
+    writeReport(report, *kDivergence);
+    EXPECT_NE(report.str().find("V3: 0x42 vs 0x41"), std::string::npos);
+    EXPECT_NE(report.str().find("LD V3, 0x42"), std::string::npos);
+    EXPECT_EQ(report.str().find("V4:"), std::string::npos);
+}
+
+TEST(LockstepTest, SamplerVerifiesOneStepPerInterval) {
+    Sampler disabled;
+    EXPECT_FALSE(disabled.enabled());
+    EXPECT_FALSE(disabled.due());
+
+    Sampler sampler(3);
+    EXPECT_TRUE(sampler.enabled());
+    std::string pattern;
+    for (int i = 0; i < 7; i++) {
+        pattern += sampler.due() ? 'x' : '.';
+    }
+    EXPECT_EQ(pattern, "..x..x.");
+}
+
+}  // namespace emu::lockstep::test
+
+#endif /* TEST_LOCKSTEP_HPP */
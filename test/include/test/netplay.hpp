@@ -0,0 +1,162 @@
+#ifndef TEST_NETPLAY_HPP
+#define TEST_NETPLAY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "chip_8/assembler.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/environment.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/netplay.hpp"
+#include "chip_8/random.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::netplay::test {
+
+// Counts key 0 in V2 and key 5 in V3, and patches its own code with V3
+const auto kKeyCounter = assembler::assemble(
+    "loop: LD V0, 0\n"
+    "SKNP V0\n"
+    "ADD V2, 1\n"
+    "LD V0, 5\n"
+    "SKNP V0\n"
+    "ADD V3, 7\n"
+    "LD I, 0x213\n"
+    "LD V0, V3\n"
+    "LD [I], V0\n"
+    "ADD V4, 0\n"
+    "JP loop\n");
+
+/**
+ * @brief Run the ROM without rollback, with the keys both players held
+ */
+inline ChipState lockstep(const std::vector<keyboard::Type>& keys) {
+    const environment::Image kImage(kKeyCounter.bytes);
+    auto state = kImage.state();
+    state.rnd.seed(random::kDefaultSeed, random::Mode::kXorshift);
+    auto program = kImage.program();
+
+    std::size_t overshoot = 0;
+    for (const auto kKeys : keys) {
+        state.keys = kKeys;
+        overshoot = environment::runFrame(state, program,
+                                          golden::kInstructionsPerFrame,
+                                          overshoot);
+    }
+    return state;
+}
+
+TEST(NetplayTest, RollbackMatchesLockstep) {
+    constexpr std::uint64_t kFrames = 300;
+    constexpr std::size_t kLatency = 4;
+
+    Config config;
+    config.input_delay = 1;
+    std::array<Session, 2> sessions{Session(kKeyCounter.bytes, config),
+                                    Session(kKeyCounter.bytes, config)};
+    // Packets in flight, delivered kLatency ticks after being sent
+    std::array<std::deque<std::vector<std::uint8_t>>, 2> links;
+    // Keys each player's frames were run with, known after the input delay
+    std::array<std::vector<keyboard::Type>, 2> held{
+        std::vector<keyboard::Type>(config.input_delay),
+        std::vector<keyboard::Type>(config.input_delay)};
+
+    random::Generator generator;
+    std::array<keyboard::Type, 2> keys{};
+    for (std::size_t tick = 0; tick < 2 * kFrames; tick++) {
+        for (std::size_t player = 0; player < 2; player++) {
+            auto& session = sessions[player];
+            if ((generator.next() % 8) == 0) {
+                keys[player] ^= keyboard::Type{1} << (player * 5);
+            }
+            if (session.frame() < kFrames && session.advance(keys[player])) {
+                held[player].push_back(keys[player]);
+            }
+
+            Packet packet{};
+            const auto kSize = session.write(packet);
+            links[player].emplace_back(packet.begin(), packet.begin() + kSize);
+            if (links[player].size() > kLatency) {
+                sessions[1 - player].read(links[player].front());
+                links[player].pop_front();
+            }
+        }
+    }
+
+    std::vector<keyboard::Type> both(kFrames);
+    for (std::size_t frame = 0; frame < kFrames; frame++) {
+        both[frame] = held[0][frame] | held[1][frame];
+    }
+    const auto kExpected = lockstep(both);
+
+    for (auto& session : sessions) {
+        session.synchronize();
+        ASSERT_EQ(session.frame(), kFrames);
+        EXPECT_GE(session.confirmed(), kFrames);
+        EXPECT_GT(session.stats().rollbacks, 0U);
+        EXPECT_LE(session.stats().resimulated_frames,
+                  session.stats().rollbacks * kMaxRollback);
+        EXPECT_EQ(session.state().V, kExpected.V);
+        EXPECT_EQ(session.state().memory, kExpected.memory);
+    }
+
+    const std::vector<std::uint8_t> kGarbage{1, 2, 3};
+    sessions[0].read(kGarbage);
+    EXPECT_EQ(sessions[0].stats().invalid_packets, 1U);
+}
+
+TEST(NetplayTest, StallsPastRollbackWindow) {
+    Session session(kKeyCounter.bytes);
+    for (std::size_t frame = 0; frame < kMaxRollback; frame++) {
+        EXPECT_TRUE(session.advance(0));
+    }
+    EXPECT_FALSE(session.advance(0));
+    EXPECT_EQ(session.stats().stalls, 1U);
+}
+
+TEST(NetplayTest, ExchangesOverLoopback) {
+    constexpr std::uint64_t kFrames = 60;
+
+    std::array<Session, 2> sessions{Session(kKeyCounter.bytes),
+                                    Session(kKeyCounter.bytes)};
+    Connection first(0);
+    Connection second(0);
+    first.connect("127.0.0.1", second.port());
+    second.connect("127.0.0.1", first.port());
+
+    // Bounded, a broken link fails instead of hanging
+    for (std::size_t tick = 0; tick < 100000; tick++) {
+        if (std::ranges::all_of(sessions, [](const Session& session) {
+                return session.frame() == kFrames &&
+                       session.confirmed() >= kFrames;
+            })) {
+            break;
+        }
+        for (std::size_t player = 0; player < 2; player++) {
+            if (sessions[player].frame() < kFrames) {
+                sessions[player].advance(static_cast<keyboard::Type>(
+                    (tick / 10) % 2 << (player * 5)));
+            }
+        }
+        first.exchange(sessions[0]);
+        second.exchange(sessions[1]);
+    }
+
+    for (auto& session : sessions) {
+        session.synchronize();
+        EXPECT_EQ(session.frame(), kFrames);
+        EXPECT_GE(session.confirmed(), kFrames);
+    }
+    EXPECT_EQ(sessions[0].state().V, sessions[1].state().V);
+    EXPECT_EQ(sessions[0].state().memory, sessions[1].state().memory);
+}
+
+}  // namespace emu::netplay::test
+
+#endif /* TEST_NETPLAY_HPP */
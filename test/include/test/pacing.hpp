@@ -0,0 +1,68 @@
+#ifndef TEST_PACING_HPP
+#define TEST_PACING_HPP
+
+#include <chrono>
+
+#include "chip_8/pacing.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::pacing::test {
+
+using std::chrono::milliseconds;
+
+TEST(PacingTest, OwesInstructionsForElapsedTime) {
+    Governor governor;
+    governor.setRate(1000.0);
+    const auto kStart = Clock::time_point{} + milliseconds(1000);
+
+    // The first frame starts the schedule
+    EXPECT_EQ(governor.owed(kStart), 0U);
+    EXPECT_EQ(governor.owed(kStart + milliseconds(10)), 10U);
+    // A block ran 2 past the budget, the next frame gets 2 fewer
+    governor.retire(12, kStart + milliseconds(10));
+    EXPECT_EQ(governor.owed(kStart + milliseconds(20)), 8U);
+    governor.retire(8, kStart + milliseconds(20));
+
+    // A stalled host is paid back at most kMaxLag
+    EXPECT_EQ(governor.owed(kStart + milliseconds(1020)), 100U);
+    governor.retire(100, kStart + milliseconds(1020));
+
+    // Twice as fast, twice the instructions
+    governor.setMultiplier(2.0);
+    EXPECT_EQ(governor.owed(kStart + milliseconds(1030)), 0U);
+    EXPECT_EQ(governor.owed(kStart + milliseconds(1040)), 20U);
+}
+
+TEST(PacingTest, MeasuresFromTheFirstFrame) {
+    Governor governor;
+    governor.setRate(1000.0);
+    const auto kStart = Clock::time_point{} + milliseconds(10000);
+
+    // A window ending the first frame would span the epoch and read ~0
+    governor.retire(10, kStart);
+    EXPECT_EQ(governor.measuredRate(), 0.0);
+    governor.retire(500, kStart + milliseconds(500));
+    EXPECT_DOUBLE_EQ(governor.measuredRate(), 1000.0);
+}
+
+TEST(PacingTest, ClampsSpeed) {
+    Governor governor;
+    governor.setRate(1000.0);
+
+    governor.setUnlimited(true);
+    EXPECT_EQ(governor.targetRate(), 0.0);
+    EXPECT_EQ(governor.owed(Clock::time_point{}), 0U);
+    EXPECT_EQ(governor.owed(Clock::time_point{} + milliseconds(50)), 0U);
+
+    governor.setUnlimited(false);
+    governor.setMultiplier(0.0);
+    EXPECT_EQ(governor.multiplier(), kMinMultiplier);
+    governor.setMultiplier(1000.0);
+    EXPECT_EQ(governor.multiplier(), kMaxMultiplier);
+    EXPECT_EQ(governor.targetRate(), 1000.0 * kMaxMultiplier);
+}
+
+}  // namespace emu::pacing::test
+
+#endif /* TEST_PACING_HPP */
@@ -0,0 +1,47 @@
+#ifndef TEST_PARSE_HPP
+#define TEST_PARSE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "chip_8/parse.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::parse::test {
+
+TEST(ParseTest, RejectsPartialAndOutOfRangeNumbers) {
+    EXPECT_EQ(number<std::uint16_t>("65535"), 65535);
+    EXPECT_EQ(number<std::uint16_t>("ff", 16), 0xFF);
+    // strtoul would have truncated, wrapped or stopped early
+    EXPECT_EQ(number<std::uint16_t>("70000"), std::nullopt);
+    EXPECT_EQ(number<std::uint16_t>("-1"), std::nullopt);
+    EXPECT_EQ(number<std::uint16_t>("12abc"), std::nullopt);
+    EXPECT_EQ(number<std::uint16_t>(" 12"), std::nullopt);
+    EXPECT_EQ(number<std::uint16_t>(""), std::nullopt);
+
+    EXPECT_EQ(number<double>("0.25"), 0.25);
+    EXPECT_EQ(number<double>("inf"), std::nullopt);
+    EXPECT_EQ(number<double>("nan"), std::nullopt);
+    EXPECT_EQ(number<double>("2x"), std::nullopt);
+}
+
+TEST(ParseTest, ChecksBounds) {
+    EXPECT_EQ(bounded<std::size_t>("8", 0, 8), 8U);
+    EXPECT_EQ(bounded<std::size_t>("9", 0, 8), std::nullopt);
+    EXPECT_EQ(bounded<std::uint16_t>("0", 1, 0xFFFF), std::nullopt);
+    EXPECT_EQ(bounded<double>("0.5", 0.0, 1.0), 0.5);
+}
+
+TEST(ParseTest, ReadsLiterals) {
+    EXPECT_EQ(literal<std::uint32_t>("42"), 42U);
+    EXPECT_EQ(literal<std::uint32_t>("0x2A"), 42U);
+    EXPECT_EQ(literal<std::uint32_t>("0b101010"), 42U);
+    EXPECT_EQ(literal<std::uint32_t>("0x"), std::nullopt);
+    EXPECT_EQ(literal<std::uint32_t>("0x1FFFFFFFF"), std::nullopt);
+}
+
+}  // namespace emu::parse::test
+
+#endif /* TEST_PARSE_HPP */
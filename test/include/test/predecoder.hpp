@@ -0,0 +1,155 @@
+#ifndef TEST_PREDECODER_HPP
+#define TEST_PREDECODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/display.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/memory.hpp"
+#include "chip_8/predecoder.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::predecoder::test {
+
+class PredecoderTest : public ::testing::Test {
+   protected:
+    emu::ChipState state_;
+    Program program_;
+
+    void SetUp() override { state_ = emu::ChipState(); }
+
+    void load(const std::uint16_t address,
+              const std::initializer_list<std::uint16_t> bytecodes) {
+        auto target = address;
+        for (const auto kBytecode : bytecodes) {
+            state_.memory[target] = static_cast<std::uint8_t>(kBytecode >> 8U);
+            state_.memory[target + 1U] =
+                static_cast<std::uint8_t>(kBytecode & 0xFFU);
+            target += 2;
+        }
+    }
+
+    // Execute instructions one at a time, without fusion
+    static void runUnfused(emu::ChipState& state, const std::size_t count) {
+        for (std::size_t idx = 0; idx < count; idx++) {
+            const auto kOp =
+                decodeSingle(bytecodeAt(state.memory, state.program_counter));
+            state.program_counter += 2;
+            kOp.handler(state, kOp);
+        }
+    }
+};
+
+// ============================================================================
+// Fusion
+// ============================================================================
+
+TEST_F(PredecoderTest, FusesConsecutiveLoads) {
+    load(0x200, {0x6A01, 0x6B02});
+
+    const auto& op = program_.at(state_.memory, 0x200);
+    EXPECT_EQ(op.length, 2U);
+
+    EXPECT_EQ(program_.step(state_), 2U);
+    EXPECT_EQ(state_.V[0xA], 0x01);
+    EXPECT_EQ(state_.V[0xB], 0x02);
+    EXPECT_EQ(state_.program_counter, 0x204);
+}
+
+TEST_F(PredecoderTest, FusesSpriteDraw) {
+    load(0x200, {0xA300, 0xD011});
+    state_.memory[0x300] = 0x80;
+
+    EXPECT_EQ(program_.step(state_), 2U);
+    EXPECT_EQ(state_.index_register, 0x300);
+    EXPECT_TRUE(display::pixel(state_.display, 0, 0));
+    EXPECT_TRUE(state_.display.draw);
+}
+
+TEST_F(PredecoderTest, FusedCountingLoopMatchesUnfused) {
+    // loop: ADD V0, 1; SE V0, 3; JP loop
+    load(0x200, {0x7001, 0x3003, 0x1200, 0x6A01});
+    auto reference = state_;
+
+    std::size_t retired = 0;
+    while (state_.program_counter != 0x206) {
+        retired += program_.step(state_);
+    }
+    // Three iterations, the last jump is skipped
+    runUnfused(reference, 8);
+
+    EXPECT_EQ(retired, 8U);
+    EXPECT_EQ(state_.V, reference.V);
+    EXPECT_EQ(state_.program_counter, reference.program_counter);
+}
+
+TEST_F(PredecoderTest, FusedTimerWaitMatchesUnfused) {
+    // wait: LD V1, DT; SE V1, 0; JP wait
+    load(0x200, {0xF107, 0x3100, 0x1200});
+    state_.delay_timer = 2;
+
+    EXPECT_EQ(program_.step(state_), 3U);
+    EXPECT_EQ(state_.V[1], 2U);
+    EXPECT_EQ(state_.program_counter, 0x200);
+
+    state_.delay_timer = 0;
+    EXPECT_EQ(program_.step(state_), 2U);
+    EXPECT_EQ(state_.program_counter, 0x206);
+}
+
+// ============================================================================
+// Fallback
+// ============================================================================
+
+TEST_F(PredecoderTest, JumpIntoFusedSequenceRunsTail) {
+    load(0x200, {0x6A01, 0x6B02, 0x1202});
+    program_.predecode(state_.memory, 0x200, 0x206);
+
+    // Second half of the pair is decoded on its own
+    const auto& op = program_.at(state_.memory, 0x202);
+    EXPECT_EQ(op.length, 1U);
+
+    state_.program_counter = 0x202;
+    program_.step(state_);
+    EXPECT_EQ(state_.V[0xA], 0x00);
+    EXPECT_EQ(state_.V[0xB], 0x02);
+}
+
+TEST_F(PredecoderTest, MemoryWriteRedecodesFusedSequence) {
+    // LD B, V0; then a fusable pair of loads at 0x202
+    load(0x200, {0xF033, 0x6A01, 0x6B02});
+    program_.predecode(state_.memory, 0x200, 0x206);
+    EXPECT_EQ(program_.at(state_.memory, 0x202).length, 2U);
+
+    // Store the digits of 99 over the tail of the pair
+    state_.V[0] = 99;
+    state_.index_register = 0x203;
+    program_.step(state_);
+
+    EXPECT_EQ(state_.memory[0x203], 0x00);
+    EXPECT_EQ(state_.memory[0x204], 0x09);
+    EXPECT_EQ(state_.memory[0x205], 0x09);
+
+    // 0x202 now reads 6A00 0909, which is no longer a fusable pair
+    EXPECT_EQ(program_.at(state_.memory, 0x202).length, 1U);
+}
+
+TEST_F(PredecoderTest, InvalidInstructionFaultsWhenExecuted) {
+    load(0x200, {0x8008});
+    program_.predecode(state_.memory, 0x200, 0x202);
+
+    program_.step(state_);
+
+    EXPECT_EQ(state_.fault.status, fault::Status::kInvalidInstruction);
+    EXPECT_EQ(state_.fault.address, 0x200);
+    EXPECT_EQ(state_.fault.bytecode, 0x8008);
+    EXPECT_EQ(state_.program_counter, 0x200);
+}
+
+}  // namespace emu::predecoder::test
+
+#endif /* TEST_PREDECODER_HPP */
@@ -0,0 +1,69 @@
+#ifndef TEST_PROFILER_HPP
+#define TEST_PROFILER_HPP
+
+#include <sstream>
+#include <string>
+
+#include "chip_8/profiler.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::profiler::test {
+
+TEST(ProfilerTest, CountsExecutionsPerAddress) {
+    Profiler profiler;
+
+    profiler.record(0x200, 0x6001);
+    profiler.record(0x202, 0x7001);
+    profiler.record(0x202, 0x7001);
+
+    EXPECT_EQ(profiler.heat()[0x200], 1U);
+    EXPECT_EQ(profiler.heat()[0x202], 2U);
+    EXPECT_EQ(profiler.heat()[0x204], 0U);
+}
+
+TEST(ProfilerTest, FoldsCallPaths) {
+    Profiler profiler;
+
+    profiler.record(0x200, 0x2300);  // CALL 0x300, attributed to main
+    profiler.record(0x300, 0x2400);  // CALL 0x400, attributed to sub_0300
+    profiler.record(0x400, 0x6001);
+    profiler.record(0x402, 0x00EE);  // RET, attributed to sub_0400
+    profiler.record(0x302, 0x00EE);  // RET, attributed to sub_0300
+    profiler.record(0x202, 0x1202);
+
+    std::ostringstream output;
+    profiler.writeFolded(output);
+
+    EXPECT_EQ(output.str(),
+              "main 2\n"
+              "main;sub_0300 2\n"
+              "main;sub_0300;sub_0400 2\n");
+}
+
+TEST(ProfilerTest, IgnoresUnbalancedReturns) {
+    Profiler profiler;
+
+    profiler.record(0x200, 0x00EE);
+    profiler.record(0x202, 0x6001);
+
+    std::ostringstream output;
+    profiler.writeFolded(output);
+
+    EXPECT_EQ(output.str(), "main 2\n");
+}
+
+TEST(ProfilerTest, WritesHeatMapImage) {
+    Profiler profiler;
+    profiler.record(0x000, 0x6001);
+
+    std::ostringstream output;
+    profiler.writeHeatMap(output);
+
+    const auto kText = output.str();
+    EXPECT_EQ(kText.rfind("P2\n64 64\n255\n255 0 0", 0), 0U);
+}
+
+}  // namespace emu::profiler::test
+
+#endif /* TEST_PROFILER_HPP */
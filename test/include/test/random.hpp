@@ -0,0 +1,88 @@
+#ifndef TEST_RANDOM_HPP
+#define TEST_RANDOM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/instruction_set.hpp"
+#include "chip_8/random.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::random::test {
+
+template <std::size_t kCount>
+std::array<std::uint8_t, kCount> draw(Generator& generator) {
+    std::array<std::uint8_t, kCount> bytes{};
+    for (auto& byte : bytes) {
+        byte = generator.next();
+    }
+    return bytes;
+}
+
+TEST(RandomTest, SeedDeterminesSequence) {
+    Generator first(1234);
+    Generator second(1234);
+    Generator other(1235);
+
+    const auto kFirst = draw<64>(first);
+    EXPECT_EQ(kFirst, draw<64>(second));
+    EXPECT_NE(kFirst, draw<64>(other));
+
+    // Not stuck on a handful of values
+    const std::set<std::uint8_t> kDistinct(kFirst.begin(), kFirst.end());
+    EXPECT_GT(kDistinct.size(), 32U);
+
+    // Zero would be a fixed point of xorshift
+    Generator zero(0);
+    EXPECT_NE(draw<4>(zero), (std::array<std::uint8_t, 4>{}));
+}
+
+TEST(RandomTest, SnapshotResumesSequence) {
+    for (const auto kMode : {Mode::kXorshift, Mode::kCosmacVip}) {
+        Generator generator(99, kMode);
+        draw<10>(generator);
+        generator.tick(3);
+
+        auto restored = Generator::load(generator.save());
+        EXPECT_EQ(restored, generator);
+        EXPECT_EQ(restored.mode(), kMode);
+        EXPECT_EQ(draw<16>(restored), draw<16>(generator));
+    }
+}
+
+TEST(RandomTest, VipSequenceFollowsTimerTicks) {
+    Generator generator(0x1200, Mode::kCosmacVip);
+    Generator ticked = generator;
+
+    generator.next();
+    ticked.next();
+    EXPECT_EQ(generator, ticked);
+
+    ticked.tick(1);
+    EXPECT_NE(generator.next(), ticked.next());
+
+    // The xorshift sequence ignores time
+    Generator xorshift(7);
+    Generator idle = xorshift;
+    idle.tick(100);
+    EXPECT_EQ(draw<8>(xorshift), draw<8>(idle));
+}
+
+TEST(RandomTest, CxkkMasksGeneratorOutput) {
+    ChipState state;
+    state.rnd.seed(42);
+    Generator expected(42);
+
+    for (int i = 0; i < 16; i++) {
+        instruction_set::opCxkk(state, 0xC30F);
+        EXPECT_EQ(state.V[3], expected.next() & 0x0FU);
+    }
+}
+
+}  // namespace emu::random::test
+
+#endif /* TEST_RANDOM_HPP */
@@ -0,0 +1,186 @@
+#ifndef TEST_RECOMPILER_HPP
+#define TEST_RECOMPILER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chip_8/aot.hpp"
+#include "chip_8/chip_state.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/recompiler.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::recompiler::test {
+
+inline std::vector<std::uint8_t> assemble(
+    const std::initializer_list<std::uint16_t> bytecodes) {
+    std::vector<std::uint8_t> rom;
+    for (const auto kBytecode : bytecodes) {
+        rom.push_back(static_cast<std::uint8_t>(kBytecode >> 8U));
+        rom.push_back(static_cast<std::uint8_t>(kBytecode & 0xFFU));
+    }
+    return rom;
+}
+
+// ============================================================================
+// Control flow recovery
+// ============================================================================
+
+TEST(RecompilerTest, SplitsBlocksAtBranchTargets) {
+    // 200: LD V0, 0
+    // 202: ADD V0, 1      <- loop
+    // 204: SE V0, 5
+    // 206: JP 202
+    // 208: CALL 20C
+    // 20A: JP 20A
+    // 20C: RET
+    const auto kRom =
+        assemble({0x6000, 0x7001, 0x3005, 0x1202, 0x220C, 0x120A, 0x00EE});
+
+    const auto kBlocks = findBlocks(kRom);
+
+    const std::vector<std::pair<std::uint16_t, std::uint16_t>> kExpected{
+        {0x200, 0x202}, {0x202, 0x206}, {0x206, 0x208},
+        {0x208, 0x20A}, {0x20A, 0x20C}, {0x20C, 0x20E},
+    };
+    ASSERT_EQ(kBlocks.size(), kExpected.size());
+    for (std::size_t idx = 0; idx < kBlocks.size(); idx++) {
+        EXPECT_EQ(kBlocks[idx].entry, kExpected[idx].first);
+        EXPECT_EQ(kBlocks[idx].end, kExpected[idx].second);
+    }
+}
+
+TEST(RecompilerTest, SkipsUnreachableData) {
+    // JP 206; sprite bytes; CLS; JP 206
+    const auto kRom = assemble({0x1206, 0xF0F0, 0x9090, 0x00E0, 0x1206});
+
+    const auto kBlocks = findBlocks(kRom);
+
+    ASSERT_EQ(kBlocks.size(), 2U);
+    EXPECT_EQ(kBlocks[0].entry, 0x200);
+    EXPECT_EQ(kBlocks[1].entry, 0x206);
+    EXPECT_EQ(kBlocks[1].end, 0x20A);
+}
+
+TEST(RecompilerTest, EmitsProgramDefinition) {
+    const auto kRom = assemble({0xA20A, 0xF033, 0xD015, 0xB300});
+
+    std::stringstream output;
+    emit(output, kRom, "sample");
+    const auto kSource = output.str();
+
+    EXPECT_NE(kSource.find("const Program& sample()"), std::string::npos);
+    EXPECT_NE(kSource.find("std::size_t block200("), std::string::npos);
+    // Complex ops go through the instruction set
+    EXPECT_NE(kSource.find("is::opDxyn(state, 0xD015);"), std::string::npos);
+    // Stores into code are reported to the runner
+    EXPECT_NE(kSource.find("runner.stored(kIndex, 3)"), std::string::npos);
+}
+
+TEST(RecompilerTest, EmitsTimedOpsAlone) {
+    // LD V0, 5; LD DT, V0; LD V1, DT; JP 206
+    const auto kRom = assemble({0x6005, 0xF015, 0xF107, 0x1206});
+
+    std::stringstream output;
+    emit(output, kRom, "sample");
+    const auto kSource = output.str();
+
+    // Each timer op runs with the timers ticked for the ops before
+    EXPECT_NE(kSource.find("{0x200, 0x202, block200}"), std::string::npos);
+    EXPECT_NE(kSource.find("{0x202, 0x204, block202}"), std::string::npos);
+    EXPECT_NE(kSource.find("{0x204, 0x206, block204}"), std::string::npos);
+}
+
+TEST(RecompilerTest, RejectsOversizedRoms) {
+    const std::vector<std::uint8_t> kRom(4096 - 0x200 + 1);
+    std::stringstream output;
+
+    EXPECT_THROW(findBlocks(kRom), emu::RomSizeError);
+    EXPECT_THROW(emit(output, {}, "not an identifier"), std::invalid_argument);
+}
+
+// ============================================================================
+// Runner
+// ============================================================================
+
+// Recompiled form of: LD V1, 7; JP 200
+inline std::size_t sampleBlock(emu::ChipState& state,
+                               emu::aot::Runner& /* not used */) {
+    state.V[0x1] = 0x07;
+    state.program_counter = 0x200;
+    return 2;
+}
+
+constexpr std::array<std::uint8_t, 4> kSampleImage{0x61, 0x07, 0x12, 0x00};
+constexpr std::array<emu::aot::Entry, 1> kSampleEntries{{
+    {0x200, 0x204, sampleBlock},
+}};
+constexpr emu::aot::Program kSample{kSampleImage, kSampleEntries};
+
+class RunnerTest : public ::testing::Test {
+   protected:
+    emu::ChipState state_;
+    emu::aot::Runner runner_;
+
+    void SetUp() override {
+        state_ = emu::ChipState();
+        std::ranges::copy(kSampleImage, std::next(state_.memory.begin(), 0x200));
+    }
+};
+
+TEST_F(RunnerTest, RunsRecompiledBlocks) {
+    ASSERT_TRUE(runner_.attach(kSample, state_.memory));
+
+    EXPECT_EQ(runner_.step(state_), 2U);
+    EXPECT_EQ(state_.V[1], 0x07);
+    EXPECT_EQ(state_.program_counter, 0x200);
+}
+
+TEST_F(RunnerTest, FallsBackOutsideRecompiledCode) {
+    ASSERT_TRUE(runner_.attach(kSample, state_.memory));
+
+    state_.program_counter = 0x202;
+    EXPECT_EQ(runner_.step(state_), 0U);
+}
+
+TEST_F(RunnerTest, FallsBackAfterCodeIsOverwritten) {
+    ASSERT_TRUE(runner_.attach(kSample, state_.memory));
+
+    EXPECT_FALSE(runner_.stored(0x300, 2));
+    EXPECT_EQ(runner_.step(state_), 2U);
+
+    // Stores into the page that leave the block's bytes alone
+    state_.memory[0x210] = 0x01;
+    EXPECT_TRUE(runner_.stored(0x210, 1));
+    EXPECT_EQ(runner_.step(state_), 2U);
+
+    state_.memory[0x201] = 0x08;
+    EXPECT_TRUE(runner_.stored(0x201, 1));
+    EXPECT_EQ(runner_.step(state_), 0U);
+
+    // Restored code runs recompiled again
+    state_.memory[0x201] = 0x07;
+    EXPECT_TRUE(runner_.stored(0x201, 1));
+    EXPECT_EQ(runner_.step(state_), 2U);
+}
+
+TEST_F(RunnerTest, RejectsDifferentRom) {
+    state_.memory[0x201] = 0x08;
+
+    EXPECT_FALSE(runner_.attach(kSample, state_.memory));
+    EXPECT_EQ(runner_.step(state_), 0U);
+}
+
+}  // namespace emu::recompiler::test
+
+#endif /* TEST_RECOMPILER_HPP */
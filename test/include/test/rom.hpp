@@ -0,0 +1,128 @@
+#ifndef TEST_ROM_HPP
+#define TEST_ROM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "chip_8/error.hpp"
+#include "chip_8/random.hpp"
+#include "chip_8/rom.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::rom::test {
+
+class RomTest : public ::testing::Test {
+   protected:
+    std::filesystem::path directory_ =
+        std::filesystem::temp_directory_path() / "chip-8-test-roms";
+
+    void SetUp() override {
+        std::filesystem::remove_all(directory_);
+        std::filesystem::create_directories(directory_);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(directory_); }
+
+    std::filesystem::path write(const std::string& name,
+                                const std::vector<std::uint8_t>& rom) {
+        const auto kPath = directory_ / name;
+        std::ofstream file(kPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(rom.data()),  // NOLINT
+                   static_cast<std::streamsize>(rom.size()));
+        return kPath;
+    }
+};
+
+TEST_F(RomTest, ReadsUpToProgramSpace) {
+    EXPECT_EQ(read(write("full.ch8", std::vector<std::uint8_t>(kMaxSize, 1)))
+                  .size(),
+              kMaxSize);
+    EXPECT_THROW(
+        read(write("large.ch8", std::vector<std::uint8_t>(kMaxSize + 1, 1))),
+        RomSizeError);
+    EXPECT_TRUE(read(write("empty.ch8", {})).empty());
+    EXPECT_THROW(read(directory_ / "missing.ch8"), RomLoadError);
+}
+
+TEST_F(RomTest, IndexRoundTripsProfiles) {
+    const std::vector<std::uint8_t> kRom{0x12, 0x00};
+
+    Index index;
+    const auto kHash = index.add(directory_ / "a b.ch8", kRom, 42).hash;
+    EXPECT_EQ(kHash, contentHash(kRom));
+    ASSERT_TRUE(index.setProfile(kHash, {random::Mode::kCosmacVip, 1000}));
+
+    std::stringstream saved;
+    index.save(saved);
+    const auto kLoaded = Index::load(saved);
+
+    const auto* entry = kLoaded.find(kHash);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->path, (directory_ / "a b.ch8").string());
+    EXPECT_EQ(entry->modified, 42);
+    EXPECT_EQ(entry->profile, (Profile{random::Mode::kCosmacVip, 1000}));
+    EXPECT_EQ(entry->metadata, index.find(kHash)->metadata);
+    EXPECT_EQ(entry->metadata.blocks, 1U);
+
+    std::stringstream broken("00ff 2 0 fast 700 1 2 0 0 rom.ch8\n");
+    EXPECT_THROW(Index::load(broken), RomIndexFormatError);
+}
+
+TEST_F(RomTest, ScanOnlyReadsChangedFiles) {
+    write("a.ch8", {0x12, 0x00});
+    write("b.ch8", {0x12, 0x02, 0x00, 0xE0});
+    write("notes.txt", {0x00});
+
+    Index index;
+    EXPECT_EQ(index.scan(directory_), 2U);
+    EXPECT_EQ(index.size(), 2U);
+    EXPECT_EQ(index.scan(directory_), 0U);
+
+    // Renaming keeps the profile, removing drops the entry
+    const auto kHash = contentHash(std::vector<std::uint8_t>{0x12, 0x00});
+    index.setProfile(kHash, {random::Mode::kXorshift, 1500});
+    std::filesystem::rename(directory_ / "a.ch8", directory_ / "c.ch8");
+    std::filesystem::remove(directory_ / "b.ch8");
+
+    EXPECT_EQ(index.scan(directory_), 1U);
+    EXPECT_EQ(index.size(), 1U);
+    ASSERT_NE(index.find(kHash), nullptr);
+    EXPECT_EQ(index.find(kHash)->profile.speed, 1500U);
+}
+
+TEST_F(RomTest, CopiesShareOneEntry) {
+    const std::vector<std::uint8_t> kRom{0x12, 0x00};
+    write("a.ch8", kRom);
+    write("b.ch8", kRom);
+
+    Index index;
+    EXPECT_EQ(index.scan(directory_), 2U);
+    EXPECT_EQ(index.size(), 1U);
+    // Both copies stay known, neither is read again
+    EXPECT_EQ(index.scan(directory_), 0U);
+
+    std::stringstream saved;
+    index.save(saved);
+    auto loaded = Index::load(saved);
+    EXPECT_EQ(loaded.scan(directory_), 0U);
+
+    // The entry lives on while a copy is left
+    const auto kHash = contentHash(kRom);
+    std::filesystem::remove(directory_ / "a.ch8");
+    EXPECT_EQ(loaded.scan(directory_), 0U);
+    ASSERT_NE(loaded.find(kHash), nullptr);
+    EXPECT_EQ(loaded.find(kHash)->path, (directory_ / "b.ch8").string());
+
+    std::filesystem::remove(directory_ / "b.ch8");
+    EXPECT_EQ(loaded.scan(directory_), 0U);
+    EXPECT_EQ(loaded.size(), 0U);
+}
+
+}  // namespace emu::rom::test
+
+#endif /* TEST_ROM_HPP */
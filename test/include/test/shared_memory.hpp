@@ -0,0 +1,103 @@
+#ifndef TEST_SHARED_MEMORY_HPP
+#define TEST_SHARED_MEMORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/display.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/fault.hpp"
+#include "chip_8/shared_memory.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::shared_memory::test {
+
+class SharedMemoryTest : public ::testing::Test {
+   protected:
+    // Tests of concurrent runs must not share an object
+    std::string name_ = "/chip-8-test-" + std::to_string(::getpid());
+};
+
+TEST_F(SharedMemoryTest, SubscriberReadsPublishedState) {
+    EXPECT_THROW(Subscriber{name_}, SharedMemoryError);
+
+    Publisher publisher(name_);
+    const Subscriber kSubscriber(name_);
+
+    ChipState state;
+    state.V[0x0] = 0x12;
+    state.V[0xF] = 0x01;
+    state.program_counter = 0x2A4;
+    state.index_register = 0x3FF;
+    state.delay_timer = 7;
+    state.sound_timer = 9;
+    state.keys = 0x8001;
+    state.stack.push(0x202);
+    state.fault.status = fault::Status::kInvalidInstruction;
+    display::setPixel(state.display, 0, 0, true);
+    display::setPixel(state.display, display::kWidth - 1,
+                      display::kHeight - 1, true);
+    publisher.publish(state);
+
+    Snapshot snapshot;
+    ASSERT_TRUE(kSubscriber.read(snapshot));
+    EXPECT_EQ(kSubscriber.frame(), 1U);
+    EXPECT_EQ(snapshot.frame, 1U);
+    EXPECT_EQ(snapshot.V, state.V);
+    EXPECT_EQ(snapshot.program_counter, 0x2A4);
+    EXPECT_EQ(snapshot.index_register, 0x3FF);
+    EXPECT_EQ(snapshot.delay_timer, 7);
+    EXPECT_EQ(snapshot.sound_timer, 9);
+    EXPECT_EQ(snapshot.keys, 0x8001);
+    EXPECT_EQ(snapshot.stack_size, 1);
+    EXPECT_EQ(snapshot.fault, fault::Status::kInvalidInstruction);
+    EXPECT_EQ(snapshot.display.rows, state.display.rows);
+}
+
+TEST_F(SharedMemoryTest, ReadsAreNeverTorn) {
+    Publisher publisher(name_);
+    const Subscriber kSubscriber(name_);
+
+    // Every field of a frame carries the same value, a torn read mixes two
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        ChipState state;
+        for (std::uint16_t value = 0; value < 20000; value++) {
+            state.V.fill(static_cast<std::uint8_t>(value));
+            state.program_counter = value;
+            state.display.rows.fill(value);
+            publisher.publish(state);
+        }
+        done = true;
+    });
+
+    std::size_t reads = 0;
+    Snapshot snapshot;
+    while (!done) {
+        if (!kSubscriber.read(snapshot)) {
+            continue;
+        }
+        reads++;
+        const auto kValue = snapshot.program_counter;
+        ASSERT_EQ(snapshot.V[0], static_cast<std::uint8_t>(kValue));
+        ASSERT_EQ(snapshot.V[0xF], static_cast<std::uint8_t>(kValue));
+        ASSERT_EQ(snapshot.display.rows[0], kValue);
+        ASSERT_EQ(snapshot.display.rows[display::kHeight - 1], kValue);
+    }
+    writer.join();
+
+    ASSERT_TRUE(kSubscriber.read(snapshot));
+    EXPECT_EQ(snapshot.program_counter, 19999);
+    EXPECT_GT(reads, 0U);
+}
+
+}  // namespace emu::shared_memory::test
+
+#endif /* TEST_SHARED_MEMORY_HPP */
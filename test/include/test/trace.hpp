@@ -0,0 +1,169 @@
+#ifndef TEST_TRACE_HPP
+#define TEST_TRACE_HPP
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "chip_8/chip_state.hpp"
+#include "chip_8/error.hpp"
+#include "chip_8/instruction_set.hpp"
+#include "chip_8/spsc_queue.hpp"
+#include "chip_8/trace.hpp"
+
+#include "gtest/gtest.h"
+
+namespace emu::trace::test {
+
+// ============================================================================
+// Queue
+// ============================================================================
+
+TEST(SpscQueueTest, PreservesOrderAcrossWrapAround) {
+    SpscQueue<int, 4> queue;
+    std::array<int, 4> output{};
+
+    for (int round = 0; round < 3; round++) {
+        EXPECT_TRUE(queue.push(round * 10));
+        EXPECT_TRUE(queue.push((round * 10) + 1));
+        EXPECT_EQ(queue.pop(output), 2U);
+        EXPECT_EQ(output[0], round * 10);
+        EXPECT_EQ(output[1], (round * 10) + 1);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, RejectsPushWhenFull) {
+    SpscQueue<int, 2> queue;
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_FALSE(queue.push(3));
+}
+
+// ============================================================================
+// Encoding
+// ============================================================================
+
+inline std::vector<Record> sampleRecords() {
+    std::vector<Record> records(3);
+    records[0] = {0, 0x200, 0x6A05, 0x000, 1U << 0xAU, 0, 0, 0, 0, {}};
+    records[0].V[0xA] = 0x05;
+    records[1] = {1, 0x202, 0xA300, 0x300, 0, 0, 0, 0, 0, records[0].V};
+    // Jump somewhere else and skip a few sequence numbers
+    records[2] = {7, 0x400, 0x2500, 0x300, 0, 3, 2, 1, 0, records[0].V};
+    return records;
+}
+
+inline void expectRoundTrip(const bool compressed) {
+    const auto kRecords = sampleRecords();
+
+    std::stringstream stream;
+    Writer writer(stream, compressed);
+    writer.write(kRecords);
+
+    Reader reader(stream);
+    EXPECT_EQ(reader.compressed(), compressed);
+
+    Record record{};
+    for (const auto& expected : kRecords) {
+        ASSERT_TRUE(reader.next(record));
+        EXPECT_EQ(record.sequence, expected.sequence);
+        EXPECT_EQ(record.address, expected.address);
+        EXPECT_EQ(record.bytecode, expected.bytecode);
+        EXPECT_EQ(record.index_register, expected.index_register);
+        EXPECT_EQ(record.changed, expected.changed);
+        EXPECT_EQ(record.delay_timer, expected.delay_timer);
+        EXPECT_EQ(record.sound_timer, expected.sound_timer);
+        EXPECT_EQ(record.stack_depth, expected.stack_depth);
+        EXPECT_EQ(record.V, expected.V);
+    }
+    EXPECT_FALSE(reader.next(record));
+}
+
+TEST(TraceTest, RawRoundTrip) {
+    expectRoundTrip(false);
+}
+
+TEST(TraceTest, CompressedRoundTrip) {
+    expectRoundTrip(true);
+}
+
+TEST(TraceTest, CompressionShrinksSequentialRecords) {
+    std::vector<Record> records(100);
+    for (std::uint32_t idx = 0; idx < records.size(); idx++) {
+        records[idx].sequence = idx;
+        records[idx].address = static_cast<std::uint16_t>(0x200 + (idx * 2));
+        records[idx].bytecode = 0x0000;
+    }
+
+    std::stringstream raw;
+    Writer(raw, false).write(records);
+    std::stringstream compressed;
+    Writer(compressed, true).write(records);
+
+    EXPECT_LT(compressed.str().size() * 8, raw.str().size());
+}
+
+TEST(TraceTest, RejectsForeignStreams) {
+    std::stringstream stream("not a trace at all");
+    EXPECT_THROW(Reader reader(stream), emu::TraceFormatError);
+}
+
+// ============================================================================
+// Recorder
+// ============================================================================
+
+TEST(TraceTest, RecorderStreamsEveryInstruction) {
+    const auto kPath =
+        std::filesystem::temp_directory_path() / "chip-8-test.trace";
+    constexpr std::uint32_t kInstructions = 200000;
+
+    {
+        Recorder recorder(kPath, true);
+        emu::ChipState state;
+        for (std::uint32_t idx = 0; idx < kInstructions; idx++) {
+            recorder.begin(state);
+            emu::instruction_set::op7xkk(state, 0x7101);
+            recorder.end(0x200, 0x7101, state);
+        }
+    }
+
+    std::ifstream file(kPath, std::ifstream::binary);
+    Reader reader(file);
+    Record record{};
+    std::uint32_t count = 0;
+    while (reader.next(record)) {
+        EXPECT_EQ(record.sequence, count);
+        EXPECT_EQ(record.changed, 1U << 1U);
+        count += 1;
+    }
+
+    EXPECT_EQ(count, kInstructions);
+    std::filesystem::remove(kPath);
+}
+
+TEST(TraceTest, RecorderReportsWriteFailures) {
+    // Every write to /dev/full fails for lack of space
+    if (!std::filesystem::exists("/dev/full")) {
+        GTEST_SKIP();
+    }
+
+    Recorder recorder("/dev/full", false);
+    emu::ChipState state;
+    // More than the writer buffers, so the failure surfaces before the flush
+    for (std::uint32_t idx = 0; idx < 100000; idx++) {
+        recorder.begin(state);
+        recorder.end(0x200, 0x7101, state);
+    }
+    recorder.finish();
+    EXPECT_TRUE(recorder.failed());
+    EXPECT_EQ(recorder.dropped(), 0U);
+}
+
+}  // namespace emu::trace::test
+
+#endif /* TEST_TRACE_HPP */
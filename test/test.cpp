@@ -1,5 +1,24 @@
 // IWYU pragma: begin_keep
+#include "test/analysis.hpp"
+#include "test/assembler.hpp"
+#include "test/block_cache.hpp"
+#include "test/capture.hpp"
+#include "test/environment.hpp"
+#include "test/frontend.hpp"
+#include "test/golden.hpp"
 #include "test/instruction_set.hpp"
+#include "test/instrumentation.hpp"
+#include "test/lockstep.hpp"
+#include "test/netplay.hpp"
+#include "test/pacing.hpp"
+#include "test/parse.hpp"
+#include "test/predecoder.hpp"
+#include "test/profiler.hpp"
+#include "test/random.hpp"
+#include "test/recompiler.hpp"
+#include "test/rom.hpp"
+#include "test/shared_memory.hpp"
+#include "test/trace.hpp"
 // IWYU pragma: end_keep
 
 #include "gtest/gtest.h"
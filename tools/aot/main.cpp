@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chip_8/recompiler.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-aot <rom> <output.cpp> [--name NAME]\n"
+    "  --name NAME  program identifier, defaults to the ROM file name\n";
+
+// Derive an identifier from the ROM file name, e.g. snake.ch8 -> snake
+std::string defaultName(const std::filesystem::path& rom) {
+    auto name = rom.stem().string();
+    for (auto& character : name) {
+        const bool kWord = (character >= 'a' && character <= 'z') ||
+                           (character >= 'A' && character <= 'Z') ||
+                           (character >= '0' && character <= '9');
+        if (!kWord) {
+            character = '_';
+        }
+    }
+    if (name.empty() || (name.front() >= '0' && name.front() <= '9')) {
+        name.insert(name.begin(), '_');
+    }
+    return name;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3 && argc != 5) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    // NOLINTBEGIN (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const std::filesystem::path kRom = argv[1];
+    const std::filesystem::path kOutput = argv[2];
+    if (argc == 5 && std::string_view(argv[3]) != "--name") {
+        std::cerr << "Invalid option: " << argv[3] << '\n' << kUsage;
+        return 1;
+    }
+    const std::string kName = argc == 5 ? argv[4] : defaultName(kRom);
+    // NOLINTEND (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    std::ifstream file(kRom, std::ifstream::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open " << kRom << '\n';
+        return 1;
+    }
+    const std::vector<std::uint8_t> kBytes(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+
+    try {
+        std::ofstream output(kOutput);
+        if (!output.is_open()) {
+            std::cerr << "Cannot open " << kOutput << '\n';
+            return 1;
+        }
+        emu::recompiler::emit(output, kBytes, kName);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
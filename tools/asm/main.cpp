@@ -0,0 +1,150 @@
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "chip_8/assembler.hpp"
+#include "chip_8/parse.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-asm <source> <rom>\n"
+    "       chip-8-asm --workload <draw|alu|call|timer> <rom> [--rounds N]\n"
+    "  --workload KIND  assemble a generated benchmark program instead\n"
+    "  --rounds N       kernel repetitions of the workload, 1-255 "
+    "(default 16)\n"
+    "  --source FILE    also write the generated source to FILE\n";
+
+constexpr std::uint8_t kDefaultRounds = 16;
+
+std::optional<emu::assembler::Workload> parseWorkload(
+    const std::string_view name) {
+    using emu::assembler::Workload;
+    if (name == "draw") {
+        return Workload::kDraw;
+    }
+    if (name == "alu") {
+        return Workload::kAlu;
+    }
+    if (name == "call") {
+        return Workload::kCall;
+    }
+    if (name == "timer") {
+        return Workload::kTimerWait;
+    }
+    return std::nullopt;
+}
+
+bool writeFile(const std::string& path, const std::string_view contents) {
+    std::ofstream file(path, std::ofstream::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open " << path << '\n';
+        return false;
+    }
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    std::optional<emu::assembler::Workload> workload;
+    std::uint8_t rounds = kDefaultRounds;
+    std::string source_path;
+    std::string input;
+    std::string output;
+
+    for (int arg = 1; arg < argc; ++arg) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const std::string_view kArg = argv[arg];
+        if (kArg.starts_with("--")) {
+            if (arg + 1 >= argc) {
+                std::cerr << "Missing value for " << kArg << '\n' << kUsage;
+                return 1;
+            }
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            const std::string_view kValue = argv[++arg];
+            if (kArg == "--workload") {
+                workload = parseWorkload(kValue);
+                if (!workload) {
+                    std::cerr << "Invalid workload: " << kValue << '\n';
+                    return 1;
+                }
+            } else if (kArg == "--rounds") {
+                const auto kRounds =
+                    emu::parse::bounded<std::uint8_t>(kValue, 1, 0xFF);
+                if (!kRounds) {
+                    std::cerr << "Invalid rounds: " << kValue << '\n';
+                    return 1;
+                }
+                rounds = *kRounds;
+            } else if (kArg == "--source") {
+                source_path = kValue;
+            } else {
+                std::cerr << "Invalid option: " << kArg << '\n' << kUsage;
+                return 1;
+            }
+        } else if (!workload && input.empty()) {
+            input = kArg;
+        } else if (output.empty()) {
+            output = kArg;
+        } else {
+            std::cerr << kUsage;
+            return 1;
+        }
+    }
+    // The only positional argument of a workload is the output
+    if (workload && output.empty()) {
+        output = std::move(input);
+        input.clear();
+    }
+    if (output.empty() || (workload && !input.empty())) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    std::string source;
+    if (workload) {
+        source = emu::assembler::generate(*workload, rounds);
+    } else {
+        std::ifstream file(input);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open " << input << '\n';
+            return 1;
+        }
+        source.assign(std::istreambuf_iterator<char>(file),
+                      std::istreambuf_iterator<char>());
+    }
+
+    try {
+        const auto kProgram = emu::assembler::assemble(source);
+
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-type-reinterpret-cast)
+        if (!writeFile(output, {reinterpret_cast<const char*>(
+                                    kProgram.bytes.data()),
+                                kProgram.bytes.size()})) {
+            return 1;
+        }
+        if (!source_path.empty() && !writeFile(source_path, source)) {
+            return 1;
+        }
+        std::cout << "Wrote " << kProgram.bytes.size() << " bytes to "
+                  << output << '\n';
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#include "chip_8/capture.hpp"
+#include "chip_8/display.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-capture <capture> [--pbm DIR]\n"
+    "Prints the length and size of a capture. --pbm writes every frame to\n"
+    "DIR as frame_NNNNNN.pbm, e.g. for ffmpeg -framerate 60 -i "
+    "DIR/frame_%06d.pbm\n";
+
+/**
+ * @brief Write a frame as a binary portable bitmap, the packed rows already
+ * are its pixel data once stored big-endian
+ *
+ * @param path
+ * @param frame
+ */
+void writePbm(const std::filesystem::path& path,
+              const emu::capture::Frame& frame) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << std::format("P4\n{} {}\n", emu::display::kWidth,
+                        emu::display::kHeight);
+    for (const auto kRow : frame.rows) {
+        std::array<char, emu::display::kWidth / 8> bytes{};
+        for (std::size_t n = 0; n < bytes.size(); n++) {
+            bytes[n] = static_cast<char>(kRow >> (56 - (8 * n)));
+        }
+        file.write(bytes.data(), bytes.size());
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 4) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    std::filesystem::path frames_directory;
+    if (argc == 4) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (std::string_view(argv[2]) != "--pbm") {
+            std::cerr << kUsage;
+            return 1;
+        }
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        frames_directory = argv[3];
+    }
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const std::filesystem::path kPath = argv[1];
+    std::ifstream file(kPath, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open " << kPath.string() << '\n';
+        return 1;
+    }
+
+    try {
+        if (!frames_directory.empty()) {
+            std::filesystem::create_directories(frames_directory);
+        }
+
+        emu::capture::Reader reader(file);
+        emu::capture::Frame frame{};
+        std::size_t frames = 0;
+        for (; reader.next(frame); frames++) {
+            if (!frames_directory.empty()) {
+                writePbm(frames_directory /
+                             std::format("frame_{:06}.pbm", frames),
+                         frame);
+            }
+        }
+
+        const auto kBytes = std::filesystem::file_size(kPath);
+        std::cout << std::format(
+            "{} frames over {:.1f} s, {} bytes, {:.1f} bytes per frame\n",
+            frames, static_cast<double>(frame.timestamp) / 1e6, kBytes,
+            frames == 0 ? 0.0
+                        : static_cast<double>(kBytes) /
+                              static_cast<double>(frames));
+        if (reader.dropped() != 0) {
+            std::cout << std::format("{} frames dropped while recording\n",
+                                     reader.dropped());
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
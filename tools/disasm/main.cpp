@@ -0,0 +1,106 @@
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chip_8/analysis.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-disasm <rom> [options]\n"
+    "  --listing FILE  write the annotated listing to FILE ('-' for stdout)\n"
+    "  --dot FILE      write the control-flow graph in DOT format to FILE\n"
+    "Without options the listing is written to stdout.\n";
+
+struct Outputs {
+    std::string listing;
+    std::string dot;
+};
+
+bool parseOption(const std::string_view option,
+                 const std::string_view value,
+                 Outputs& outputs) {
+    if (option == "--listing") {
+        outputs.listing = value;
+        return true;
+    }
+    if (option == "--dot") {
+        outputs.dot = value;
+        return true;
+    }
+    return false;
+}
+
+template <typename Writer>
+bool write(const std::string& path,
+           const emu::analysis::Analysis& analysis,
+           Writer writer) {
+    if (path == "-") {
+        writer(std::cout, analysis);
+        return true;
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open " << path << '\n';
+        return false;
+    }
+    writer(file, analysis);
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc % 2 != 0) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    Outputs outputs;
+    for (int arg = 2; arg + 1 < argc; arg += 2) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (!parseOption(argv[arg], argv[arg + 1], outputs)) {
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            std::cerr << "Invalid option: " << argv[arg] << '\n' << kUsage;
+            return 1;
+        }
+    }
+    if (outputs.listing.empty() && outputs.dot.empty()) {
+        outputs.listing = "-";
+    }
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::ifstream file(argv[1], std::ifstream::binary);
+    if (!file.is_open()) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::cerr << "Cannot open " << argv[1] << '\n';
+        return 1;
+    }
+    const std::vector<std::uint8_t> kRom(
+        (std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+
+    try {
+        const auto kAnalysis = emu::analysis::analyse(kRom);
+
+        if (!outputs.listing.empty() &&
+            !write(outputs.listing, kAnalysis, emu::analysis::writeListing)) {
+            return 1;
+        }
+        if (!outputs.dot.empty() &&
+            !write(outputs.dot, kAnalysis, emu::analysis::writeDot)) {
+            return 1;
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
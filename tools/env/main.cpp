@@ -0,0 +1,137 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "chip_8/environment.hpp"
+#include "chip_8/golden.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/parse.hpp"
+#include "chip_8/random.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-env <rom> [options]\n"
+    "  --envs N          environments stepped together (default 256)\n"
+    "  --threads N       worker threads, 0 for one per core (default 0)\n"
+    "  --steps N         batch steps to run (default 1000)\n"
+    "  --frame-skip N    frames per step (default 4)\n"
+    "  --max-frames N    frames per episode, 0 for no limit (default 0)\n"
+    "Steps a batch of environments with random keys and reports environment\n"
+    "steps per second. <rom> is a path or a chip-8-golden ROM such as\n"
+    "workload:draw:64.\n";
+
+struct Options {
+    std::size_t envs{256};
+    std::size_t threads{};
+    std::size_t steps{1000};
+    std::size_t frame_skip{4};
+    std::uint64_t max_frames{};
+};
+
+bool parseOption(const std::string_view option,
+                 const std::string_view value,
+                 Options& options) {
+    if (option == "--envs") {
+        const auto kEnvs = emu::parse::number<std::size_t>(value);
+        options.envs = kEnvs.value_or(0);
+        return options.envs > 0;
+    }
+    if (option == "--threads") {
+        const auto kThreads = emu::parse::number<std::size_t>(value);
+        options.threads = kThreads.value_or(0);
+        return kThreads.has_value();
+    }
+    if (option == "--steps") {
+        const auto kSteps = emu::parse::number<std::size_t>(value);
+        options.steps = kSteps.value_or(0);
+        return kSteps.has_value();
+    }
+    if (option == "--frame-skip") {
+        const auto kFrameSkip = emu::parse::number<std::size_t>(value);
+        options.frame_skip = kFrameSkip.value_or(0);
+        return options.frame_skip > 0;
+    }
+    if (option == "--max-frames") {
+        const auto kMaxFrames = emu::parse::number<std::uint64_t>(value);
+        options.max_frames = kMaxFrames.value_or(0);
+        return kMaxFrames.has_value();
+    }
+    return false;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    Options options;
+    for (int arg = 2; arg < argc; arg += 2) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const std::string_view kOption = argv[arg];
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (arg + 1 >= argc || !parseOption(kOption, argv[arg + 1], options)) {
+            std::cerr << "Invalid option: " << kOption << '\n' << kUsage;
+            return 1;
+        }
+    }
+
+    try {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const auto kRom = emu::golden::loadRom(argv[1],
+                                               std::filesystem::current_path());
+
+        emu::environment::Config config;
+        config.frame_skip = options.frame_skip;
+        config.max_frames = options.max_frames;
+        emu::environment::Batch batch(kRom, options.envs, options.threads,
+                                      config);
+        batch.reset(1);
+
+        // Drawn upfront, so the timed loop only steps
+        emu::random::Generator generator;
+        std::vector<emu::keyboard::Type> actions(options.envs * options.steps);
+        for (auto& action : actions) {
+            action = static_cast<emu::keyboard::Type>(
+                1U << (generator.next() % emu::keyboard::kNumKeys));
+        }
+
+        std::size_t episodes = 0;
+        const auto kStart = std::chrono::steady_clock::now();
+        for (std::size_t step = 0; step < options.steps; step++) {
+            batch.step(std::span(actions).subspan(step * options.envs,
+                                                  options.envs));
+            for (const auto kDone : batch.dones()) {
+                episodes += kDone;
+            }
+        }
+        const std::chrono::duration<double> kElapsed =
+            std::chrono::steady_clock::now() - kStart;
+
+        const auto kSteps =
+            static_cast<double>(options.envs * options.steps);
+        std::cout << std::format(
+            "{} environments on {} threads, {} steps of {} frames in {:.3f} "
+            "s\n{:.0f} steps/s, {:.0f} frames/s, {} episodes ended\n",
+            options.envs, batch.threads(), options.steps, options.frame_skip,
+            kElapsed.count(), kSteps / kElapsed.count(),
+            kSteps * static_cast<double>(options.frame_skip) /
+                kElapsed.count(),
+            episodes);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "chip_8/golden.hpp"
+#include "chip_8/parse.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-golden <manifest> <goldens> [options]\n"
+    "  --update               record the current results as golden values\n"
+    "  --time-tolerance F     fail when a ROM runs more than F times slower\n"
+    "                         than its golden time scaled to this machine's\n"
+    "                         speed (default 1, 0 to only report)\n"
+    "  --repeat N             runs per ROM, the fastest one is timed "
+    "(default 3)\n";
+
+struct Options {
+    bool update{};
+    double time_tolerance{1.0};
+    std::size_t repeat{3};
+};
+
+bool parseOption(const std::string_view option,
+                 const std::string_view value,
+                 Options& options) {
+    if (option == "--time-tolerance") {
+        const auto kTolerance = emu::parse::number<double>(value);
+        options.time_tolerance = kTolerance.value_or(-1.0);
+        return options.time_tolerance >= 0.0;
+    }
+    if (option == "--repeat") {
+        const auto kRepeat = emu::parse::number<std::size_t>(value);
+        options.repeat = kRepeat.value_or(0);
+        return options.repeat > 0;
+    }
+    return false;
+}
+
+double milliseconds(const std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/**
+ * @brief Compare a run with its golden values
+ *
+ * @param speed of this machine, see emu::golden::machineSpeed
+ * @return whether the run passed
+ */
+bool check(const std::string& name,
+           const emu::golden::Result& result,
+           const emu::golden::Goldens& goldens,
+           const double speed,
+           const Options& options) {
+    const auto kGolden = goldens.find(name);
+    if (kGolden == goldens.end()) {
+        std::cout << std::format("{}: no golden values, run with --update\n",
+                                 name);
+        return false;
+    }
+
+    bool passed = true;
+    const auto& expected = kGolden->second.checkpoints;
+    for (std::size_t i = 0;
+         i < std::max(expected.size(), result.checkpoints.size()); i++) {
+        if (i >= expected.size() || i >= result.checkpoints.size()) {
+            std::cout << std::format(
+                "{}: {} checkpoints, expected {}\n", name,
+                result.checkpoints.size(), expected.size());
+            passed = false;
+            break;
+        }
+        const auto& actual = result.checkpoints[i];
+        if (actual != expected[i]) {
+            std::cout << std::format(
+                "{}: frame {} display {:016x} state {:016x}, expected frame "
+                "{} display {:016x} state {:016x}\n",
+                name, actual.frame, actual.display, actual.state,
+                expected[i].frame, expected[i].display, expected[i].state);
+            passed = false;
+        }
+    }
+
+    // Golden time on the machine that recorded it, scaled to this one
+    const auto kGoldenTime = kGolden->second.elapsed;
+    const auto kExpected = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double, std::nano>(
+            static_cast<double>(kGoldenTime.count()) / speed));
+    const auto kLimit = static_cast<double>(kExpected.count()) *
+                        (1.0 + options.time_tolerance);
+    const bool kSlow = options.time_tolerance > 0.0 &&
+                       kGoldenTime.count() > 0 &&
+                       static_cast<double>(result.elapsed.count()) > kLimit;
+    std::cout << std::format(
+        "{}: {} {:.3f} ms (golden {:.3f} ms, {:.3f} ms at this speed)\n",
+        name, !passed ? "FAILED" : (kSlow ? "SLOW" : "ok"),
+        milliseconds(result.elapsed), milliseconds(kGoldenTime),
+        milliseconds(kExpected));
+
+    return passed && !kSlow;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    Options options;
+    for (int arg = 3; arg < argc; arg++) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const std::string_view kOption = argv[arg];
+        if (kOption == "--update") {
+            options.update = true;
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        } else if (arg + 1 >= argc || !parseOption(kOption, argv[++arg],
+                                                   options)) {
+            std::cerr << "Invalid option: " << kOption << '\n' << kUsage;
+            return 1;
+        }
+    }
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const std::filesystem::path kManifestPath = argv[1];
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const std::filesystem::path kGoldensPath = argv[2];
+
+    try {
+        std::ifstream manifest(kManifestPath);
+        if (!manifest.is_open()) {
+            std::cerr << "Cannot open " << kManifestPath.string() << '\n';
+            return 1;
+        }
+        const auto kScenarios = emu::golden::parseManifest(manifest);
+
+        emu::golden::Goldens goldens;
+        if (std::ifstream file(kGoldensPath); file.is_open()) {
+            goldens = emu::golden::readGoldens(file);
+        }
+
+        bool passed = true;
+        emu::golden::Goldens results;
+        for (const auto& scenario : kScenarios) {
+            const auto kRom = emu::golden::loadRom(
+                scenario.rom, kManifestPath.parent_path());
+
+            // Hashes must not change between runs, only the time may
+            auto result = emu::golden::run(scenario, kRom);
+            for (std::size_t run = 1; run < options.repeat; run++) {
+                const auto kRerun = emu::golden::run(scenario, kRom);
+                if (kRerun.checkpoints != result.checkpoints) {
+                    std::cout << scenario.name << ": nondeterministic\n";
+                    passed = false;
+                }
+                result.elapsed = std::min(result.elapsed, kRerun.elapsed);
+            }
+            results[scenario.name] = std::move(result);
+        }
+
+        if (!options.update) {
+            const auto kSpeed = emu::golden::machineSpeed(results, goldens);
+            std::cout << std::format(
+                "Machine speed {:.2f}x the one that recorded the goldens\n",
+                kSpeed);
+            for (const auto& scenario : kScenarios) {
+                passed = check(scenario.name, results[scenario.name],
+                               goldens, kSpeed, options) &&
+                         passed;
+            }
+        }
+
+        if (options.update) {
+            std::ofstream file(kGoldensPath);
+            if (!file.is_open()) {
+                std::cerr << "Cannot open " << kGoldensPath.string() << '\n';
+                return 1;
+            }
+            emu::golden::writeGoldens(file, results);
+            std::cout << "Recorded " << results.size() << " ROMs\n";
+        }
+
+        return passed ? 0 : 1;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+}
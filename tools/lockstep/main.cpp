@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "chip_8/golden.hpp"
+#include "chip_8/lockstep.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-lockstep <manifest> [--engine predecoder|blocks]\n"
+    "Runs every ROM of a chip-8-golden manifest on the engine, in lockstep\n"
+    "with the reference interpreter. Both engines are checked by default.\n";
+
+struct Candidate {
+    std::string_view name;
+    emu::lockstep::Engine engine;
+};
+
+constexpr std::array kCandidates{
+    Candidate{"predecoder", emu::lockstep::Engine::kPredecoder},
+    Candidate{"blocks", emu::lockstep::Engine::kBlockCache},
+};
+
+std::uint16_t keysAt(const emu::golden::Scenario& scenario,
+                     const std::uint32_t frame) {
+    std::uint16_t mask = 0;
+    for (const auto& press : scenario.presses) {
+        if (press.first <= frame && frame < press.last) {
+            mask |= static_cast<std::uint16_t>(1U << press.key);
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief Run a scenario frame by frame
+ *
+ * @return whether the engines agreed
+ */
+bool check(const emu::golden::Scenario& scenario,
+           const std::vector<std::uint8_t>& rom,
+           const Candidate& candidate) {
+    emu::lockstep::Checker checker(candidate.engine, rom);
+
+    for (std::uint32_t frame = 0; frame < scenario.frames; frame++) {
+        checker.press(keysAt(scenario, frame));
+
+        const auto kDivergence = checker.runUntil(
+            static_cast<std::uint64_t>(frame + 1) *
+            emu::golden::kInstructionsPerFrame);
+        if (kDivergence) {
+            std::cout << std::format("{} on {}: frame {}\n", scenario.name,
+                                     candidate.name, frame);
+            emu::lockstep::writeReport(std::cout, *kDivergence);
+            return false;
+        }
+
+        if (checker.fault().status != emu::fault::Status::kNone) {
+            break;
+        }
+    }
+
+    std::cout << std::format("{} on {}: ok, {} instructions, signature "
+                             "{:016x}\n",
+                             scenario.name, candidate.name,
+                             checker.instructions(), checker.signature());
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 4) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    std::vector<Candidate> candidates(kCandidates.begin(), kCandidates.end());
+    if (argc == 4) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const std::string_view kOption = argv[2];
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const std::string_view kEngine = argv[3];
+        std::erase_if(candidates, [kEngine](const Candidate& candidate) {
+            return candidate.name != kEngine;
+        });
+        if (kOption != "--engine" || candidates.empty()) {
+            std::cerr << kUsage;
+            return 1;
+        }
+    }
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const std::filesystem::path kManifestPath = argv[1];
+    std::ifstream manifest(kManifestPath);
+    if (!manifest.is_open()) {
+        std::cerr << "Cannot open " << kManifestPath.string() << '\n';
+        return 1;
+    }
+
+    try {
+        bool passed = true;
+        for (const auto& scenario : emu::golden::parseManifest(manifest)) {
+            const auto kRom = emu::golden::loadRom(
+                scenario.rom, kManifestPath.parent_path());
+            for (const auto& candidate : candidates) {
+                passed = check(scenario, kRom, candidate) && passed;
+            }
+        }
+        return passed ? 0 : 1;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "chip_8/golden.hpp"
+#include "chip_8/keyboard.hpp"
+#include "chip_8/netplay.hpp"
+#include "chip_8/parse.hpp"
+#include "chip_8/random.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-netplay <rom> [options]\n"
+    "  --frames N     frames each player runs (default 3600)\n"
+    "  --latency N    frames a packet takes to arrive (default 4)\n"
+    "  --delay N      frames of input delay, at most 8 (default 2)\n"
+    "Plays two rollback sessions against each other with random keys over a\n"
+    "simulated link, checks they end in the same state and reports the\n"
+    "rollbacks and their cost. <rom> is a path or a chip-8-golden ROM such\n"
+    "as workload:draw:64.\n";
+
+struct Options {
+    std::uint64_t frames{3600};
+    std::size_t latency{4};
+    std::size_t delay{2};
+};
+
+bool parseOption(const std::string_view option,
+                 const std::string_view value,
+                 Options& options) {
+    if (option == "--frames") {
+        const auto kFrames = emu::parse::number<std::uint64_t>(value);
+        options.frames = kFrames.value_or(0);
+        return kFrames.has_value();
+    }
+    if (option == "--latency") {
+        const auto kLatency = emu::parse::number<std::size_t>(value);
+        options.latency = kLatency.value_or(0);
+        return kLatency.has_value();
+    }
+    if (option == "--delay") {
+        const auto kDelay = emu::parse::bounded<std::size_t>(
+            value, 0, emu::netplay::kMaxRollback);
+        options.delay = kDelay.value_or(0);
+        return kDelay.has_value();
+    }
+    return false;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    Options options;
+    for (int arg = 2; arg < argc; arg += 2) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const std::string_view kOption = argv[arg];
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (arg + 1 >= argc || !parseOption(kOption, argv[arg + 1], options)) {
+            std::cerr << "Invalid option: " << kOption << '\n' << kUsage;
+            return 1;
+        }
+    }
+
+    try {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const auto kRom = emu::golden::loadRom(argv[1],
+                                               std::filesystem::current_path());
+
+        emu::netplay::Config config;
+        config.input_delay = options.delay;
+        std::array<emu::netplay::Session, 2> sessions{
+            emu::netplay::Session(kRom, config),
+            emu::netplay::Session(kRom, config)};
+        // Packets in flight, delivered options.latency ticks after being sent
+        std::array<std::deque<std::vector<std::uint8_t>>, 2> links;
+
+        emu::random::Generator generator;
+        std::array<emu::keyboard::Type, 2> keys{};
+        std::chrono::duration<double, std::micro> rollback_time{};
+        std::chrono::duration<double, std::micro> worst_rollback{};
+
+        // Bounded, the peers only stall while packets are in flight
+        const auto kTicks = 2 * (options.frames + options.latency + 1);
+        for (std::uint64_t tick = 0; tick < kTicks; tick++) {
+            for (std::size_t player = 0; player < 2; player++) {
+                auto& session = sessions[player];
+                // Players change keys every few frames
+                if ((generator.next() % 16) == 0) {
+                    keys[player] = static_cast<emu::keyboard::Type>(
+                        1U << (generator.next() % emu::keyboard::kNumKeys));
+                }
+
+                const auto kRollbacks = session.stats().rollbacks;
+                const auto kStart = std::chrono::steady_clock::now();
+                if (session.frame() < options.frames) {
+                    session.advance(keys[player]);
+                } else {
+                    session.synchronize();
+                }
+                if (session.stats().rollbacks != kRollbacks) {
+                    const std::chrono::duration<double, std::micro> kElapsed =
+                        std::chrono::steady_clock::now() - kStart;
+                    rollback_time += kElapsed;
+                    worst_rollback = std::max(worst_rollback, kElapsed);
+                }
+
+                emu::netplay::Packet packet{};
+                const auto kSize = session.write(packet);
+                links[player].emplace_back(packet.begin(),
+                                           packet.begin() + kSize);
+                if (links[player].size() > options.latency) {
+                    sessions[1 - player].read(links[player].front());
+                    links[player].pop_front();
+                }
+            }
+        }
+
+        std::uint64_t rollbacks = 0;
+        for (std::size_t player = 0; player < 2; player++) {
+            auto& session = sessions[player];
+            session.synchronize();
+            const auto& kStats = session.stats();
+            rollbacks += kStats.rollbacks;
+            std::cout << std::format(
+                "Player {}: {} frames, {} confirmed, {} rollbacks, {} "
+                "resimulated frames, {} stalls\n",
+                player + 1, session.frame(), session.confirmed(),
+                kStats.rollbacks, kStats.resimulated_frames, kStats.stalls);
+        }
+        std::cout << std::format(
+            "Rollback mean {:.1f} us, max {:.1f} us\n",
+            rollbacks == 0 ? 0.0
+                           : rollback_time.count() /
+                                 static_cast<double>(rollbacks),
+            worst_rollback.count());
+
+        const auto& kFirst = sessions[0].state();
+        const auto& kSecond = sessions[1].state();
+        if (sessions[0].frame() != sessions[1].frame() ||
+            kFirst.V != kSecond.V || kFirst.memory != kSecond.memory ||
+            kFirst.display.rows != kSecond.display.rows) {
+            std::cerr << "Desync: the sessions ended in different states\n";
+            return 1;
+        }
+        std::cout << "In sync\n";
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
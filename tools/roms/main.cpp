@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "chip_8/parse.hpp"
+#include "chip_8/random.hpp"
+#include "chip_8/rom.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-roms <index> [options]\n"
+    "  --scan DIR                  index new and modified .ch8 files under "
+    "DIR\n"
+    "  --set ROM                   change the profile of ROM, indexing it if "
+    "needed\n"
+    "  --random xorshift|vip       Cxkk generator of the --set ROM\n"
+    "  --speed N                   instructions per second of the --set ROM\n"
+    "  --list                      print the indexed ROMs\n"
+    "The index is created if it does not exist.\n";
+
+struct Options {
+    std::vector<std::string> scan;
+    std::string set;
+    std::string random;
+    std::uint32_t speed{};
+    bool list{};
+};
+
+bool parseOption(const std::string_view option,
+                 const std::string_view value,
+                 Options& options) {
+    if (option == "--scan") {
+        options.scan.emplace_back(value);
+        return true;
+    }
+    if (option == "--set") {
+        options.set = value;
+        return true;
+    }
+    if (option == "--random") {
+        options.random = value;
+        return value == "xorshift" || value == "vip";
+    }
+    if (option == "--speed") {
+        const auto kSpeed = emu::parse::number<std::uint32_t>(value);
+        options.speed = kSpeed.value_or(0);
+        return options.speed > 0;
+    }
+    return false;
+}
+
+void list(const emu::rom::Index& index) {
+    std::vector<const emu::rom::Entry*> sorted;
+    for (const auto& [hash, entry] : index.entries()) {
+        sorted.push_back(&entry);
+    }
+    std::ranges::sort(sorted, {}, &emu::rom::Entry::path);
+
+    for (const auto* entry : sorted) {
+        std::cout << std::format(
+            "{:016x} {:>5} bytes {:>4} blocks {:>8} {:>5}/s{} {}\n",
+            entry->hash, entry->size, entry->metadata.blocks,
+            entry->profile.random == emu::random::Mode::kCosmacVip
+                ? "vip"
+                : "xorshift",
+            entry->profile.speed, entry->metadata.dynamic ? " dynamic" : "",
+            entry->path);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    Options options;
+    for (int arg = 2; arg < argc; arg++) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const std::string_view kOption = argv[arg];
+        if (kOption == "--list") {
+            options.list = true;
+            continue;
+        }
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (arg + 1 >= argc || !parseOption(kOption, argv[arg + 1], options)) {
+            std::cerr << "Invalid option: " << kOption << '\n' << kUsage;
+            return 1;
+        }
+        arg += 1;
+    }
+    if (options.set.empty() &&
+        (!options.random.empty() || options.speed != 0)) {
+        std::cerr << "--random and --speed need --set\n" << kUsage;
+        return 1;
+    }
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const std::string kIndexPath = argv[1];
+
+    try {
+        emu::rom::Index index;
+        if (std::ifstream file(kIndexPath); file.is_open()) {
+            index = emu::rom::Index::load(file);
+        }
+
+        for (const auto& directory : options.scan) {
+            const auto kRead = index.scan(directory);
+            std::cout << std::format("{}: {} ROMs read, {} indexed\n",
+                                     directory, kRead, index.size());
+        }
+
+        if (!options.set.empty()) {
+            const auto kRom = emu::rom::read(options.set);
+            auto profile =
+                index
+                    .add(options.set, kRom,
+                         emu::rom::modifiedTime(options.set))
+                    .profile;
+            if (!options.random.empty()) {
+                profile.random = options.random == "vip"
+                                     ? emu::random::Mode::kCosmacVip
+                                     : emu::random::Mode::kXorshift;
+            }
+            if (options.speed != 0) {
+                profile.speed = options.speed;
+            }
+            index.setProfile(emu::rom::contentHash(kRom), profile);
+        }
+
+        if (options.list) {
+            list(index);
+        }
+
+        std::ofstream file(kIndexPath);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open " << kIndexPath << '\n';
+            return 1;
+        }
+        index.save(file);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
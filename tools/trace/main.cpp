@@ -0,0 +1,164 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "chip_8/opcode.hpp"
+#include "chip_8/parse.hpp"
+#include "chip_8/registers.hpp"
+#include "chip_8/trace.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage =
+    "Usage: chip-8-trace <trace> [options]\n"
+    "  --address LO[:HI]  only records fetched from [LO, HI] (hex)\n"
+    "  --opcode PATTERN   only records of an opcode, e.g. Dxyn\n"
+    "  --register N       only records that changed VN (hex)\n"
+    "  --from N           skip records before sequence N\n"
+    "  --limit N          stop after N matching records\n";
+
+struct Filter {
+    std::uint16_t address_low{0x000};
+    std::uint16_t address_high{0xFFF};
+    std::optional<emu::opcode::Id> opcode;
+    std::optional<std::size_t> changed_register;
+    std::uint64_t from{};
+    std::uint64_t limit{UINT64_MAX};
+
+    [[nodiscard]] bool matches(const emu::trace::Record& record) const {
+        if (record.sequence < from || record.address < address_low ||
+            record.address > address_high) {
+            return false;
+        }
+        if (opcode && emu::opcode::identify(record.bytecode) != *opcode) {
+            return false;
+        }
+        if (changed_register &&
+            (record.changed & (1U << *changed_register)) == 0) {
+            return false;
+        }
+        return true;
+    }
+};
+
+std::optional<emu::opcode::Id> parseOpcode(const std::string_view text) {
+    for (std::size_t idx = 0; idx < emu::opcode::kCount; idx++) {
+        const auto kId = static_cast<emu::opcode::Id>(idx);
+        if (emu::opcode::name(kId) == text) {
+            return kId;
+        }
+    }
+    return std::nullopt;
+}
+
+bool parseAddress(const std::string_view text, Filter& filter) {
+    const auto kSeparator = text.find(':');
+    const auto kLow =
+        emu::parse::number<std::uint16_t>(text.substr(0, kSeparator), 16);
+    const auto kHigh = kSeparator == std::string_view::npos
+                           ? kLow
+                           : emu::parse::number<std::uint16_t>(
+                                 text.substr(kSeparator + 1), 16);
+    if (!kLow || !kHigh) {
+        return false;
+    }
+    filter.address_low = *kLow;
+    filter.address_high = *kHigh;
+    return true;
+}
+
+bool parseOption(const std::string_view option,
+                 const std::string_view value,
+                 Filter& filter) {
+    if (option == "--address") {
+        return parseAddress(value, filter);
+    }
+    if (option == "--opcode") {
+        filter.opcode = parseOpcode(value);
+        return filter.opcode.has_value();
+    }
+    if (option == "--register") {
+        filter.changed_register = emu::parse::number<std::size_t>(value, 16);
+        return filter.changed_register.has_value() &&
+               *filter.changed_register < emu::registers::kNum;
+    }
+    if (option == "--from") {
+        const auto kFrom = emu::parse::number<std::uint64_t>(value, 10);
+        filter.from = kFrom.value_or(0);
+        return kFrom.has_value();
+    }
+    if (option == "--limit") {
+        const auto kLimit = emu::parse::number<std::uint64_t>(value, 10);
+        filter.limit = kLimit.value_or(0);
+        return kLimit.has_value();
+    }
+    return false;
+}
+
+std::string format(const emu::trace::Record& record) {
+    auto line = std::format(
+        "{:>10} {:03X}: {:04X} {:<4} I={:03X} DT={:02X} ST={:02X} SP={}",
+        record.sequence, record.address, record.bytecode,
+        emu::opcode::name(emu::opcode::identify(record.bytecode)),
+        record.index_register, record.delay_timer, record.sound_timer,
+        record.stack_depth);
+
+    for (std::size_t idx = 0; idx < emu::registers::kNum; idx++) {
+        if ((record.changed & (1U << idx)) != 0) {
+            line += std::format(" V{:X}={:02X}", idx, record.V[idx]);
+        }
+    }
+
+    return line;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc % 2 != 0) {
+        std::cerr << kUsage;
+        return 1;
+    }
+
+    Filter filter;
+    for (int arg = 2; arg + 1 < argc; arg += 2) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if (!parseOption(argv[arg], argv[arg + 1], filter)) {
+            // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            std::cerr << "Invalid option: " << argv[arg] << '\n' << kUsage;
+            return 1;
+        }
+    }
+
+    // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    std::ifstream file(argv[1], std::ifstream::binary);
+    if (!file.is_open()) {
+        // NOLINTNEXTLINE (cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        std::cerr << "Cannot open " << argv[1] << '\n';
+        return 1;
+    }
+
+    try {
+        emu::trace::Reader reader(file);
+        emu::trace::Record record{};
+        std::uint64_t printed = 0;
+
+        while (printed < filter.limit && reader.next(record)) {
+            if (filter.matches(record)) {
+                std::cout << format(record) << '\n';
+                printed += 1;
+            }
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}